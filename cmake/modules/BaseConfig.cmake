@@ -111,6 +111,17 @@ else()
     log_option_disabled("DEBUG LOG")
 endif(DEBUG_LOG)
 
+# === LOG ACTIVE LEVEL ===
+# cmake -DLOG_ACTIVE_LEVEL=info .. removes the trace and debug calls at compile time
+set(LOG_ACTIVE_LEVEL "trace" CACHE STRING "Lowest log level compiled in: trace, debug, info, warning, error or critical")
+set(LOG_LEVEL_NAMES trace debug info warning error critical)
+list(FIND LOG_LEVEL_NAMES "${LOG_ACTIVE_LEVEL}" LOG_ACTIVE_LEVEL_INDEX)
+if(LOG_ACTIVE_LEVEL_INDEX EQUAL -1)
+    message(FATAL_ERROR "Unknown LOG_ACTIVE_LEVEL: ${LOG_ACTIVE_LEVEL}")
+endif()
+add_definitions(-DLOG_ACTIVE_LEVEL=${LOG_ACTIVE_LEVEL_INDEX})
+log_info("Log active level: ${LOG_ACTIVE_LEVEL}")
+
 # *****************************************************************************
 # Compiler Options
 # *****************************************************************************
@@ -4,9 +4,10 @@ function clean.onSay(player, words, param)
 	-- create log
 	logCommand(player, words, param)
 
-	local itemCount = cleanMap()
-	if itemCount ~= 0 then
-		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Cleaned " .. itemCount .. " item" .. (itemCount > 1 and "s" or "") .. " from the map.")
+	-- Cleaned over the next dispatcher cycles, the world keeps running meanwhile
+	local tileCount = cleanMap(true)
+	if tileCount ~= 0 then
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Cleaning " .. tileCount .. " tile" .. (tileCount > 1 and "s" or "") .. ", the result will be logged.")
 	end
 	return true
 end
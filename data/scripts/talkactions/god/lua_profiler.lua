@@ -0,0 +1,38 @@
+local luaProfiler = TalkAction("/luaprofiler")
+
+function luaProfiler.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local split = param:split(",")
+	local action = split[1] and split[1]:trim() or ""
+	local value = split[2] and tonumber(split[2]:trim())
+
+	if action == "start" then
+		local interval = value or 1
+		if Game.startLuaProfiler(interval) then
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, string.format("Sampling Lua every %d ms.", interval))
+		else
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Sampling is not available, only script times are accounted.")
+		end
+	elseif action == "stop" then
+		Game.stopLuaProfiler()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Lua sampling stopped.")
+	elseif action == "reset" then
+		Game.resetLuaProfiler()
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Lua profiler reset.")
+	elseif action == "dump" then
+		local scripts = Game.dumpLuaProfiler(value or 10, "lua_profile.folded")
+		for _, script in ipairs(scripts) do
+			player:sendTextMessage(MESSAGE_ADMINISTRATOR, string.format("%s: %.2f ms in %d calls, %.2f ms max", script.name, script.totalMs, script.calls, script.maxMs))
+		end
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Full report logged, sampled stacks written to lua_profile.folded.")
+	else
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, "Usage: /luaprofiler start[, interval ms], stop, reset or dump[, count].")
+	end
+	return true
+end
+
+luaProfiler:separator(" ")
+luaProfiler:groupType("god")
+luaProfiler:register()
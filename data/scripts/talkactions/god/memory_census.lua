@@ -0,0 +1,19 @@
+local memoryCensus = TalkAction("/memorycensus")
+
+function memoryCensus.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local topCount = 20
+	if isNumber(param) then
+		topCount = tonumber(param)
+	end
+
+	local census = Game.runMemoryCensus(topCount, "memory_census.json")
+	player:sendTextMessage(MESSAGE_ADMINISTRATOR, string.format("Memory census: %d items (%d KiB) and %d tiles (%d KiB) counted in %d milliseconds. Full report written to memory_census.json.", census.items, census.itemBytes / 1024, census.tiles, census.tileBytes / 1024, census.duration))
+	return true
+end
+
+memoryCensus:separator(" ")
+memoryCensus:groupType("god")
+memoryCensus:register()
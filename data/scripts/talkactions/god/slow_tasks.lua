@@ -0,0 +1,22 @@
+local slowTasks = TalkAction("/slowtasks")
+
+function slowTasks.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	local minutes = 1
+	if isNumber(param) then
+		minutes = tonumber(param)
+	end
+
+	local tasks = Game.dumpSlowTasks(minutes)
+	for _, task in ipairs(tasks) do
+		player:sendTextMessage(MESSAGE_ADMINISTRATOR, string.format("%s: %.2f ms, waited %.2f ms", task.context, task.durationMs, task.waitMs))
+	end
+	player:sendTextMessage(MESSAGE_ADMINISTRATOR, string.format("Slowest dispatcher tasks of the last %d minute(s) logged.", minutes))
+	return true
+end
+
+slowTasks:separator(" ")
+slowTasks:groupType("god")
+slowTasks:register()
@@ -14,7 +14,7 @@
 #include "account/account_repository_db.hpp"
 #include "config/configmanager.hpp"
 #include "utils/definitions.hpp"
-#include "security/argon.hpp"
+#include "security/password_verifier.hpp"
 #include "utils/tools.hpp"
 #include "lib/logging/log_with_spd_log.hpp"
 
@@ -280,11 +280,7 @@ bool Account::authenticateSession() {
 }
 
 bool Account::authenticatePassword(const std::string &password) {
-	if (Argon2 {}.argon(password.c_str(), getPassword())) {
-		return true;
-	}
-
-	if (transformToSHA1(password) == getPassword()) {
+	if (g_passwordVerifier().verify(getID(), password, getPassword())) {
 		return true;
 	}
 
@@ -12,6 +12,7 @@
 #include "canary_server.hpp"
 
 #include "declarations.hpp"
+#include "creatures/monsters/monster_type_cache.hpp"
 #include "creatures/players/grouping/familiars.hpp"
 #include "creatures/players/storages/storages.hpp"
 #include "database/databasemanager.hpp"
@@ -19,10 +20,13 @@
 #include "game/zones/zone.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/events_scheduler.hpp"
+#include "game/scheduling/player_journal.hpp"
 #include "io/iomarket.hpp"
+#include "lib/thread/task_graph.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/modules/modules.hpp"
+#include "lua/scripts/lua_bytecode_cache.hpp"
 #include "lua/scripts/lua_environment.hpp"
 #include "lua/scripts/scripts.hpp"
 #include "server/network/protocol/protocollogin.hpp"
@@ -317,6 +321,14 @@ void CanaryServer::initializeDatabase() {
 
 	DatabaseManager::updateDatabase();
 
+	// Writes back the player changes a crash lost before they were saved
+	if (g_configManager().getBoolean(PLAYER_JOURNAL, __FUNCTION__)) {
+		const auto compactInterval = std::chrono::seconds(std::max(1, g_configManager().getNumber(PLAYER_JOURNAL_COMPACT_INTERVAL, __FUNCTION__)));
+		if (!g_playerJournal().start(g_configManager().getString(PLAYER_JOURNAL_FILE, __FUNCTION__), compactInterval)) {
+			throw FailedToInitializeCanary("Failed to replay the player journal!");
+		}
+	}
+
 	if (g_configManager().getBoolean(OPTIMIZE_DATABASE, __FUNCTION__)
 		&& !DatabaseManager::optimizeTables()) {
 		logger.debug("No tables were optimized");
@@ -342,18 +354,28 @@ void CanaryServer::loadModules() {
 	}
 
 	auto coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
-	// Load appearances.dat first
-	modulesLoadHelper((g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE), "appearances.dat");
-
-	// Load XML folder dependencies (order matters)
-	modulesLoadHelper(g_vocations().loadFromXml(), "XML/vocations.xml");
-	modulesLoadHelper(g_eventsScheduler().loadScheduleEventFromXml(), "XML/events.xml");
-	modulesLoadHelper(Outfits::getInstance().loadFromXml(), "XML/outfits.xml");
-	modulesLoadHelper(Familiars::getInstance().loadFromXml(), "XML/familiars.xml");
-	modulesLoadHelper(g_imbuements().loadFromXml(), "XML/imbuements.xml");
-	modulesLoadHelper(g_storages().loadFromXML(), "XML/storages.xml");
-
-	modulesLoadHelper(Item::items.loadFromXml(), "items.xml");
+	// Independent data files are parsed in parallel, each one starts once its dependencies are loaded
+	TaskGraph dataFiles(inject<ThreadPool>());
+	dataFiles.add("appearances.dat", {}, [&coreFolder] { return g_game().loadAppearanceProtobuf(coreFolder + "/items/appearances.dat") == ERROR_NONE; });
+	dataFiles.add("XML/vocations.xml", {}, [] { return g_vocations().loadFromXml(); });
+	// Loads the scheduler scripts into the Lua state
+	dataFiles.add("XML/events.xml", { "XML/vocations.xml" }, [] { return g_eventsScheduler().loadScheduleEventFromXml(); }, true);
+	// Checks the looktypes registered by appearances.dat
+	dataFiles.add("XML/outfits.xml", { "appearances.dat" }, [] { return Outfits::getInstance().loadFromXml(); });
+	dataFiles.add("XML/familiars.xml", {}, [] { return Familiars::getInstance().loadFromXml(); });
+	dataFiles.add("XML/imbuements.xml", {}, [] { return g_imbuements().loadFromXml(); });
+	dataFiles.add("XML/storages.xml", {}, [] { return g_storages().loadFromXML(); });
+	// Completes the item types created by appearances.dat
+	dataFiles.add("items.xml", { "appearances.dat" }, [] { return Item::items.loadFromXml(); });
+
+	Benchmark bm_dataFiles;
+	const auto failedDataFile = dataFiles.run();
+	for (const auto &[name, duration] : dataFiles.getTimings()) {
+		logger.info("Loaded {} in {} milliseconds", name, duration);
+		g_metrics().setGauge("startup_stage_duration_ms", static_cast<int64_t>(duration), { { "stage", name } });
+	}
+	logger.info("Loaded data files in {} milliseconds", bm_dataFiles.duration());
+	modulesLoadHelper(failedDataFile.empty(), failedDataFile);
 
 	const auto datapackFolder = g_configManager().getString(DATA_DIRECTORY, __FUNCTION__);
 	logger.debug("Loading core scripts on folder: {}/", coreFolder);
@@ -370,8 +392,9 @@ void CanaryServer::loadModules() {
 	// Load scripts
 	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/scripts", false, false), datapackFolder + "/scripts");
 	// Load monsters
-	modulesLoadHelper(g_scripts().loadScripts(datapackFolder + "/monster", false, false), datapackFolder + "/monster");
+	modulesLoadHelper(g_monsterTypeCache().loadMonsters(datapackFolder + "/monster", false), datapackFolder + "/monster");
 	modulesLoadHelper((g_npcs().load(false, true)), "npc");
+	g_luaBytecodeCache().logReport("startup");
 
 	g_game().loadBoostedCreature();
 	g_ioBosstiary().loadBoostedBoss();
@@ -388,7 +411,9 @@ void CanaryServer::modulesLoadHelper(bool loaded, std::string moduleName) {
 
 void CanaryServer::shutdown() {
 	g_dispatcher().shutdown();
+	g_playerJournal().shutdown();
 	g_metrics().shutdown();
 	inject<ThreadPool>().shutdown();
+	logger.shutdown();
 	std::exit(0);
 }
@@ -61,6 +61,7 @@ enum ConfigKey_t : uint16_t {
 	DISCORD_SEND_FOOTER,
 	DISCORD_WEBHOOK_DELAY_MS,
 	DISCORD_WEBHOOK_URL,
+	DISPATCHER_JOB_BUDGET,
 	EMOTE_SPELLS,
 	ENABLE_PLAYER_PUT_ITEM_IN_AMMO_SLOT,
 	ENABLE_SUPPORT_OUTFIT,
@@ -120,6 +121,8 @@ enum ConfigKey_t : uint16_t {
 	HOUSE_PURSHASED_SHOW_PRICE,
 	HOUSE_RENT_PERIOD,
 	HOUSE_RENT_RATE,
+	INBOUND_PACKET_QUEUE_SIZE,
+	INBOUND_PACKET_SHAPING,
 	INVENTORY_GLOW,
 	IP,
 	KICK_AFTER_MINUTES,
@@ -133,6 +136,8 @@ enum ConfigKey_t : uint16_t {
 	LOYALTY_POINTS_PER_CREATION_DAY,
 	LOYALTY_POINTS_PER_PREMIUM_DAY_PURCHASED,
 	LOYALTY_POINTS_PER_PREMIUM_DAY_SPENT,
+	LUA_BYTECODE_CACHE,
+	LUA_BYTECODE_CACHE_DIRECTORY,
 	M_CONST,
 	MAINTAIN_MODE_MESSAGE,
 	MAP_AUTHOR,
@@ -165,8 +170,13 @@ enum ConfigKey_t : uint16_t {
 	MOMENTUM_CHANCE_FORMULA_A,
 	MOMENTUM_CHANCE_FORMULA_B,
 	MOMENTUM_CHANCE_FORMULA_C,
+	MONSTER_TYPE_CACHE,
+	MONSTER_TYPE_CACHE_FILE,
+	MONSTER_TYPE_CACHE_VERIFY,
 	MONTH_KILLS_TO_RED,
 	MULTIPLIER_ATTACKONFIST,
+	MYSQL_ASYNC_BATCH_SIZE,
+	MYSQL_ASYNC_CONNECTION,
 	MYSQL_DB,
 	MYSQL_HOST,
 	MYSQL_PASS,
@@ -189,6 +199,14 @@ enum ConfigKey_t : uint16_t {
 	PARTY_LIST_MAX_DISTANCE,
 	PARTY_SHARE_LOOT_BOOSTS_DIMINISHING_FACTOR,
 	PARTY_SHARE_LOOT_BOOSTS,
+	PASSWORD_VERIFY_CACHE_TIME,
+	PASSWORD_VERIFY_QUEUE_SIZE,
+	PASSWORD_VERIFY_THREADS,
+	PLAYER_JOURNAL_COMPACT_INTERVAL,
+	PLAYER_JOURNAL_FILE,
+	PLAYER_JOURNAL,
+	PLAYER_SAVE_BUDGET,
+	PLAYER_SAVE_INTERVAL,
 	PREMIUM_DEPOT_LIMIT,
 	PREY_BONUS_REROLL_PRICE,
 	PREY_BONUS_TIME,
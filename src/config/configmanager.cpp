@@ -46,8 +46,10 @@ bool ConfigManager::load() {
 	if (!loaded) {
 		loadBoolConfig(L, BIND_ONLY_GLOBAL_ADDRESS, "bindOnlyGlobalAddress", false);
 		loadBoolConfig(L, DISABLE_LEGACY_RAIDS, "disableLegacyRaids", false);
+		loadBoolConfig(L, MYSQL_ASYNC_CONNECTION, "mysqlAsyncConnection", true);
 		loadBoolConfig(L, OLD_PROTOCOL, "allowOldProtocol", true);
 		loadBoolConfig(L, OPTIMIZE_DATABASE, "startupDatabaseOptimization", true);
+		loadBoolConfig(L, PLAYER_JOURNAL, "playerJournal", false);
 		loadBoolConfig(L, RANDOM_MONSTER_SPAWN, "randomMonsterSpawn", false);
 		loadBoolConfig(L, RESET_SESSIONS_ON_STARTUP, "resetSessionsOnStartup", false);
 		loadBoolConfig(L, TOGGLE_MAINTAIN_MODE, "toggleMaintainMode", false);
@@ -62,6 +64,9 @@ bool ConfigManager::load() {
 		loadIntConfig(L, LOGIN_PORT, "loginProtocolPort", 7171);
 		loadIntConfig(L, MARKET_OFFER_DURATION, "marketOfferDuration", 30 * 24 * 60 * 60);
 		loadIntConfig(L, MARKET_REFRESH_PRICES, "marketRefreshPricesInterval", 30);
+		loadIntConfig(L, MYSQL_ASYNC_BATCH_SIZE, "mysqlAsyncBatchSize", 32);
+		loadIntConfig(L, PASSWORD_VERIFY_THREADS, "passwordVerifyThreads", 2);
+		loadIntConfig(L, PLAYER_JOURNAL_COMPACT_INTERVAL, "playerJournalCompactInterval", 60);
 		loadIntConfig(L, PREMIUM_DEPOT_LIMIT, "premiumDepotLimit", 8000);
 		loadIntConfig(L, SQL_PORT, "mysqlPort", 3306);
 		loadIntConfig(L, STASH_ITEMS, "stashItemCount", 5000);
@@ -81,6 +86,7 @@ bool ConfigManager::load() {
 		loadStringConfig(L, MYSQL_PASS, "mysqlPass", "");
 		loadStringConfig(L, MYSQL_SOCK, "mysqlSock", "");
 		loadStringConfig(L, MYSQL_USER, "mysqlUser", "root");
+		loadStringConfig(L, PLAYER_JOURNAL_FILE, "playerJournalFile", "player_journal.bin");
 	}
 
 	loadBoolConfig(L, AIMBOT_HOTKEY_ENABLED, "hotkeyAimbotEnabled", true);
@@ -107,11 +113,15 @@ bool ConfigManager::load() {
 	loadBoolConfig(L, GLOBAL_SERVER_SAVE_SHUTDOWN, "globalServerSaveShutdown", true);
 	loadBoolConfig(L, HOUSE_OWNED_BY_ACCOUNT, "houseOwnedByAccount", false);
 	loadBoolConfig(L, HOUSE_PURSHASED_SHOW_PRICE, "housePurchasedShowPrice", false);
+	loadBoolConfig(L, INBOUND_PACKET_SHAPING, "inboundPacketShaping", true);
 	loadBoolConfig(L, INVENTORY_GLOW, "inventoryGlowOnFiveBless", false);
 	loadBoolConfig(L, LOYALTY_ENABLED, "loyaltyEnabled", true);
+	loadBoolConfig(L, LUA_BYTECODE_CACHE, "luaBytecodeCache", false);
 	loadBoolConfig(L, MARKET_PREMIUM, "premiumToCreateMarketOffer", true);
 	loadBoolConfig(L, METRICS_ENABLE_OSTREAM, "metricsEnableOstream", false);
 	loadBoolConfig(L, METRICS_ENABLE_PROMETHEUS, "metricsEnablePrometheus", false);
+	loadBoolConfig(L, MONSTER_TYPE_CACHE, "monsterTypeCache", false);
+	loadBoolConfig(L, MONSTER_TYPE_CACHE_VERIFY, "monsterTypeCacheVerify", false);
 	loadBoolConfig(L, ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS, "onlyInvitedCanMoveHouseItems", true);
 	loadBoolConfig(L, ONLY_PREMIUM_ACCOUNT, "onlyPremiumAccount", false);
 	loadBoolConfig(L, PARTY_AUTO_SHARE_EXPERIENCE, "partyAutoShareExperience", true);
@@ -231,6 +241,7 @@ bool ConfigManager::load() {
 	loadIntConfig(L, DEFAULT_DESPAWNRANGE, "deSpawnRange", 2);
 	loadIntConfig(L, DEPOTCHEST, "depotChest", 4);
 	loadIntConfig(L, DISCORD_WEBHOOK_DELAY_MS, "discordWebhookDelayMs", Webhook::DEFAULT_DELAY_MS);
+	loadIntConfig(L, DISPATCHER_JOB_BUDGET, "dispatcherJobBudget", 10);
 	loadIntConfig(L, EX_ACTIONS_DELAY_INTERVAL, "timeBetweenExActions", 1000);
 	loadIntConfig(L, EXP_FROM_PLAYERS_LEVEL_RANGE, "expFromPlayersLevelRange", 75);
 	loadIntConfig(L, FAMILIAR_TIME, "familiarTime", 30);
@@ -268,6 +279,7 @@ bool ConfigManager::load() {
 	loadIntConfig(L, HOUSE_BUY_LEVEL, "houseBuyLevel", 0);
 	loadIntConfig(L, HOUSE_LOSE_AFTER_INACTIVITY, "houseLoseAfterInactivity", 0);
 	loadIntConfig(L, HOUSE_PRICE_PER_SQM, "housePriceEachSQM", 1000);
+	loadIntConfig(L, INBOUND_PACKET_QUEUE_SIZE, "inboundPacketQueueSize", 32);
 	loadIntConfig(L, KICK_AFTER_MINUTES, "kickIdlePlayerAfterMinutes", 15);
 	loadIntConfig(L, LOOTPOUCH_MAXLIMIT, "lootPouchMaxLimit", 2000);
 	loadIntConfig(L, LOW_LEVEL_BONUS_EXP, "lowLevelBonusExp", 50);
@@ -295,6 +307,10 @@ bool ConfigManager::load() {
 	loadIntConfig(L, ORANGE_SKULL_DURATION, "orangeSkullDuration", 7);
 	loadIntConfig(L, PARALLELISM, "parallelism", 2);
 	loadIntConfig(L, PARTY_LIST_MAX_DISTANCE, "partyListMaxDistance", 0);
+	loadIntConfig(L, PASSWORD_VERIFY_CACHE_TIME, "passwordVerifyCacheTime", 60);
+	loadIntConfig(L, PASSWORD_VERIFY_QUEUE_SIZE, "passwordVerifyQueueSize", 64);
+	loadIntConfig(L, PLAYER_SAVE_BUDGET, "playerSaveBudget", 20);
+	loadIntConfig(L, PLAYER_SAVE_INTERVAL, "playerSaveInterval", 0);
 	loadIntConfig(L, PREY_BONUS_REROLL_PRICE, "preyBonusRerollPrice", 1);
 	loadIntConfig(L, PREY_BONUS_TIME, "preyBonusTime", 7200);
 	loadIntConfig(L, PREY_FREE_REROLL_TIME, "preyFreeRerollTime", 72000);
@@ -359,8 +375,10 @@ bool ConfigManager::load() {
 	loadStringConfig(L, FORGE_FIENDISH_INTERVAL_TYPE, "forgeFiendishIntervalType", "hour");
 	loadStringConfig(L, GLOBAL_SERVER_SAVE_TIME, "globalServerSaveTime", "06:00");
 	loadStringConfig(L, LOCATION, "location", "");
+	loadStringConfig(L, LUA_BYTECODE_CACHE_DIRECTORY, "luaBytecodeCacheDirectory", "cache/lua");
 	loadStringConfig(L, M_CONST, "memoryConst", "1<<16");
 	loadStringConfig(L, METRICS_PROMETHEUS_ADDRESS, "metricsPrometheusAddress", "localhost:9464");
+	loadStringConfig(L, MONSTER_TYPE_CACHE_FILE, "monsterTypeCacheFile", "cache/monster_types.bin");
 	loadStringConfig(L, OWNER_EMAIL, "ownerEmail", "");
 	loadStringConfig(L, OWNER_NAME, "ownerName", "");
 	loadStringConfig(L, SAVE_INTERVAL_TYPE, "saveIntervalType", "");
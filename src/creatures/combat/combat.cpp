@@ -22,6 +22,50 @@
 #include "map/spectators.hpp"
 #include "lib/metrics/metrics.hpp"
 
+namespace {
+	struct CombatTargets {
+		std::vector<std::shared_ptr<Tile>> tiles;
+		// Index in tiles of the tile each target stands on
+		std::vector<std::pair<size_t, std::shared_ptr<Creature>>> targets;
+	};
+
+	/**
+	 * Scratch buffers reused by every area combat, so casting a wave does not allocate.
+	 * Combats can nest (e.g. a death event casting a spell), so each depth gets its own buffer.
+	 */
+	class CombatTargetsBuffer {
+	public:
+		CombatTargetsBuffer() {
+			if (depth == pool.size()) {
+				pool.emplace_back(std::make_unique<CombatTargets>());
+			}
+			buffer = pool[depth++].get();
+		}
+
+		~CombatTargetsBuffer() {
+			buffer->tiles.clear();
+			buffer->targets.clear();
+			--depth;
+		}
+
+		CombatTargetsBuffer(const CombatTargetsBuffer &) = delete;
+		CombatTargetsBuffer &operator=(const CombatTargetsBuffer &) = delete;
+
+		CombatTargets* operator->() const {
+			return buffer;
+		}
+
+	private:
+		static thread_local std::vector<std::unique_ptr<CombatTargets>> pool;
+		static thread_local size_t depth;
+
+		CombatTargets* buffer;
+	};
+
+	thread_local std::vector<std::unique_ptr<CombatTargets>> CombatTargetsBuffer::pool;
+	thread_local size_t CombatTargetsBuffer::depth = 0;
+}
+
 int32_t Combat::getLevelFormula(std::shared_ptr<Player> player, const std::shared_ptr<Spell> wheelSpell, const CombatDamage &damage) const {
 	if (!player) {
 		return 0;
@@ -106,7 +150,7 @@ CombatDamage Combat::getCombatDamage(std::shared_ptr<Creature> creature, std::sh
 	return damage;
 }
 
-void Combat::getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::forward_list<std::shared_ptr<Tile>> &list) {
+void Combat::getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::vector<std::shared_ptr<Tile>> &list) {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
 		return;
 	}
@@ -114,7 +158,7 @@ void Combat::getCombatArea(const Position &centerPos, const Position &targetPos,
 	if (area) {
 		area->getList(centerPos, targetPos, list);
 	} else {
-		list.push_front(g_game().map.getOrCreateTile(targetPos));
+		list.emplace_back(g_game().map.getOrCreateTile(targetPos));
 	}
 }
 
@@ -277,6 +321,10 @@ ReturnValue Combat::canDoCombat(std::shared_ptr<Creature> caster, std::shared_pt
 	return g_events().eventCreatureOnAreaCombat(caster, tile, aggressive);
 }
 
+bool Combat::isValidAreaTarget(const std::shared_ptr<Creature> &target, const std::shared_ptr<Tile> &tile) {
+	return !target->isRemoved() && target->getHealth() > 0 && target->getTile() == tile && target->getPosition() == tile->getPosition();
+}
+
 bool Combat::isInPvpZone(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target) {
 	return attacker->getZoneType() == ZONE_PVP && target->getZoneType() == ZONE_PVP;
 }
@@ -1110,7 +1158,11 @@ bool Combat::doCombat(std::shared_ptr<Creature> caster, const Position &position
 }
 
 void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, CombatFunction func, CombatDamage* data) {
-	std::forward_list<std::shared_ptr<Tile>> tileList;
+	metrics::method_latency measure(__METHOD_NAME__);
+
+	CombatTargetsBuffer buffer;
+	auto &tileList = buffer->tiles;
+	auto &targets = buffer->targets;
 
 	if (caster) {
 		getCombatArea(caster->getPosition(), pos, area, tileList);
@@ -1121,8 +1173,10 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 	uint32_t maxX = 0;
 	uint32_t maxY = 0;
 
-	// calculate the max viewable range
-	for (const std::shared_ptr<Tile> &tile : tileList) {
+	// Single pass: calculate the max viewable range, keep the tiles that allow combat and collect their targets
+	size_t eligibleTiles = 0;
+	for (size_t index = 0; index < tileList.size(); ++index) {
+		const auto &tile = tileList[index];
 		const Position &tilePos = tile->getPosition();
 
 		uint32_t diff = Position::getDistanceX(tilePos, pos);
@@ -1134,17 +1188,12 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 		if (diff > maxY) {
 			maxY = diff;
 		}
-	}
 
-	const int32_t rangeX = maxX + MAP_MAX_VIEW_PORT_X;
-	const int32_t rangeY = maxY + MAP_MAX_VIEW_PORT_Y;
-
-	int affected = 0;
-	for (const std::shared_ptr<Tile> &tile : tileList) {
 		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
 			continue;
 		}
 
+		const size_t tileIndex = eligibleTiles++;
 		if (CreatureVector* creatures = tile->getCreatures()) {
 			const std::shared_ptr<Creature> topCreature = tile->getTopCreature();
 			for (auto &creature : *creatures) {
@@ -1159,11 +1208,23 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 				}
 
 				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
-					affected++;
+					targets.emplace_back(tileIndex, creature);
+					if (params.targetCasterOrTopMost) {
+						break;
+					}
 				}
 			}
 		}
+
+		if (tileIndex != index) {
+			tileList[tileIndex] = std::move(tileList[index]);
+		}
 	}
+	tileList.resize(eligibleTiles);
+
+	const int32_t rangeX = maxX + MAP_MAX_VIEW_PORT_X;
+	const int32_t rangeY = maxY + MAP_MAX_VIEW_PORT_Y;
+	const auto affected = static_cast<int>(targets.size());
 
 	CombatDamage tmpDamage;
 	if (data) {
@@ -1195,41 +1256,25 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 	uint8_t beamAffectedCurrent = 0;
 
 	tmpDamage.affected = affected;
-	for (const std::shared_ptr<Tile> &tile : tileList) {
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
-			continue;
-		}
-
-		if (CreatureVector* creatures = tile->getCreatures()) {
-			const std::shared_ptr<Creature> topCreature = tile->getTopCreature();
-			for (auto &creature : *creatures) {
-				if (params.targetCasterOrTopMost) {
-					if (caster && caster->getTile() == tile) {
-						if (creature != caster) {
-							continue;
-						}
-					} else if (creature != topCreature) {
-						continue;
-					}
-				}
-
-				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
-					// Wheel of destiny update beam mastery damage
-					if (casterPlayer) {
-						casterPlayer->wheel()->updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
-					}
-					func(caster, creature, params, &tmpDamage);
-					if (params.targetCallback) {
-						params.targetCallback->onTargetCombat(caster, creature);
-					}
+	auto target = targets.begin();
+	for (size_t tileIndex = 0; tileIndex < tileList.size(); ++tileIndex) {
+		for (; target != targets.end() && target->first == tileIndex; ++target) {
+			const auto &creature = target->second;
+			// The hits on the previous targets may have killed, removed or moved it (e.g. through death events)
+			if (!isValidAreaTarget(creature, tileList[tileIndex])) {
+				continue;
+			}
 
-					if (params.targetCasterOrTopMost) {
-						break;
-					}
-				}
+			// Wheel of destiny update beam mastery damage
+			if (casterPlayer) {
+				casterPlayer->wheel()->updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
+			}
+			func(caster, creature, params, &tmpDamage);
+			if (params.targetCallback) {
+				params.targetCallback->onTargetCombat(caster, creature);
 			}
 		}
-		combatTileEffects(spectators.data(), caster, tile, params);
+		combatTileEffects(spectators.data(), caster, tileList[tileIndex], params);
 	}
 
 	// Wheel of destiny update beam mastery damage
@@ -1806,39 +1851,36 @@ bool ChainPickerCallback::onChainCombat(std::shared_ptr<Creature> creature, std:
 //**********************************************************//
 
 void AreaCombat::clear() {
-	std::ranges::fill(areas, nullptr);
+	for (auto &areaOffsets : offsets) {
+		areaOffsets.clear();
+	}
 }
 
-AreaCombat::AreaCombat(const AreaCombat &rhs) {
-	hasExtArea = rhs.hasExtArea;
-	for (uint_fast8_t i = 0; i <= Direction::DIRECTION_LAST; ++i) {
-		if (const auto &area = rhs.areas[i]) {
-			areas[i] = area->clone();
+void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const {
+	const auto &areaOffsets = offsets[getAreaDirection(centerPos, targetPos)];
+	list.reserve(list.size() + areaOffsets.size());
+	for (const auto &offset : areaOffsets) {
+		const Position tmpPos(static_cast<uint16_t>(targetPos.x + offset.x), static_cast<uint16_t>(targetPos.y + offset.y), targetPos.z);
+		if (g_game().isSightClear(targetPos, tmpPos, true)) {
+			list.emplace_back(g_game().map.getOrCreateTile(tmpPos));
 		}
 	}
 }
 
-void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::forward_list<std::shared_ptr<Tile>> &list) const {
-	const std::unique_ptr<MatrixArea> &area = getArea(centerPos, targetPos);
-	if (!area) {
-		return;
-	}
-
+void AreaCombat::compileArea(Direction dir, const std::unique_ptr<MatrixArea> &area) {
 	uint32_t centerY, centerX;
 	area->getCenter(centerY, centerX);
 
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
-	uint32_t cols = area->getCols();
+	auto &areaOffsets = offsets[dir];
+	areaOffsets.clear();
 	for (uint32_t y = 0, rows = area->getRows(); y < rows; ++y) {
-		for (uint32_t x = 0; x < cols; ++x) {
-			if (area->getValue(y, x) != 0 && g_game().isSightClear(targetPos, tmpPos, true)) {
-				list.push_front(g_game().map.getOrCreateTile(tmpPos));
+		for (uint32_t x = 0, cols = area->getCols(); x < cols; ++x) {
+			if (area->getValue(y, x)) {
+				areaOffsets.push_back({ static_cast<int32_t>(x) - static_cast<int32_t>(centerX), static_cast<int32_t>(y) - static_cast<int32_t>(centerY) });
 			}
-			tmpPos.x++;
 		}
-		tmpPos.x -= cols;
-		tmpPos.y++;
 	}
+	areaOffsets.shrink_to_fit();
 }
 
 void AreaCombat::copyArea(const std::unique_ptr<MatrixArea> &input, const std::unique_ptr<MatrixArea> &output, MatrixOperation_t op) const {
@@ -1968,10 +2010,10 @@ void AreaCombat::setupArea(const std::list<uint32_t> &list, uint32_t rows) {
 	auto westArea = std::make_unique<MatrixArea>(maxOutput, maxOutput);
 	copyArea(northArea, westArea, MATRIXOPERATION_ROTATE270);
 
-	areas[DIRECTION_NORTH] = std::move(northArea);
-	areas[DIRECTION_SOUTH] = std::move(southArea);
-	areas[DIRECTION_EAST] = std::move(eastArea);
-	areas[DIRECTION_WEST] = std::move(westArea);
+	compileArea(DIRECTION_NORTH, northArea);
+	compileArea(DIRECTION_SOUTH, southArea);
+	compileArea(DIRECTION_EAST, eastArea);
+	compileArea(DIRECTION_WEST, westArea);
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread) {
@@ -2066,10 +2108,10 @@ void AreaCombat::setupExtArea(const std::list<uint32_t> &list, uint32_t rows) {
 	auto seArea = std::make_unique<MatrixArea>(maxOutput, maxOutput);
 	copyArea(swArea, seArea, MATRIXOPERATION_MIRROR);
 
-	areas[DIRECTION_NORTHWEST] = std::move(nwArea);
-	areas[DIRECTION_SOUTHWEST] = std::move(swArea);
-	areas[DIRECTION_NORTHEAST] = std::move(neArea);
-	areas[DIRECTION_SOUTHEAST] = std::move(seArea);
+	compileArea(DIRECTION_NORTHWEST, nwArea);
+	compileArea(DIRECTION_SOUTHWEST, swArea);
+	compileArea(DIRECTION_NORTHEAST, neArea);
+	compileArea(DIRECTION_SOUTHEAST, seArea);
 }
 
 //**********************************************************//
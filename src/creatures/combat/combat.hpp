@@ -208,17 +208,14 @@ private:
 
 class AreaCombat {
 public:
-	AreaCombat() = default;
-
-	AreaCombat(const AreaCombat &rhs);
-	~AreaCombat() {
-		clear();
-	}
+	struct Offset {
+		int32_t x = 0;
+		int32_t y = 0;
+	};
 
-	// non-assignable
-	AreaCombat &operator=(const AreaCombat &) = delete;
+	AreaCombat() = default;
 
-	void getList(const Position &centerPos, const Position &targetPos, std::forward_list<std::shared_ptr<Tile>> &list) const;
+	void getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const;
 
 	void setupArea(const std::list<uint32_t> &list, uint32_t rows);
 	void setupArea(int32_t length, int32_t spread);
@@ -230,11 +227,20 @@ public:
 		return std::make_unique<AreaCombat>(*this);
 	}
 
+	/**
+	 * Tile offsets from the target position covered by the area facing the given direction,
+	 * in row-major order of the area matrix.
+	 */
+	const std::vector<Offset> &getOffsets(Direction dir) const {
+		return offsets[dir];
+	}
+
 private:
 	std::unique_ptr<MatrixArea> createArea(const std::list<uint32_t> &list, uint32_t rows);
 	void copyArea(const std::unique_ptr<MatrixArea> &input, const std::unique_ptr<MatrixArea> &output, MatrixOperation_t op) const;
+	void compileArea(Direction dir, const std::unique_ptr<MatrixArea> &area);
 
-	const std::unique_ptr<MatrixArea> &getArea(const Position &centerPos, const Position &targetPos) const {
+	Direction getAreaDirection(const Position &centerPos, const Position &targetPos) const {
 		int32_t dx = Position::getOffsetX(targetPos, centerPos);
 		int32_t dy = Position::getOffsetY(targetPos, centerPos);
 
@@ -261,10 +267,11 @@ private:
 			}
 		}
 
-		return areas[dir];
+		return dir;
 	}
 
-	std::array<std::unique_ptr<MatrixArea>, Direction::DIRECTION_LAST + 1> areas {};
+	// The matrices are only needed to build the rotations, lookups use the flat offsets
+	std::array<std::vector<Offset>, Direction::DIRECTION_LAST + 1> offsets {};
 	bool hasExtArea = false;
 };
 
@@ -290,7 +297,7 @@ public:
 	static void doCombatDispel(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params);
 	static void doCombatDispel(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params);
 
-	static void getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::forward_list<std::shared_ptr<Tile>> &list);
+	static void getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::vector<std::shared_ptr<Tile>> &list);
 
 	static bool isInPvpZone(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target);
 	static bool isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Player> target);
@@ -300,6 +307,8 @@ public:
 	static ReturnValue canTargetCreature(std::shared_ptr<Player> attacker, std::shared_ptr<Creature> target);
 	static ReturnValue canDoCombat(std::shared_ptr<Creature> caster, std::shared_ptr<Tile> tile, bool aggressive);
 	static ReturnValue canDoCombat(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target, bool aggressive);
+	// Whether an area combat target is still alive and on the tile it was collected from
+	static bool isValidAreaTarget(const std::shared_ptr<Creature> &target, const std::shared_ptr<Tile> &tile);
 	static void postCombatEffects(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const CombatParams &params);
 
 	static void addDistanceEffect(std::shared_ptr<Creature> caster, const Position &fromPos, const Position &toPos, uint16_t effect);
@@ -0,0 +1,931 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "creatures/monsters/monster_type_cache.hpp"
+
+#include "config/configmanager.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "game/game.hpp"
+#include "io/io_bosstiary.hpp"
+#include "lib/di/container.hpp"
+#include "lua/scripts/scripts.hpp"
+
+namespace {
+	constexpr std::array<char, 4> CACHE_MAGIC = { 'C', 'M', 'T', 'C' };
+	// Bump whenever a serialized field is added, removed or reordered
+	constexpr uint32_t CACHE_FORMAT = 1;
+
+	struct CacheHeader {
+		std::array<char, 4> magic = CACHE_MAGIC;
+		uint32_t format = CACHE_FORMAT;
+		uint64_t manifestHash = 0;
+	};
+
+	// FNV-1a, stable across runs and builds unlike std::hash
+	void hashBytes(uint64_t &hash, std::string_view data) {
+		for (const char c : data) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001B3ULL;
+		}
+	}
+
+	/**
+	 * The archives below are driven by the same field() functions, so the binary layout,
+	 * the reader and the field names used by the verifier cannot drift apart.
+	 */
+	class BinaryWriter {
+	public:
+		static constexpr bool reading = false;
+		static constexpr bool describing = false;
+
+		void enter(std::string_view) { }
+		void enter(size_t) { }
+		void leave() { }
+
+		template <typename T>
+		void value(std::string_view, T &value) {
+			if constexpr (std::is_same_v<T, std::string>) {
+				const auto length = static_cast<uint32_t>(value.size());
+				buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+				buffer.append(value);
+			} else {
+				static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+				buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+			}
+		}
+
+		std::string buffer;
+	};
+
+	class BinaryReader {
+	public:
+		static constexpr bool reading = true;
+		static constexpr bool describing = false;
+
+		explicit BinaryReader(std::string_view data) :
+			data(data) { }
+
+		void enter(std::string_view) { }
+		void enter(size_t) { }
+		void leave() { }
+
+		template <typename T>
+		void value(std::string_view, T &value) {
+			if constexpr (std::is_same_v<T, std::string>) {
+				uint32_t length = 0;
+				if (read(&length, sizeof(length)) && length <= data.size() - position) {
+					value.assign(data.substr(position, length));
+					position += length;
+				} else {
+					failed = true;
+				}
+			} else {
+				static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+				read(&value, sizeof(T));
+			}
+		}
+
+		// Every element takes at least one byte, a larger count can only come from a corrupted file
+		uint32_t checkCount(uint32_t count) {
+			if (failed || count > data.size() - position) {
+				failed = true;
+				return 0;
+			}
+			return count;
+		}
+
+		bool finished() const {
+			return !failed && position == data.size();
+		}
+
+		bool hasFailed() const {
+			return failed;
+		}
+
+	private:
+		bool read(void* destination, size_t size) {
+			if (failed || size > data.size() - position) {
+				failed = true;
+				return false;
+			}
+			memcpy(destination, data.data() + position, size);
+			position += size;
+			return true;
+		}
+
+		std::string_view data;
+		size_t position = 0;
+		bool failed = false;
+	};
+
+	// Flattens a monster type into "path = value" pairs, e.g. "info.lootItems[2].chance"
+	class FieldDumper {
+	public:
+		static constexpr bool reading = false;
+		static constexpr bool describing = true;
+
+		void enter(std::string_view name) {
+			path.emplace_back(name);
+		}
+		void enter(size_t index) {
+			path.emplace_back(fmt::format("[{}]", index));
+		}
+		void leave() {
+			path.pop_back();
+		}
+
+		template <typename T>
+		void value(std::string_view name, T &value) {
+			if constexpr (std::is_same_v<T, std::string>) {
+				fields.emplace_back(key(name), fmt::format("\"{}\"", value));
+			} else if constexpr (std::is_enum_v<T>) {
+				fields.emplace_back(key(name), fmt::format("{}", static_cast<std::underlying_type_t<T>>(value)));
+			} else {
+				fields.emplace_back(key(name), fmt::format("{}", value));
+			}
+		}
+
+		std::vector<std::pair<std::string, std::string>> fields;
+
+	private:
+		std::string key(std::string_view name) const {
+			std::string result;
+			for (const auto &segment : path) {
+				if (segment.empty()) {
+					continue;
+				}
+				if (!result.empty() && segment.front() != '[') {
+					result.push_back('.');
+				}
+				result.append(segment);
+			}
+			if (!name.empty()) {
+				if (!result.empty()) {
+					result.push_back('.');
+				}
+				result.append(name);
+			}
+			return result;
+		}
+
+		std::vector<std::string> path;
+	};
+
+	template <typename Archive, typename T>
+	void field(Archive &ar, std::string_view name, T &value) {
+		ar.value(name, value);
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, Outfit_t &outfit) {
+		ar.enter(name);
+		ar.value("lookType", outfit.lookType);
+		ar.value("lookTypeEx", outfit.lookTypeEx);
+		ar.value("lookMount", outfit.lookMount);
+		ar.value("lookHead", outfit.lookHead);
+		ar.value("lookBody", outfit.lookBody);
+		ar.value("lookLegs", outfit.lookLegs);
+		ar.value("lookFeet", outfit.lookFeet);
+		ar.value("lookAddons", outfit.lookAddons);
+		ar.value("lookMountHead", outfit.lookMountHead);
+		ar.value("lookMountBody", outfit.lookMountBody);
+		ar.value("lookMountLegs", outfit.lookMountLegs);
+		ar.value("lookMountFeet", outfit.lookMountFeet);
+		ar.value("lookFamiliarsType", outfit.lookFamiliarsType);
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, LightInfo &light) {
+		ar.enter(name);
+		ar.value("level", light.level);
+		ar.value("color", light.color);
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, RespawnType &respawnType) {
+		ar.enter(name);
+		ar.value("period", respawnType.period);
+		ar.value("underground", respawnType.underground);
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, voiceBlock_t &voice) {
+		ar.enter(name);
+		ar.value("text", voice.text);
+		ar.value("yellText", voice.yellText);
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, summonBlock_t &summon) {
+		ar.enter(name);
+		ar.value("name", summon.name);
+		ar.value("chance", summon.chance);
+		ar.value("speed", summon.speed);
+		ar.value("count", summon.count);
+		ar.value("force", summon.force);
+		ar.leave();
+	}
+
+	template <typename Archive, size_t N>
+	void field(Archive &ar, std::string_view name, std::bitset<N> &bits) {
+		static_assert(N <= 64);
+		uint64_t value = bits.to_ullong();
+		ar.value(name, value);
+		if constexpr (Archive::reading) {
+			bits = std::bitset<N>(value);
+		}
+	}
+
+	template <typename Archive, typename T>
+	void field(Archive &ar, std::string_view name, std::vector<T> &values) {
+		ar.enter(name);
+		auto count = static_cast<uint32_t>(values.size());
+		ar.value("size", count);
+		if constexpr (Archive::reading) {
+			values.clear();
+			values.resize(ar.checkCount(count));
+		}
+		for (size_t index = 0; index < values.size(); ++index) {
+			ar.enter(index);
+			field(ar, "", values[index]);
+			ar.leave();
+		}
+		ar.leave();
+	}
+
+	template <typename Archive, typename K, typename V>
+	void field(Archive &ar, std::string_view name, std::map<K, V> &values) {
+		ar.enter(name);
+		auto count = static_cast<uint32_t>(values.size());
+		ar.value("size", count);
+		if constexpr (Archive::reading) {
+			values.clear();
+			count = ar.checkCount(count);
+			for (uint32_t index = 0; index < count; ++index) {
+				K key {};
+				V value {};
+				ar.value("key", key);
+				ar.value("value", value);
+				values[key] = value;
+			}
+		} else {
+			size_t index = 0;
+			for (auto &[key, value] : values) {
+				auto keyCopy = key;
+				ar.enter(index++);
+				ar.value("key", keyCopy);
+				ar.value("value", value);
+				ar.leave();
+			}
+		}
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, std::set<std::string> &values) {
+		ar.enter(name);
+		auto count = static_cast<uint32_t>(values.size());
+		ar.value("size", count);
+		if constexpr (Archive::reading) {
+			values.clear();
+			count = ar.checkCount(count);
+			for (uint32_t index = 0; index < count; ++index) {
+				std::string value;
+				ar.value("value", value);
+				values.insert(std::move(value));
+			}
+		} else {
+			size_t index = 0;
+			for (const auto &value : values) {
+				auto valueCopy = value;
+				ar.enter(index++);
+				ar.value("value", valueCopy);
+				ar.leave();
+			}
+		}
+		ar.leave();
+	}
+
+	template <typename Archive, typename T>
+	void field(Archive &ar, std::string_view name, stdext::vector_set<T> &values) {
+		ar.enter(name);
+		auto count = static_cast<uint32_t>(values.size());
+		ar.value("size", count);
+		if constexpr (Archive::reading) {
+			values.clear();
+			count = ar.checkCount(count);
+			for (uint32_t index = 0; index < count; ++index) {
+				T value {};
+				ar.value("value", value);
+				values.insert(value);
+			}
+		} else {
+			size_t index = 0;
+			for (auto &value : values) {
+				ar.enter(index++);
+				ar.value("value", value);
+				ar.leave();
+			}
+		}
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, LootBlock &loot) {
+		ar.enter(name);
+		ar.value("id", loot.id);
+		ar.value("countmax", loot.countmax);
+		ar.value("countmin", loot.countmin);
+		ar.value("chance", loot.chance);
+		ar.value("subType", loot.subType);
+		ar.value("actionId", loot.actionId);
+		ar.value("text", loot.text);
+		ar.value("name", loot.name);
+		ar.value("article", loot.article);
+		ar.value("attack", loot.attack);
+		ar.value("defense", loot.defense);
+		ar.value("extraDefense", loot.extraDefense);
+		ar.value("armor", loot.armor);
+		ar.value("shootRange", loot.shootRange);
+		ar.value("hitChance", loot.hitChance);
+		ar.value("unique", loot.unique);
+		field(ar, "childLoot", loot.childLoot);
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, MonsterSpell &spell) {
+		ar.enter(name);
+		ar.value("name", spell.name);
+		ar.value("scriptName", spell.scriptName);
+		ar.value("chance", spell.chance);
+		ar.value("range", spell.range);
+		ar.value("interval", spell.interval);
+		ar.value("minCombatValue", spell.minCombatValue);
+		ar.value("maxCombatValue", spell.maxCombatValue);
+		ar.value("attack", spell.attack);
+		ar.value("skill", spell.skill);
+		ar.value("length", spell.length);
+		ar.value("spread", spell.spread);
+		ar.value("radius", spell.radius);
+		ar.value("conditionMinDamage", spell.conditionMinDamage);
+		ar.value("conditionMaxDamage", spell.conditionMaxDamage);
+		ar.value("conditionStartDamage", spell.conditionStartDamage);
+		ar.value("tickInterval", spell.tickInterval);
+		ar.value("speedChange", spell.speedChange);
+		ar.value("duration", spell.duration);
+		ar.value("isScripted", spell.isScripted);
+		ar.value("needTarget", spell.needTarget);
+		ar.value("needDirection", spell.needDirection);
+		ar.value("combatSpell", spell.combatSpell);
+		ar.value("isMelee", spell.isMelee);
+		field(ar, "outfit", spell.outfit);
+		ar.value("outfitMonster", spell.outfitMonster);
+		ar.value("outfitItem", spell.outfitItem);
+		ar.value("shoot", spell.shoot);
+		ar.value("effect", spell.effect);
+		ar.value("conditionType", spell.conditionType);
+		ar.value("combatType", spell.combatType);
+		ar.value("soundImpactEffect", spell.soundImpactEffect);
+		ar.value("soundCastEffect", spell.soundCastEffect);
+		ar.leave();
+	}
+
+	// Only the descriptor is stored, the combat is built again by Monsters::deserializeSpell
+	template <typename Archive>
+	void field(Archive &ar, std::string_view name, spellBlock_t &spellBlock) {
+		ar.enter(name);
+		if constexpr (Archive::reading) {
+			spellBlock.source = std::make_shared<MonsterSpell>();
+		}
+		field(ar, "source", *spellBlock.source);
+		if constexpr (Archive::describing) {
+			bool hasSpell = spellBlock.spell != nullptr;
+			ar.value("hasSpell", hasSpell);
+			ar.value("chance", spellBlock.chance);
+			ar.value("speed", spellBlock.speed);
+			ar.value("range", spellBlock.range);
+			ar.value("minCombatValue", spellBlock.minCombatValue);
+			ar.value("maxCombatValue", spellBlock.maxCombatValue);
+			ar.value("combatSpell", spellBlock.combatSpell);
+			ar.value("isMelee", spellBlock.isMelee);
+		}
+		ar.leave();
+	}
+
+	template <typename Archive>
+	void serialize(Archive &ar, MonsterType &monsterType) {
+		field(ar, "name", monsterType.name);
+		field(ar, "typeName", monsterType.typeName);
+		field(ar, "nameDescription", monsterType.nameDescription);
+		field(ar, "variantName", monsterType.variantName);
+
+		auto &info = monsterType.info;
+		ar.enter("info");
+		field(ar, "elementMap", info.elementMap);
+		field(ar, "reflectMap", info.reflectMap);
+		field(ar, "healingMap", info.healingMap);
+		field(ar, "voiceVector", info.voiceVector);
+		field(ar, "lootItems", info.lootItems);
+		field(ar, "scripts", info.scripts);
+		field(ar, "attackSpells", info.attackSpells);
+		field(ar, "defenseSpells", info.defenseSpells);
+		field(ar, "summons", info.summons);
+		field(ar, "skull", info.skull);
+		field(ar, "outfit", info.outfit);
+		field(ar, "race", info.race);
+		field(ar, "respawnType", info.respawnType);
+		field(ar, "light", info.light);
+		field(ar, "lookcorpse", info.lookcorpse);
+		field(ar, "baseSpeed", info.baseSpeed);
+		field(ar, "experience", info.experience);
+		field(ar, "manaCost", info.manaCost);
+		field(ar, "yellChance", info.yellChance);
+		field(ar, "yellSpeedTicks", info.yellSpeedTicks);
+		field(ar, "staticAttackChance", info.staticAttackChance);
+		field(ar, "maxSummons", info.maxSummons);
+		field(ar, "changeTargetSpeed", info.changeTargetSpeed);
+		field(ar, "conditionImmunities", info.m_conditionImmunities);
+		field(ar, "damageImmunities", info.m_damageImmunities);
+		field(ar, "bestiaryOccurrence", info.bestiaryOccurrence);
+		field(ar, "bestiaryStars", info.bestiaryStars);
+		field(ar, "bestiaryToUnlock", info.bestiaryToUnlock);
+		field(ar, "bestiaryFirstUnlock", info.bestiaryFirstUnlock);
+		field(ar, "bestiarySecondUnlock", info.bestiarySecondUnlock);
+		field(ar, "bestiaryCharmsPoints", info.bestiaryCharmsPoints);
+		field(ar, "raceid", info.raceid);
+		field(ar, "bestiaryLocations", info.bestiaryLocations);
+		field(ar, "bestiaryClass", info.bestiaryClass);
+		field(ar, "bestiaryRace", info.bestiaryRace);
+		field(ar, "bosstiaryRace", info.bosstiaryRace);
+		field(ar, "bosstiaryClass", info.bosstiaryClass);
+		field(ar, "mitigation", info.mitigation);
+		field(ar, "soundChance", info.soundChance);
+		field(ar, "soundSpeedTicks", info.soundSpeedTicks);
+		field(ar, "soundVector", info.soundVector);
+		field(ar, "deathSound", info.deathSound);
+		field(ar, "targetDistance", info.targetDistance);
+		field(ar, "runAwayHealth", info.runAwayHealth);
+		field(ar, "health", info.health);
+		field(ar, "healthMax", info.healthMax);
+		field(ar, "changeTargetChance", info.changeTargetChance);
+		field(ar, "defense", info.defense);
+		field(ar, "armor", info.armor);
+		field(ar, "critChance", info.critChance);
+		field(ar, "strategiesTargetNearest", info.strategiesTargetNearest);
+		field(ar, "strategiesTargetHealth", info.strategiesTargetHealth);
+		field(ar, "strategiesTargetDamage", info.strategiesTargetDamage);
+		field(ar, "strategiesTargetRandom", info.strategiesTargetRandom);
+		field(ar, "targetPreferPlayer", info.targetPreferPlayer);
+		field(ar, "targetPreferMaster", info.targetPreferMaster);
+		field(ar, "faction", info.faction);
+		field(ar, "enemyFactions", info.enemyFactions);
+		field(ar, "canPushItems", info.canPushItems);
+		field(ar, "canPushCreatures", info.canPushCreatures);
+		field(ar, "pushable", info.pushable);
+		field(ar, "isSummonable", info.isSummonable);
+		field(ar, "isIllusionable", info.isIllusionable);
+		field(ar, "isConvinceable", info.isConvinceable);
+		field(ar, "isAttackable", info.isAttackable);
+		field(ar, "isHostile", info.isHostile);
+		field(ar, "hiddenHealth", info.hiddenHealth);
+		field(ar, "isBlockable", info.isBlockable);
+		field(ar, "isFamiliar", info.isFamiliar);
+		field(ar, "isRewardBoss", info.isRewardBoss);
+		field(ar, "canWalkOnEnergy", info.canWalkOnEnergy);
+		field(ar, "canWalkOnFire", info.canWalkOnFire);
+		field(ar, "canWalkOnPoison", info.canWalkOnPoison);
+		field(ar, "isForgeCreature", info.isForgeCreature);
+		ar.leave();
+	}
+
+	// Lua callbacks live in the Lua state, so monster types using them are always evaluated
+	bool isCacheable(const MonsterType &monsterType) {
+		const auto &info = monsterType.info;
+		if (info.scriptInterface || info.eventType != MONSTERS_EVENT_NONE) {
+			return false;
+		}
+		if (info.thinkEvent != -1 || info.creatureAppearEvent != -1 || info.creatureDisappearEvent != -1 || info.creatureMoveEvent != -1 || info.creatureSayEvent != -1) {
+			return false;
+		}
+
+		const auto hasSource = [](const spellBlock_t &spellBlock) {
+			return spellBlock.source != nullptr;
+		};
+		return std::ranges::all_of(info.attackSpells, hasSource) && std::ranges::all_of(info.defenseSpells, hasSource);
+	}
+
+	bool readFile(const std::filesystem::path &path, std::string &content) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			return false;
+		}
+
+		content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return !file.bad();
+	}
+}
+
+MonsterTypeCache &MonsterTypeCache::getInstance() {
+	return inject<MonsterTypeCache>();
+}
+
+std::string MonsterTypeCache::encodeType(MonsterType &monsterType) {
+	BinaryWriter writer;
+	serialize(writer, monsterType);
+	return std::move(writer.buffer);
+}
+
+bool MonsterTypeCache::decodeType(std::string_view data, MonsterType &monsterType) {
+	BinaryReader reader(data);
+	serialize(reader, monsterType);
+	return reader.finished();
+}
+
+std::string MonsterTypeCache::encodeFiles(const CachedFiles &files) {
+	BinaryWriter writer;
+	auto fileCount = static_cast<uint32_t>(files.size());
+	writer.value("files", fileCount);
+	for (const auto &[path, cachedTypes] : files) {
+		auto pathCopy = path;
+		auto typeCount = static_cast<uint32_t>(cachedTypes.size());
+		writer.value("path", pathCopy);
+		writer.value("types", typeCount);
+		for (auto cachedType : cachedTypes) {
+			field(writer, "names", cachedType.names);
+			writer.value("bestiary", cachedType.bestiary);
+			writer.value("bosstiary", cachedType.bosstiary);
+			writer.value("data", cachedType.data);
+		}
+	}
+	return std::move(writer.buffer);
+}
+
+bool MonsterTypeCache::decodeFiles(std::string_view data, CachedFiles &files) {
+	BinaryReader reader(data);
+	uint32_t fileCount = 0;
+	reader.value("files", fileCount);
+	fileCount = reader.checkCount(fileCount);
+	for (uint32_t fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+		std::string path;
+		uint32_t typeCount = 0;
+		reader.value("path", path);
+		reader.value("types", typeCount);
+
+		auto &cachedTypes = files[path];
+		cachedTypes.resize(reader.checkCount(typeCount));
+		for (auto &cachedType : cachedTypes) {
+			field(reader, "names", cachedType.names);
+			reader.value("bestiary", cachedType.bestiary);
+			reader.value("bosstiary", cachedType.bosstiary);
+			reader.value("data", cachedType.data);
+		}
+	}
+
+	if (!reader.finished()) {
+		files.clear();
+		return false;
+	}
+	return true;
+}
+
+bool MonsterTypeCache::loadMonsters(const std::string &folder, bool reload) {
+	if (!g_configManager().getBoolean(MONSTER_TYPE_CACHE, __FUNCTION__)) {
+		return g_scripts().loadScripts(folder, false, reload);
+	}
+
+	const auto dir = std::filesystem::current_path() / folder;
+	if (!std::filesystem::exists(dir) || !std::filesystem::is_directory(dir)) {
+		g_logger().error("Can not load folder {}", folder);
+		return false;
+	}
+
+	Benchmark bm_monsters;
+	const uint64_t manifestHash = getManifestHash(dir);
+	CachedFiles cached;
+	const bool cacheHit = readCache(manifestHash, cached);
+	const bool verifying = cacheHit && g_configManager().getBoolean(MONSTER_TYPE_CACHE_VERIFY, __FUNCTION__);
+	const bool consoleLogs = g_configManager().getBoolean(SCRIPTS_CONSOLE_LOGS, __FUNCTION__);
+
+	std::unordered_set<const MonsterType*> knownTypes;
+	for (const auto &[_, monsterType] : g_monsters().monsters) {
+		knownTypes.insert(monsterType.get());
+	}
+
+	CachedFiles fresh;
+	uint32_t rebuiltTypes = 0;
+	uint32_t evaluatedFiles = 0;
+	for (const auto &path : listFiles(dir)) {
+		const auto relativePath = path.lexically_relative(dir).generic_string();
+		if (cacheHit && !verifying) {
+			if (const auto it = cached.find(relativePath); it != cached.end()) {
+				std::vector<std::shared_ptr<MonsterType>> monsterTypes;
+				for (const auto &cachedType : it->second) {
+					if (auto monsterType = rebuild(cachedType)) {
+						monsterTypes.push_back(std::move(monsterType));
+					}
+				}
+
+				// A type that cannot be rebuilt falls back to evaluating the whole file
+				if (monsterTypes.size() == it->second.size()) {
+					for (size_t index = 0; index < monsterTypes.size(); ++index) {
+						if (registerType(monsterTypes[index], it->second[index])) {
+							knownTypes.insert(monsterTypes[index].get());
+							++rebuiltTypes;
+						}
+					}
+					if (consoleLogs) {
+						g_logger().info("[script cached]: {}", path.filename().string());
+					}
+					continue;
+				}
+			}
+		}
+
+		evaluateFile(path, relativePath, reload, knownTypes, fresh);
+		++evaluatedFiles;
+	}
+
+	if (verifying) {
+		verify(cached, fresh);
+	}
+	if (!cacheHit || verifying) {
+		writeCache(manifestHash, fresh);
+	}
+
+	g_logger().info("Loaded {} monster types from cache and evaluated {} monster files in {} milliseconds", rebuiltTypes, evaluatedFiles, bm_monsters.duration());
+	return true;
+}
+
+// Same files and order as Scripts::loadScripts(folder, false, ...)
+std::vector<std::filesystem::path> MonsterTypeCache::listFiles(const std::filesystem::path &folder) const {
+	std::vector<std::filesystem::path> files;
+	for (const auto &entry : std::filesystem::recursive_directory_iterator(folder)) {
+		const auto &path = entry.path();
+		if (!entry.is_regular_file() || path.extension() != ".lua") {
+			continue;
+		}
+
+		const auto file = path.filename().string();
+		const auto fileFolder = path.parent_path().filename().string();
+		if (file.front() == '#' || fileFolder == "lib" || fileFolder == "events") {
+			continue;
+		}
+		files.push_back(path);
+	}
+	return files;
+}
+
+uint64_t MonsterTypeCache::getManifestHash(const std::filesystem::path &folder) const {
+	// Everything a monster file can read while it is evaluated: itself, the Lua libs, the items and the config
+	const auto &coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
+	const std::vector<std::filesystem::path> sources = {
+		folder,
+		folder.parent_path() / "lib",
+		std::filesystem::current_path() / coreFolder / "libs",
+		std::filesystem::current_path() / coreFolder / "scripts" / "lib",
+		std::filesystem::current_path() / coreFolder / "items" / "items.xml",
+		std::filesystem::current_path() / coreFolder / "core.lua",
+		std::filesystem::current_path() / g_configManager().getConfigFileLua(),
+	};
+
+	std::vector<std::string> entries;
+	const auto addFile = [&entries](const std::filesystem::path &path) {
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(path, ec);
+		const auto lastWriteTime = ec ? std::filesystem::file_time_type {} : std::filesystem::last_write_time(path, ec);
+		if (!ec) {
+			entries.emplace_back(fmt::format("{}|{}|{}", path.generic_string(), size, lastWriteTime.time_since_epoch().count()));
+		}
+	};
+
+	for (const auto &source : sources) {
+		std::error_code ec;
+		if (std::filesystem::is_directory(source, ec)) {
+			for (const auto &entry : std::filesystem::recursive_directory_iterator(source, ec)) {
+				if (entry.is_regular_file()) {
+					addFile(entry.path());
+				}
+			}
+		} else if (std::filesystem::is_regular_file(source, ec)) {
+			addFile(source);
+		}
+	}
+
+	// Directory iteration order is not specified
+	std::ranges::sort(entries);
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (const auto &entry : entries) {
+		hashBytes(hash, entry);
+		hashBytes(hash, "\n");
+	}
+	return hash;
+}
+
+bool MonsterTypeCache::readCache(uint64_t manifestHash, CachedFiles &files) const {
+	std::string content;
+	const auto &cacheFile = g_configManager().getString(MONSTER_TYPE_CACHE_FILE, __FUNCTION__);
+	if (!readFile(cacheFile, content) || content.size() < sizeof(CacheHeader)) {
+		return false;
+	}
+
+	CacheHeader header;
+	memcpy(&header, content.data(), sizeof(CacheHeader));
+	if (header.magic != CACHE_MAGIC || header.format != CACHE_FORMAT) {
+		return false;
+	}
+	if (header.manifestHash != manifestHash) {
+		g_logger().info("Monster files changed since the monster type cache was written, evaluating all of them");
+		return false;
+	}
+
+	if (!decodeFiles(std::string_view(content).substr(sizeof(CacheHeader)), files)) {
+		g_logger().warn("[MonsterTypeCache] Ignoring corrupted cache file {}", cacheFile);
+		return false;
+	}
+	return true;
+}
+
+void MonsterTypeCache::writeCache(uint64_t manifestHash, const CachedFiles &files) const {
+	const auto data = encodeFiles(files);
+
+	const std::filesystem::path cachePath = g_configManager().getString(MONSTER_TYPE_CACHE_FILE, __FUNCTION__);
+	std::error_code ec;
+	if (cachePath.has_parent_path()) {
+		std::filesystem::create_directories(cachePath.parent_path(), ec);
+	}
+
+	// Written aside and renamed, so a crash never leaves a truncated cache file behind
+	auto tempPath = cachePath;
+	tempPath += ".tmp";
+	{
+		std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+		if (!cacheFile.is_open()) {
+			g_logger().warn("[MonsterTypeCache] Cannot write cache file {}", cachePath.string());
+			return;
+		}
+
+		CacheHeader header;
+		header.manifestHash = manifestHash;
+		cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+		cacheFile.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+	std::filesystem::rename(tempPath, cachePath, ec);
+}
+
+bool MonsterTypeCache::evaluateFile(const std::filesystem::path &path, const std::string &relativePath, bool reload, std::unordered_set<const MonsterType*> &knownTypes, CachedFiles &files) const {
+	auto &scriptInterface = g_scripts().getScriptInterface();
+	if (scriptInterface.loadFile(path.string(), path.filename().string()) == -1) {
+		g_logger().error(path.string());
+		g_logger().error(scriptInterface.getLastLuaError());
+		return false;
+	}
+
+	if (g_configManager().getBoolean(SCRIPTS_CONSOLE_LOGS, __FUNCTION__)) {
+		g_logger().info("[script {}]: {}", reload ? "reloaded" : "loaded", path.filename().string());
+	}
+
+	// Monster types registered by this file, with every name they were registered with
+	std::vector<std::pair<std::shared_ptr<MonsterType>, std::vector<std::string>>> created;
+	for (const auto &[name, monsterType] : g_monsters().monsters) {
+		if (knownTypes.contains(monsterType.get())) {
+			continue;
+		}
+
+		auto it = std::ranges::find(created, monsterType, &decltype(created)::value_type::first);
+		if (it == created.end()) {
+			it = created.insert(created.end(), { monsterType, {} });
+		}
+		it->second.push_back(name);
+	}
+
+	bool cacheable = !created.empty();
+	for (const auto &[monsterType, _] : created) {
+		knownTypes.insert(monsterType.get());
+		cacheable = cacheable && isCacheable(*monsterType);
+	}
+	if (!cacheable) {
+		return true;
+	}
+
+	auto &cachedTypes = files[relativePath];
+	for (auto &[monsterType, names] : created) {
+		const auto raceId = monsterType->info.raceid;
+		const auto &bestiary = g_game().getBestiaryList();
+		const auto &bosstiary = g_ioBosstiary().getBosstiaryMap();
+		const auto bestiaryIt = bestiary.find(raceId);
+		const auto bosstiaryIt = bosstiary.find(raceId);
+
+		auto &cachedType = cachedTypes.emplace_back();
+		cachedType.names = std::move(names);
+		cachedType.bestiary = raceId != 0 && bestiaryIt != bestiary.end() && bestiaryIt->second == monsterType->name;
+		cachedType.bosstiary = raceId != 0 && bosstiaryIt != bosstiary.end() && bosstiaryIt->second == monsterType->name;
+		cachedType.data = encodeType(*monsterType);
+	}
+	return true;
+}
+
+std::shared_ptr<MonsterType> MonsterTypeCache::rebuild(const CachedType &cachedType) const {
+	auto monsterType = std::make_shared<MonsterType>();
+	if (!decodeType(cachedType.data, *monsterType)) {
+		g_logger().warn("[MonsterTypeCache] Cannot read cached monster type {}", cachedType.names.empty() ? "" : cachedType.names.front());
+		return nullptr;
+	}
+
+	// Same as monsterType:addAttack/addDefense, spells that cannot be built anymore are left out
+	for (auto* spells : { &monsterType->info.attackSpells, &monsterType->info.defenseSpells }) {
+		std::vector<spellBlock_t> built;
+		built.reserve(spells->size());
+		for (auto &spellBlock : *spells) {
+			if (g_monsters().deserializeSpell(spellBlock.source, spellBlock, monsterType->name)) {
+				built.push_back(std::move(spellBlock));
+			} else {
+				g_logger().warn("Monster: {}, cant load spell: {}", monsterType->name, spellBlock.source->name);
+			}
+		}
+		spells->swap(built);
+	}
+	return monsterType;
+}
+
+bool MonsterTypeCache::registerType(const std::shared_ptr<MonsterType> &monsterType, const CachedType &cachedType) const {
+	bool registered = false;
+	for (const auto &name : cachedType.names) {
+		if (g_monsters().tryAddMonsterType(name, monsterType)) {
+			registered = true;
+		} else {
+			g_logger().error("The monster with name {} already registered", name);
+		}
+	}
+
+	if (cachedType.bestiary) {
+		g_game().addBestiaryList(monsterType->info.raceid, monsterType->name);
+	}
+	if (cachedType.bosstiary) {
+		g_ioBosstiary().addBosstiaryMonster(monsterType->info.raceid, monsterType->name);
+	}
+	return registered;
+}
+
+void MonsterTypeCache::verify(const CachedFiles &cached, const CachedFiles &fresh) const {
+	uint32_t checkedTypes = 0;
+	uint32_t differentTypes = 0;
+	for (const auto &[path, cachedTypes] : cached) {
+		const auto freshIt = fresh.find(path);
+		if (freshIt == fresh.end() || freshIt->second.size() != cachedTypes.size()) {
+			g_logger().warn("[MonsterTypeCache] {} no longer creates the cached monster types", path);
+			++differentTypes;
+			continue;
+		}
+
+		for (const auto &cachedType : cachedTypes) {
+			++checkedTypes;
+			const auto &name = cachedType.names.front();
+			const auto freshType = g_monsters().getMonsterType(name, true);
+			const auto rebuiltType = rebuild(cachedType);
+			if (!freshType || !isCacheable(*freshType) || !rebuiltType) {
+				g_logger().warn("[MonsterTypeCache] Cannot compare monster type {} from {}", name, path);
+				++differentTypes;
+				continue;
+			}
+
+			FieldDumper freshFields;
+			FieldDumper cachedFields;
+			serialize(freshFields, *freshType);
+			serialize(cachedFields, *rebuiltType);
+
+			std::vector<std::string> differences;
+			const size_t fieldCount = std::max(freshFields.fields.size(), cachedFields.fields.size());
+			for (size_t index = 0; index < fieldCount; ++index) {
+				const auto *freshField = index < freshFields.fields.size() ? &freshFields.fields[index] : nullptr;
+				const auto *cachedField = index < cachedFields.fields.size() ? &cachedFields.fields[index] : nullptr;
+				if (freshField && cachedField && *freshField == *cachedField) {
+					continue;
+				}
+				differences.emplace_back(fmt::format("{} = {} (cached {} = {})", freshField ? freshField->first : "-", freshField ? freshField->second : "-", cachedField ? cachedField->first : "-", cachedField ? cachedField->second : "-"));
+			}
+
+			if (!differences.empty()) {
+				++differentTypes;
+				g_logger().warn("[MonsterTypeCache] Monster type {} differs from the cache in {} fields, first: {}", name, differences.size(), differences.front());
+				for (const auto &difference : differences) {
+					g_logger().debug("[MonsterTypeCache] {}: {}", name, difference);
+				}
+			}
+		}
+	}
+
+	g_logger().info("Verified {} cached monster types, {} differ from the monster files", checkedTypes, differentTypes);
+}
@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class MonsterType;
+
+/**
+ * Binary cache of the monster types built by the datapack monster scripts.
+ *
+ * After the monster folder is evaluated, every file that only created monster types
+ * (no Lua callbacks such as onThink) is stored with the fully built types: loot, spell
+ * descriptors, attack/defense, voices, flags, bestiary and bosstiary data. While the
+ * monster files, the Lua libs, the items and config.lua keep the same size and
+ * modification time, the next boot (or /reload) rebuilds those types from the cache and
+ * only evaluates the remaining files.
+ */
+class MonsterTypeCache {
+public:
+	MonsterTypeCache() = default;
+
+	// Singleton - ensures we don't accidentally copy it
+	MonsterTypeCache(const MonsterTypeCache &) = delete;
+	void operator=(const MonsterTypeCache &) = delete;
+
+	static MonsterTypeCache &getInstance();
+
+	/**
+	 * Loads the monster folder, same as Scripts::loadScripts(folder, false, reload) when
+	 * the cache is disabled. With monsterTypeCacheVerify every file is evaluated and the
+	 * cached types are compared field by field with the fresh ones.
+	 */
+	bool loadMonsters(const std::string &folder, bool reload);
+
+	struct CachedType {
+		std::vector<std::string> names;
+		bool bestiary = false;
+		bool bosstiary = false;
+		// encodeType of the monster type
+		std::string data;
+	};
+
+	// Monster types created by each file, by path relative to the monster folder
+	using CachedFiles = std::map<std::string, std::vector<CachedType>>;
+
+	// Every cached field of the monster type, spells as their descriptors only
+	static std::string encodeType(MonsterType &monsterType);
+	// The spell combats are left to Monsters::deserializeSpell, false when data is cut or corrupted
+	static bool decodeType(std::string_view data, MonsterType &monsterType);
+
+	// Cache file contents after the header
+	static std::string encodeFiles(const CachedFiles &files);
+	static bool decodeFiles(std::string_view data, CachedFiles &files);
+
+private:
+	std::vector<std::filesystem::path> listFiles(const std::filesystem::path &folder) const;
+	uint64_t getManifestHash(const std::filesystem::path &folder) const;
+
+	bool readCache(uint64_t manifestHash, CachedFiles &files) const;
+	void writeCache(uint64_t manifestHash, const CachedFiles &files) const;
+
+	bool evaluateFile(const std::filesystem::path &path, const std::string &relativePath, bool reload, std::unordered_set<const MonsterType*> &knownTypes, CachedFiles &files) const;
+	std::shared_ptr<MonsterType> rebuild(const CachedType &cachedType) const;
+	bool registerType(const std::shared_ptr<MonsterType> &monsterType, const CachedType &cachedType) const;
+	void verify(const CachedFiles &cached, const CachedFiles &fresh) const;
+};
+
+constexpr auto g_monsterTypeCache = MonsterTypeCache::getInstance;
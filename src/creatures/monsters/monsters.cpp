@@ -61,6 +61,7 @@ bool Monsters::deserializeSpell(const std::shared_ptr<MonsterSpell> spell, spell
 		return false;
 	}
 
+	sb.source = spell;
 	sb.speed = spell->interval;
 	sb.chance = std::min((int)spell->chance, 100);
 	sb.range = std::min((int)spell->range, MAP_MAX_VIEW_PORT_X * 2);
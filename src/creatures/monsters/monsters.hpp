@@ -25,6 +25,7 @@ public:
 };
 
 class BaseSpell;
+class MonsterSpell;
 struct spellBlock_t {
 	constexpr spellBlock_t() = default;
 	~spellBlock_t() = default;
@@ -38,7 +39,8 @@ struct spellBlock_t {
 		minCombatValue(other.minCombatValue),
 		maxCombatValue(other.maxCombatValue),
 		combatSpell(other.combatSpell),
-		isMelee(other.isMelee) {
+		isMelee(other.isMelee),
+		source(std::move(other.source)) {
 		other.spell = nullptr;
 	}
 
@@ -53,6 +55,9 @@ struct spellBlock_t {
 
 	SoundEffect_t soundImpactEffect = SoundEffect_t::SILENCE;
 	SoundEffect_t soundCastEffect = SoundEffect_t::SILENCE;
+
+	// Descriptor the block was built from, kept for the monster type cache
+	std::shared_ptr<MonsterSpell> source = nullptr;
 };
 
 class MonsterType {
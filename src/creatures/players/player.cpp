@@ -24,6 +24,7 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/task.hpp"
 #include "game/scheduling/save_manager.hpp"
+#include "game/scheduling/player_journal.hpp"
 #include "grouping/familiars.hpp"
 #include "lua/creature/creatureevent.hpp"
 #include "lua/creature/events.hpp"
@@ -95,8 +96,8 @@ bool Player::isPushable() {
 	return Creature::isPushable();
 }
 
-std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) {
-	return std::make_shared<Task>(std::move(f), std::move(context), delay);
+std::shared_ptr<Task> Player::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string_view context) {
+	return std::make_shared<Task>(std::move(f), context, delay);
 }
 
 uint32_t Player::playerFirstID = 0x10000000;
@@ -907,6 +908,8 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 				value >> 16,
 				value & 0xFF
 			);
+			// Kept as saved, genReservedStorageRange erases the rows of removed outfits
+			storage.load(key, value);
 			return;
 		} else if (IS_IN_KEYRANGE(key, MOUNTS_RANGE)) {
 			// do nothing
@@ -914,6 +917,7 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 			familiars.emplace_back(
 				value >> 16
 			);
+			storage.load(key, value);
 			return;
 		} else {
 			g_logger().warn("Unknown reserved key: {} for player: {}", key, getName());
@@ -921,49 +925,50 @@ void Player::addStorageValue(const uint32_t key, const int32_t value, const bool
 		}
 	}
 
-	if (value != -1) {
-		int32_t oldValue = getStorageValue(key);
-		storageMap[key] = value;
-
-		if (!isLogin) {
-			auto currentFrameTime = g_dispatcher().getDispatcherCycle();
-			g_events().eventOnStorageUpdate(static_self_cast<Player>(), key, value, oldValue, currentFrameTime);
-			g_callbacks().executeCallback(EventCallback_t::playerOnStorageUpdate, &EventCallback::playerOnStorageUpdate, getPlayer(), key, value, oldValue, currentFrameTime);
+	if (isLogin) {
+		if (value != -1) {
+			storage.load(key, value);
 		}
-	} else {
-		storageMap.erase(key);
+		return;
 	}
-}
 
-int32_t Player::getStorageValue(const uint32_t key) const {
-	int32_t value = -1;
-	auto it = storageMap.find(key);
-	if (it == storageMap.end()) {
-		return value;
+	if (value == -1) {
+		storage.erase(key);
+		return;
 	}
 
-	value = it->second;
-	return value;
-}
+	const int32_t oldValue = storage.set(key, value);
+	const bool hasEvent = g_events().hasStorageUpdateEvent();
+	const bool hasCallback = g_callbacks().hasCallback(EventCallback_t::playerOnStorageUpdate);
+	if (!hasEvent && !hasCallback) {
+		return;
+	}
 
-int32_t Player::getStorageValueByName(const std::string &storageName) const {
-	auto it = g_storages().getStorageMap().find(storageName);
-	if (it == g_storages().getStorageMap().end()) {
-		return -1;
+	auto currentFrameTime = g_dispatcher().getDispatcherCycle();
+	if (hasEvent) {
+		g_events().eventOnStorageUpdate(static_self_cast<Player>(), key, value, oldValue, currentFrameTime);
+	}
+	if (hasCallback) {
+		g_callbacks().executeCallback(EventCallback_t::playerOnStorageUpdate, &EventCallback::playerOnStorageUpdate, getPlayer(), key, value, oldValue, currentFrameTime);
 	}
-	uint32_t key = it->second;
+}
 
-	return getStorageValue(key);
+int32_t Player::getStorageValue(const uint32_t key) const {
+	return storage.get(key);
+}
+
+int32_t Player::getStorageValueByName(const std::string &storageName) const {
+	const auto key = g_storages().getStorageKey(storageName);
+	return key ? getStorageValue(*key) : -1;
 }
 
 void Player::addStorageValueByName(const std::string &storageName, const int32_t value, const bool isLogin /* = false*/) {
-	auto it = g_storages().getStorageMap().find(storageName);
-	if (it == g_storages().getStorageMap().end()) {
+	const auto key = g_storages().getStorageKey(storageName);
+	if (!key) {
 		g_logger().error("[{}] Storage name '{}' not found in storage map, register your storage in 'storages.xml' first for use", __func__, storageName);
 		return;
 	}
-	uint32_t key = it->second;
-	addStorageValue(key, value, isLogin);
+	addStorageValue(*key, value, isLogin);
 }
 
 bool Player::canSee(const Position &pos) {
@@ -2503,6 +2508,7 @@ void Player::addExperience(std::shared_ptr<Creature> target, uint64_t exp, bool
 		ss << "You advanced from Level " << prevLevel << " to Level " << level << '.';
 		sendTextMessage(MESSAGE_EVENT_ADVANCE, ss.str());
 	}
+	journalExperience(prevLevel != level);
 
 	if (nextLevelExp > currLevelExp) {
 		levelPercent = Player::getPercentLevel(experience - currLevelExp, nextLevelExp - currLevelExp);
@@ -2587,6 +2593,7 @@ void Player::removeExperience(uint64_t exp, bool sendText /* = false*/) {
 		ss << "You were downgraded from Level " << oldLevel << " to Level " << level << '.';
 		sendTextMessage(MESSAGE_EVENT_ADVANCE, ss.str());
 	}
+	journalExperience(oldLevel != level);
 
 	uint64_t nextLevelExp = Player::getExpForLevel(level + 1);
 	if (nextLevelExp > currLevelExp) {
@@ -2598,6 +2605,56 @@ void Player::removeExperience(uint64_t exp, bool sendText /* = false*/) {
 	sendExperienceTracker(0, -static_cast<int64_t>(exp));
 }
 
+void Player::journalExperience(bool levelChanged) const {
+	auto &journal = g_playerJournal();
+	if (!journal.isEnabled()) {
+		return;
+	}
+
+	journal.append(guid, PlayerJournalType::Experience, static_cast<int64_t>(experience));
+	if (levelChanged) {
+		journal.append(guid, PlayerJournalType::Level, level);
+		journal.append(guid, PlayerJournalType::HealthMax, healthMax);
+		journal.append(guid, PlayerJournalType::ManaMax, manaMax);
+		journal.append(guid, PlayerJournalType::Capacity, capacity);
+	}
+}
+
+Player::SaveMark Player::getSaveMark() const {
+	return { itemChanges.load(std::memory_order_relaxed), experience, bankBalance };
+}
+
+void Player::markSaved(const SaveMark &mark) {
+	savedItemChanges.store(mark.itemChanges, std::memory_order_relaxed);
+	savedExperience.store(mark.experience, std::memory_order_relaxed);
+	savedBankBalance.store(mark.bankBalance, std::memory_order_relaxed);
+}
+
+size_t Player::getUnsavedChanges() const {
+	size_t changes = storage.getChangeCount();
+	changes += itemChanges.load(std::memory_order_relaxed) - savedItemChanges.load(std::memory_order_relaxed);
+	changes += experience != savedExperience.load(std::memory_order_relaxed) ? 1 : 0;
+	changes += bankBalance != savedBankBalance.load(std::memory_order_relaxed) ? 1 : 0;
+	return changes;
+}
+
+bool Player::isInHouse(const std::shared_ptr<Cylinder> &cylinder) {
+	if (!cylinder) {
+		return false;
+	}
+
+	if (const auto &tile = std::dynamic_pointer_cast<Tile>(cylinder)) {
+		return tile->getHouse() != nullptr;
+	}
+
+	const auto &item = cylinder->getItem();
+	if (!item || std::dynamic_pointer_cast<Creature>(item->getTopParent())) {
+		return false;
+	}
+	const auto &tile = item->getTile();
+	return tile && tile->getHouse() != nullptr;
+}
+
 double_t Player::getPercentLevel(uint64_t count, uint64_t nextLevelCount) {
 	if (nextLevelCount == 0) {
 		return 0;
@@ -2870,6 +2927,7 @@ void Player::death(std::shared_ptr<Creature> lastHitCreature) {
 				ss << "You were downgraded from Level " << oldLevel << " to Level " << level << '.';
 				sendTextMessage(MESSAGE_EVENT_ADVANCE, ss.str());
 			}
+			journalExperience(oldLevel != level);
 
 			uint64_t currLevelExp = Player::getExpForLevel(level);
 			uint64_t nextLevelExp = Player::getExpForLevel(level + 1);
@@ -4198,6 +4256,11 @@ void Player::postAddNotification(std::shared_ptr<Thing> thing, std::shared_ptr<C
 
 	bool requireListUpdate = true;
 	if (link == LINK_OWNER || link == LINK_TOPPARENT) {
+		itemChanges.fetch_add(1, std::memory_order_relaxed);
+		if (isInHouse(oldParent)) {
+			movedHouseItems = true;
+		}
+
 		std::shared_ptr<Item> i = (oldParent ? oldParent->getItem() : nullptr);
 		const auto &container = i ? i->getContainer() : nullptr;
 		if (container) {
@@ -4252,6 +4315,11 @@ void Player::postRemoveNotification(std::shared_ptr<Thing> thing, std::shared_pt
 	bool requireListUpdate = true;
 
 	if (link == LINK_OWNER || link == LINK_TOPPARENT) {
+		itemChanges.fetch_add(1, std::memory_order_relaxed);
+		if (isInHouse(newParent)) {
+			movedHouseItems = true;
+		}
+
 		std::shared_ptr<Item> i = (newParent ? newParent->getItem() : nullptr);
 		const auto &container = i ? i->getContainer() : nullptr;
 		if (container) {
@@ -5002,12 +5070,19 @@ void Player::genReservedStorageRange() {
 	// generate outfits range
 	uint32_t outfits_key = PSTRG_OUTFITS_RANGE_START;
 	for (const OutfitEntry &entry : outfits) {
-		storageMap[++outfits_key] = (entry.lookType << 16) | entry.addons;
+		storage.set(++outfits_key, (entry.lookType << 16) | entry.addons);
+	}
+	// Removed outfits leave their old keys right after the new last one
+	while (storage.contains(++outfits_key)) {
+		storage.erase(outfits_key);
 	}
 	// generate familiars range
 	uint32_t familiar_key = PSTRG_FAMILIARS_RANGE_START;
 	for (const FamiliarEntry &entry : familiars) {
-		storageMap[++familiar_key] = (entry.lookType << 16);
+		storage.set(++familiar_key, (entry.lookType << 16));
+	}
+	while (storage.contains(++familiar_key)) {
+		storage.erase(familiar_key);
 	}
 }
 
@@ -39,6 +39,7 @@
 #include "creatures/players/cyclopedia/player_title.hpp"
 #include "creatures/players/vip/player_vip.hpp"
 #include "creatures/players/spy/spy_viewer.hpp"
+#include "creatures/players/storages/player_storage.hpp"
 
 class House;
 class NetworkMessage;
@@ -135,7 +136,7 @@ public:
 		return static_self_cast<Player>();
 	}
 
-	static std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context);
+	static std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string_view context);
 
 	void setID() override;
 
@@ -663,6 +664,37 @@ public:
 	uint64_t getExperience() const {
 		return experience;
 	}
+	/**
+	 * Appends the experience, and the stats that come with the level when it changed, to the player journal.
+	 * Called after every write to them, a crash would otherwise replay older values.
+	 */
+	void journalExperience(bool levelChanged) const;
+
+	// What a save wrote, see getUnsavedChanges
+	struct SaveMark {
+		uint32_t itemChanges = 0;
+		uint64_t experience = 0;
+		uint64_t bankBalance = 0;
+	};
+	// Taken by a save before it reads the player, passed to markSaved once committed
+	SaveMark getSaveMark() const;
+	void markSaved(const SaveMark &mark);
+	/**
+	 * Changes a save would write, ranks the staggered saves: the storages and inventory items changed
+	 * since the last save, plus one each when the experience or the bank balance changed.
+	 */
+	size_t getUnsavedChanges() const;
+
+	/**
+	 * Items went between the player and a house since the last server save, which saves the player
+	 * together with the houses so both sides of the move are written at once. Dispatcher only.
+	 */
+	bool hasMovedHouseItems() const {
+		return movedHouseItems;
+	}
+	void clearMovedHouseItems() {
+		movedHouseItems = false;
+	}
 
 	time_t getLastLoginSaved() const {
 		return lastLoginSaved;
@@ -2667,6 +2699,9 @@ private:
 
 	std::forward_list<std::shared_ptr<Condition>> getMuteConditions() const;
 
+	// A house tile, or a container lying in a house rather than held by someone standing there
+	static bool isInHouse(const std::shared_ptr<Cylinder> &cylinder);
+
 	void checkTradeState(std::shared_ptr<Item> item);
 	bool hasCapacity(std::shared_ptr<Item> item, uint32_t count) const;
 
@@ -2737,7 +2772,7 @@ private:
 	std::map<uint32_t, std::shared_ptr<DepotLocker>> depotLockerMap;
 	std::map<uint32_t, std::shared_ptr<DepotChest>> depotChests;
 	std::map<uint8_t, int64_t> moduleDelayMap;
-	std::map<uint32_t, int32_t> storageMap;
+	PlayerStorage storage;
 	std::map<uint16_t, uint64_t> itemPriceMap;
 
 	std::map<uint8_t, uint16_t> maxValuePerSkill = {
@@ -2789,6 +2824,13 @@ private:
 	uint64_t lastAggressiveAction = 0;
 	uint64_t bankBalance = 0;
 	uint64_t lastQuestlogUpdate = 0;
+	// Inventory items added or removed, compared with the count of the last save
+	std::atomic<uint32_t> itemChanges = 0;
+	// Written by the save, read by the dispatcher
+	std::atomic<uint32_t> savedItemChanges = 0;
+	std::atomic<uint64_t> savedExperience = 0;
+	std::atomic<uint64_t> savedBankBalance = 0;
+	bool movedHouseItems = false;
 	uint64_t preyCards = 0;
 	uint64_t taskHuntingPoints = 0;
 	uint32_t bossPoints = 0;
@@ -3043,6 +3085,7 @@ private:
 	friend class PlayerVIP;
 	friend class ProtocolLogin;
 	friend class SpyViewer;
+	friend class MemoryCensus;
 
 	std::unique_ptr<PlayerWheel> m_wheelPlayer;
 	std::unique_ptr<PlayerAchievement> m_playerAchievement;
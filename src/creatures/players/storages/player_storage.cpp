@@ -0,0 +1,87 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "creatures/players/storages/player_storage.hpp"
+
+int32_t PlayerStorage::get(uint32_t key) const {
+	std::shared_lock lock(mutex);
+	auto it = values.find(key);
+	return it != values.end() ? it->second : -1;
+}
+
+bool PlayerStorage::contains(uint32_t key) const {
+	std::shared_lock lock(mutex);
+	return values.contains(key);
+}
+
+size_t PlayerStorage::size() const {
+	std::shared_lock lock(mutex);
+	return values.size();
+}
+
+int32_t PlayerStorage::set(uint32_t key, int32_t value) {
+	std::scoped_lock lock(mutex);
+	auto it = values.find(key);
+	const int32_t oldValue = it != values.end() ? it->second : -1;
+	if (oldValue == value) {
+		return oldValue;
+	}
+
+	if (value == -1) {
+		values.erase(it);
+	} else if (it != values.end()) {
+		it->second = value;
+	} else {
+		values.emplace(key, value);
+	}
+	markDirty(key);
+	return oldValue;
+}
+
+void PlayerStorage::erase(uint32_t key) {
+	set(key, -1);
+}
+
+void PlayerStorage::load(uint32_t key, int32_t value) {
+	std::scoped_lock lock(mutex);
+	values[key] = value;
+}
+
+PlayerStorage::Changes PlayerStorage::getChanges() const {
+	std::shared_lock lock(mutex);
+	Changes changes;
+	changes.sequence = sequence;
+	for (const auto &[key, _] : dirty) {
+		if (auto it = values.find(key); it != values.end()) {
+			changes.updated.emplace_back(key, it->second);
+		} else {
+			changes.erased.push_back(key);
+		}
+	}
+	return changes;
+}
+
+size_t PlayerStorage::getChangeCount() const {
+	std::shared_lock lock(mutex);
+	return dirty.size();
+}
+
+void PlayerStorage::markSaved(uint64_t savedSequence) {
+	std::scoped_lock lock(mutex);
+	// Keys changed again after the changes were collected stay dirty
+	phmap::erase_if(dirty, [savedSequence](const auto &entry) {
+		return entry.second <= savedSequence;
+	});
+}
+
+void PlayerStorage::markDirty(uint32_t key) {
+	dirty[key] = ++sequence;
+}
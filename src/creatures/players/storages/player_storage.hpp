@@ -0,0 +1,63 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Storage values of a player, -1 meaning unset.
+ *
+ * Keys written since the last save are tracked so only those rows are saved. Each change
+ * gets a sequence number: a save collects the changes up to a sequence and they are only
+ * forgotten by markSaved once the transaction was committed, so a failed save or a change
+ * made while saving is written by the next one.
+ */
+class PlayerStorage {
+public:
+	struct Changes {
+		std::vector<std::pair<uint32_t, int32_t>> updated;
+		std::vector<uint32_t> erased;
+		uint64_t sequence = 0;
+	};
+
+	PlayerStorage() = default;
+
+	// Non-copyable
+	PlayerStorage(const PlayerStorage &) = delete;
+	PlayerStorage &operator=(const PlayerStorage &) = delete;
+
+	int32_t get(uint32_t key) const;
+	bool contains(uint32_t key) const;
+	size_t size() const;
+
+	/**
+	 * Sets a value, -1 erases the key.
+	 * @return The previous value, -1 if the key was unset.
+	 */
+	int32_t set(uint32_t key, int32_t value);
+	void erase(uint32_t key);
+
+	// Value read from the database, already saved
+	void load(uint32_t key, int32_t value);
+
+	Changes getChanges() const;
+	// Keys a save would write, cheaper than getChanges
+	size_t getChangeCount() const;
+	void markSaved(uint64_t sequence);
+
+private:
+	// mutex must be held
+	void markDirty(uint32_t key);
+
+	// Saves run on the thread pool while the dispatcher keeps writing, reads only share it
+	mutable std::shared_mutex mutex;
+	phmap::flat_hash_map<uint32_t, int32_t> values;
+	// Changed key to the sequence of its last change
+	phmap::flat_hash_map<uint32_t, uint64_t> dirty;
+	uint64_t sequence = 0;
+};
@@ -66,6 +66,14 @@ bool Storages::loadFromXML() {
 	return true;
 }
 
-const std::map<std::string, uint32_t> &Storages::getStorageMap() const {
+const phmap::flat_hash_map<std::string, uint32_t> &Storages::getStorageMap() const {
 	return m_storageMap;
 }
+
+std::optional<uint32_t> Storages::getStorageKey(std::string_view name) const {
+	auto it = m_storageMap.find(name);
+	if (it == m_storageMap.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
@@ -25,10 +25,13 @@ public:
 
 	bool loadFromXML();
 
-	const std::map<std::string, uint32_t> &getStorageMap() const;
+	const phmap::flat_hash_map<std::string, uint32_t> &getStorageMap() const;
+
+	// Scripts should resolve their names once when loaded, see Game.getStorageKey
+	std::optional<uint32_t> getStorageKey(std::string_view name) const;
 
 private:
-	std::map<std::string, uint32_t> m_storageMap;
+	phmap::flat_hash_map<std::string, uint32_t> m_storageMap;
 };
 
 constexpr auto g_storages = Storages::getInstance;
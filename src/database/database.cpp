@@ -134,6 +134,7 @@ bool Database::executeQuery(const std::string_view &query) {
 	measureLock.stop();
 
 	metrics::query_latency measure(query.substr(0, 50));
+	metrics::query_kind_latency measureKind(getQueryKind(query));
 	bool success = retryQuery(query, 10);
 	mysql_free_result(mysql_store_result(handle));
 
@@ -152,6 +153,7 @@ DBResult_ptr Database::storeQuery(const std::string_view &query) {
 	measureLock.stop();
 
 	metrics::query_latency measure(query.substr(0, 50));
+	metrics::query_kind_latency measureKind(getQueryKind(query));
 retry:
 	if (mysql_query(handle, query.data()) != 0) {
 		g_logger().error("Query: {}", query);
@@ -175,6 +177,100 @@ retry:
 	return nullptr;
 }
 
+size_t Database::executeBatch(const std::vector<std::string_view> &queries) {
+	if (!handle) {
+		g_logger().error("Database not initialized!");
+		return 0;
+	}
+
+	metrics::lock_latency measureLock("database");
+	std::scoped_lock lock { databaseLock };
+	measureLock.stop();
+
+	metrics::query_kind_latency measureKind("batch");
+	if (mysql_set_server_option(handle, MYSQL_OPTION_MULTI_STATEMENTS_ON) != 0) {
+		g_logger().error("[{}] Failed to enable multi statements: {}", __FUNCTION__, mysql_error(handle));
+		return 0;
+	}
+
+	size_t executed = 0;
+	size_t pending = 0;
+	bool failed = false;
+	std::string batch;
+	const auto maxBatchSize = std::min<uint64_t>(maxPacketSize, MAX_QUERY_SIZE);
+	for (auto query : queries) {
+		// A trailing separator would turn into an empty statement inside the batch
+		const auto end = query.find_last_not_of(" \t\r\n;");
+		query = query.substr(0, end == std::string_view::npos ? 0 : end + 1);
+
+		// Never let a single round trip grow past the server packet limit
+		if (pending > 0 && batch.size() + query.size() + 1 > maxBatchSize) {
+			const size_t done = executeMultiStatement(batch, pending);
+			executed += done;
+			if (done != pending) {
+				failed = true;
+				break;
+			}
+			pending = 0;
+			batch.clear();
+		}
+
+		if (pending > 0) {
+			batch.push_back(';');
+		}
+		batch.append(query);
+		++pending;
+	}
+
+	if (!failed && pending > 0) {
+		executed += executeMultiStatement(batch, pending);
+	}
+
+	mysql_set_server_option(handle, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+	g_metrics().addCounter("database_batched_queries", static_cast<double>(executed));
+	return executed;
+}
+
+size_t Database::executeMultiStatement(const std::string &batch, size_t statements) {
+	g_logger().trace("Executing batch of {} queries", statements);
+
+	size_t executed = 0;
+	int status = mysql_real_query(handle, batch.data(), batch.size());
+	if (status == 0) {
+		do {
+			// Every statement must have its result consumed before the next one can be read
+			mysql_free_result(mysql_store_result(handle));
+			++executed;
+			status = mysql_next_result(handle);
+		} while (status == 0);
+	}
+
+	if (status > 0 || executed != statements) {
+		g_logger().error("Batch failed at query {} of {}", executed + 1, statements);
+		g_logger().error("MySQL error [{}]: {}", mysql_errno(handle), mysql_error(handle));
+	}
+	return std::min(executed, statements);
+}
+
+std::string_view Database::getQueryKind(const std::string_view &query) {
+	static constexpr std::array<std::string_view, 7> kinds = { "select", "insert", "update", "delete", "replace", "show", "optimize" };
+
+	const auto begin = query.find_first_not_of(" \t\r\n(");
+	if (begin == std::string_view::npos) {
+		return "other";
+	}
+
+	for (const auto &kind : kinds) {
+		if (query.size() - begin < kind.size()) {
+			continue;
+		}
+		if (std::ranges::equal(query.substr(begin, kind.size()), kind, [](char a, char b) { return std::tolower(static_cast<unsigned char>(a)) == b; })) {
+			return kind;
+		}
+	}
+	return "other";
+}
+
 std::string Database::escapeString(const std::string &s) const {
 	std::string::size_type len = s.length();
 	auto length = static_cast<uint32_t>(len);
@@ -206,46 +302,60 @@ std::string Database::escapeBlob(const char* s, uint32_t length) const {
 DBResult::DBResult(MYSQL_RES* res) {
 	handle = res;
 
-	int num_fields = mysql_num_fields(handle);
+	fieldCount = mysql_num_fields(handle);
 
 	const MYSQL_FIELD* fields = mysql_fetch_fields(handle);
-	for (size_t i = 0; i < num_fields; i++) {
+	listNames.reserve(fieldCount);
+	for (size_t i = 0; i < fieldCount; i++) {
 		listNames[fields[i].name] = i;
 	}
 	row = mysql_fetch_row(handle);
+	lengths = row != nullptr ? mysql_fetch_lengths(handle) : nullptr;
 }
 
 DBResult::~DBResult() {
 	mysql_free_result(handle);
 }
 
-std::string DBResult::getString(const std::string &s) const {
+size_t DBResult::getColumnIndex(const std::string_view &s) const {
 	auto it = listNames.find(s);
 	if (it == listNames.end()) {
-		g_logger().error("Column '{}' does not exist in result set", s);
-		return std::string();
+		g_logger().error("Column '{}' doesn't exist in the result set", s);
+		return INVALID_COLUMN;
 	}
-	if (row[it->second] == nullptr) {
-		return std::string();
+	return it->second;
+}
+
+std::string_view DBResult::getColumnName(size_t column) const {
+	if (column >= fieldCount) {
+		return {};
 	}
-	return std::string(row[it->second]);
+	return mysql_fetch_fields(handle)[column].name;
 }
 
-const char* DBResult::getStream(const std::string &s, unsigned long &size) const {
-	auto it = listNames.find(s);
-	if (it == listNames.end()) {
-		g_logger().error("Column '{}' doesn't exist in the result set", s);
-		size = 0;
-		return nullptr;
+std::string DBResult::getString(const std::string_view &s) const {
+	return getString(getColumnIndex(s));
+}
+
+std::string DBResult::getString(size_t column) const {
+	if (column >= fieldCount || row[column] == nullptr) {
+		return std::string();
 	}
+	return std::string(row[column], lengths[column]);
+}
+
+const char* DBResult::getStream(const std::string_view &s, unsigned long &size) const {
+	return getStream(getColumnIndex(s), size);
+}
 
-	if (row[it->second] == nullptr) {
+const char* DBResult::getStream(size_t column, unsigned long &size) const {
+	if (column >= fieldCount || row[column] == nullptr) {
 		size = 0;
 		return nullptr;
 	}
 
-	size = mysql_fetch_lengths(handle)[it->second];
-	return row[it->second];
+	size = lengths[column];
+	return row[column];
 }
 
 uint8_t DBResult::getU8FromString(const std::string &string, const std::string &function) const {
@@ -282,6 +392,7 @@ bool DBResult::next() {
 		return false;
 	}
 	row = mysql_fetch_row(handle);
+	lengths = row != nullptr ? mysql_fetch_lengths(handle) : nullptr;
 	return row != nullptr;
 }
 
@@ -40,8 +40,21 @@ public:
 	bool retryQuery(const std::string_view &query, int retries);
 	bool executeQuery(const std::string_view &query);
 
+	/**
+	 * @brief Sends several write queries in as few round trips as possible (multi-statement).
+	 *
+	 * Statements run in order and execution stops at the first failing one.
+	 * @return The number of leading queries that were executed successfully.
+	 */
+	size_t executeBatch(const std::vector<std::string_view> &queries);
+
 	DBResult_ptr storeQuery(const std::string_view &query);
 
+	/**
+	 * @brief Classifies a query by its leading keyword (select, insert, update...), used as a low cardinality metrics label.
+	 */
+	static std::string_view getQueryKind(const std::string_view &query);
+
 	std::string escapeString(const std::string &s) const;
 
 	std::string escapeBlob(const char* s, uint32_t length) const;
@@ -64,6 +77,7 @@ private:
 	bool commit();
 
 	bool isRecoverableError(unsigned int error) const;
+	size_t executeMultiStatement(const std::string &batch, size_t statements);
 
 	MYSQL* handle = nullptr;
 	std::recursive_mutex databaseLock;
@@ -83,72 +97,48 @@ public:
 	DBResult(const DBResult &) = delete;
 	DBResult &operator=(const DBResult &) = delete;
 
+	static constexpr size_t INVALID_COLUMN = std::numeric_limits<size_t>::max();
+
+	/**
+	 * @brief Resolves a column name to its index in the result set.
+	 *
+	 * Loops reading many rows should resolve their columns once, before the loop,
+	 * and then use the index-based accessors to skip the name lookup per field.
+	 * @return The column index, or INVALID_COLUMN if it doesn't exist (an error is logged).
+	 */
+	size_t getColumnIndex(const std::string_view &s) const;
+
 	template <typename T>
-	T getNumber(const std::string &s) const {
-		auto it = listNames.find(s);
-		if (it == listNames.end()) {
-			g_logger().error("[DBResult::getNumber] - Column '{}' doesn't exist in the result set", s);
-			return T();
-		}
+	T getNumber(const std::string_view &s) const {
+		return getNumber<T>(getColumnIndex(s));
+	}
 
-		if (row[it->second] == nullptr) {
+	template <typename T>
+	T getNumber(size_t column) const {
+		static_assert(std::is_integral_v<T>, "DBResult::getNumber requires an integral type");
+		if (column >= fieldCount || row[column] == nullptr) {
 			return T();
 		}
 
-		T data = 0;
-		try {
-			// Check if the type T is signed or unsigned
-			if constexpr (std::is_signed_v<T>) {
-				// Check if the type T is int8_t or int16_t
-				if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
-					// Use std::stoi to convert string to int8_t
-					data = static_cast<T>(std::stoi(row[it->second]));
-				}
-				// Check if the type T is int32_t
-				else if constexpr (std::is_same_v<T, int32_t>) {
-					// Use std::stol to convert string to int32_t
-					data = static_cast<T>(std::stol(row[it->second]));
-				}
-				// Check if the type T is int64_t
-				else if constexpr (std::is_same_v<T, int64_t>) {
-					// Use std::stoll to convert string to int64_t
-					data = static_cast<T>(std::stoll(row[it->second]));
-				} else {
-					// Throws exception indicating that type T is invalid
-					g_logger().error("Invalid signed type T");
-				}
-			} else if (std::is_same<T, bool>::value) {
-				data = static_cast<T>(std::stoi(row[it->second]));
-			} else {
-				// Check if the type T is uint8_t or uint16_t or uint32_t
-				if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> || std::is_same_v<T, uint32_t>) {
-					// Use std::stoul to convert string to uint8_t
-					data = static_cast<T>(std::stoul(row[it->second]));
-				}
-				// Check if the type T is uint64_t
-				else if constexpr (std::is_same_v<T, uint64_t>) {
-					// Use std::stoull to convert string to uint64_t
-					data = static_cast<T>(std::stoull(row[it->second]));
-				} else {
-					// Send log indicating that type T is invalid
-					g_logger().error("Column '{}' has an invalid unsigned T is invalid", s);
-				}
+		const char* first = row[column];
+		const char* last = first + lengths[column];
+		if constexpr (std::is_same_v<T, bool>) {
+			return parseNumber<int64_t>(column, first, last) != 0;
+		} else if constexpr (std::is_unsigned_v<T>) {
+			// Signed values stored in columns read as unsigned keep the old stoul wrap-around behaviour
+			if (first != last && *first == '-') {
+				return static_cast<T>(parseNumber<int64_t>(column, first, last));
 			}
-		} catch (std::invalid_argument &e) {
-			// Value of string is invalid
-			g_logger().error("Column '{}' has an invalid value set, error code: {}", s, e.what());
-			data = T();
-		} catch (std::out_of_range &e) {
-			// Value of string is too large to fit the range allowed by type T
-			g_logger().error("Column '{}' has a value out of range, error code: {}", s, e.what());
-			data = T();
+			return static_cast<T>(parseNumber<uint64_t>(column, first, last));
+		} else {
+			return static_cast<T>(parseNumber<int64_t>(column, first, last));
 		}
-
-		return data;
 	}
 
-	std::string getString(const std::string &s) const;
-	const char* getStream(const std::string &s, unsigned long &size) const;
+	std::string getString(const std::string_view &s) const;
+	std::string getString(size_t column) const;
+	const char* getStream(const std::string_view &s, unsigned long &size) const;
+	const char* getStream(size_t column, unsigned long &size) const;
 	uint8_t getU8FromString(const std::string &string, const std::string &function) const;
 	int8_t getInt8FromString(const std::string &string, const std::string &function) const;
 
@@ -157,10 +147,31 @@ public:
 	bool next();
 
 private:
+	template <typename T>
+	T parseNumber(size_t column, const char* first, const char* last) const {
+		T data = 0;
+		auto [ptr, ec] = std::from_chars(first, last, data);
+		if (ec == std::errc::result_out_of_range) {
+			// Value of string is too large to fit the range allowed by type T
+			g_logger().error("Column '{}' has a value out of range", getColumnName(column));
+			return T();
+		}
+		if (ec != std::errc() || ptr == first) {
+			// Value of string is invalid
+			g_logger().error("Column '{}' has an invalid value set", getColumnName(column));
+			return T();
+		}
+		return data;
+	}
+
+	std::string_view getColumnName(size_t column) const;
+
 	MYSQL_RES* handle;
 	MYSQL_ROW row;
+	unsigned long* lengths = nullptr;
+	size_t fieldCount = 0;
 
-	std::map<std::string_view, size_t> listNames;
+	phmap::flat_hash_map<std::string_view, size_t> listNames;
 
 	friend class Database;
 };
@@ -9,6 +9,7 @@
 
 #include "pch.hpp"
 
+#include "config/configmanager.hpp"
 #include "database/databasetasks.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "lib/thread/thread_pool.hpp"
@@ -23,19 +24,118 @@ DatabaseTasks &DatabaseTasks::getInstance() {
 }
 
 void DatabaseTasks::execute(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */) {
-	threadPool.detach_task([this, query, callback]() {
-		bool success = db.executeQuery(query);
-		if (callback != nullptr) {
-			g_dispatcher().addEvent([callback, success]() { callback(nullptr, success); }, "DatabaseTasks::execute");
-		}
-	});
+	addTask({ query, std::move(callback), false });
 }
 
 void DatabaseTasks::store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback /* nullptr */) {
-	threadPool.detach_task([this, query, callback]() {
-		DBResult_ptr result = db.storeQuery(query);
-		if (callback != nullptr) {
-			g_dispatcher().addEvent([callback, result]() { callback(result, true); }, "DatabaseTasks::store");
+	addTask({ query, std::move(callback), true });
+}
+
+void DatabaseTasks::addTask(DatabaseTask &&task) {
+	{
+		std::scoped_lock lock(taskLock);
+		pendingTasks.emplace_back(std::move(task));
+		if (flushScheduled) {
+			return;
+		}
+		flushScheduled = true;
+	}
+
+	// A single flush task drains the queue, so queries keep the order in which they were issued
+	threadPool.detach_task([this]() { flush(); });
+}
+
+void DatabaseTasks::flush() {
+	Database &connection = getConnection();
+	std::vector<DatabaseTask> tasks;
+	while (true) {
+		{
+			std::scoped_lock lock(taskLock);
+			if (pendingTasks.empty()) {
+				flushScheduled = false;
+				return;
+			}
+			tasks.swap(pendingTasks);
 		}
-	});
+
+		runTasks(connection, tasks);
+		tasks.clear();
+	}
+}
+
+void DatabaseTasks::runTasks(Database &connection, std::vector<DatabaseTask> &tasks) {
+	const auto maxBatchSize = static_cast<size_t>(std::max<int32_t>(1, g_configManager().getNumber(MYSQL_ASYNC_BATCH_SIZE, __FUNCTION__)));
+
+	size_t batchBegin = 0;
+	for (size_t i = 0; i < tasks.size(); ++i) {
+		if (!tasks[i].store) {
+			if (i + 1 - batchBegin >= maxBatchSize) {
+				runBatch(connection, std::span(tasks).subspan(batchBegin, i + 1 - batchBegin));
+				batchBegin = i + 1;
+			}
+			continue;
+		}
+
+		// Reads must observe every write queued before them
+		runBatch(connection, std::span(tasks).subspan(batchBegin, i - batchBegin));
+		batchBegin = i + 1;
+
+		DBResult_ptr result = connection.storeQuery(tasks[i].query);
+		dispatchCallback(tasks[i], result, true);
+	}
+
+	runBatch(connection, std::span(tasks).subspan(batchBegin));
+}
+
+void DatabaseTasks::runBatch(Database &connection, std::span<DatabaseTask> batch) {
+	if (batch.empty()) {
+		return;
+	}
+
+	size_t executed = 0;
+	if (batch.size() > 1) {
+		std::vector<std::string_view> queries;
+		queries.reserve(batch.size());
+		for (const auto &task : batch) {
+			queries.emplace_back(task.query);
+		}
+		executed = connection.executeBatch(queries);
+	}
+
+	for (size_t i = 0; i < batch.size(); ++i) {
+		// Whatever the batch didn't run goes through the regular path, which retries recoverable errors
+		bool success = i < executed || connection.executeQuery(batch[i].query);
+		dispatchCallback(batch[i], nullptr, success);
+	}
+}
+
+void DatabaseTasks::dispatchCallback(const DatabaseTask &task, DBResult_ptr result, bool success) const {
+	if (task.callback == nullptr) {
+		return;
+	}
+
+	if (task.store) {
+		g_dispatcher().addEvent([callback = task.callback, result]() { callback(result, true); }, "DatabaseTasks::store");
+	} else {
+		g_dispatcher().addEvent([callback = task.callback, success]() { callback(nullptr, success); }, "DatabaseTasks::execute");
+	}
+}
+
+Database &DatabaseTasks::getConnection() {
+	if (asyncConnection) {
+		return *asyncConnection;
+	}
+	if (asyncConnectionFailed || !g_configManager().getBoolean(MYSQL_ASYNC_CONNECTION, __FUNCTION__)) {
+		return db;
+	}
+
+	auto connection = std::make_unique<Database>();
+	if (!connection->connect()) {
+		g_logger().warn("[{}] Failed to open the asynchronous database connection, falling back to the main connection", __FUNCTION__);
+		asyncConnectionFailed = true;
+		return db;
+	}
+
+	asyncConnection = std::move(connection);
+	return *asyncConnection;
 }
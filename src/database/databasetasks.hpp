@@ -26,8 +26,30 @@ public:
 	void store(const std::string &query, std::function<void(DBResult_ptr, bool)> callback = nullptr);
 
 private:
+	struct DatabaseTask {
+		std::string query;
+		std::function<void(DBResult_ptr, bool)> callback;
+		bool store;
+	};
+
+	void addTask(DatabaseTask &&task);
+	void flush();
+	void runTasks(Database &connection, std::vector<DatabaseTask> &tasks);
+	void runBatch(Database &connection, std::span<DatabaseTask> batch);
+	void dispatchCallback(const DatabaseTask &task, DBResult_ptr result, bool success) const;
+
+	Database &getConnection();
+
 	Database &db;
 	ThreadPool &threadPool;
+
+	// Dedicated connection for queued tasks, so they never wait on the synchronous handle
+	std::unique_ptr<Database> asyncConnection;
+	bool asyncConnectionFailed = false;
+
+	std::mutex taskLock;
+	std::vector<DatabaseTask> pendingTasks;
+	bool flushScheduled = false;
 };
 
 constexpr auto g_databaseTasks = DatabaseTasks::getInstance;
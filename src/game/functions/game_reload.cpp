@@ -14,6 +14,7 @@
 #include "config/configmanager.hpp"
 #include "lua/creature/events.hpp"
 #include "creatures/players/imbuements/imbuements.hpp"
+#include "creatures/monsters/monster_type_cache.hpp"
 #include "lua/scripts/lua_environment.hpp"
 #include "lua/modules/modules.hpp"
 #include "lua/scripts/scripts.hpp"
@@ -204,7 +205,7 @@ bool GameReload::reloadMonsters() {
 	const auto &coreFolder = g_configManager().getString(CORE_DIRECTORY, __FUNCTION__);
 
 	const bool scriptsLoaded = g_scripts().loadScripts(coreFolder + "/scripts/lib", true, false);
-	const bool monsterScriptsLoaded = g_scripts().loadScripts(datapackFolder + "/monster", false, true);
+	const bool monsterScriptsLoaded = g_monsterTypeCache().loadMonsters(datapackFolder + "/monster", true);
 
 	if (scriptsLoaded && monsterScriptsLoaded) {
 		logReloadStatus("Monsters", true);
@@ -0,0 +1,275 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/functions/memory_census.hpp"
+
+#include "creatures/combat/combat.hpp"
+#include "game/game.hpp"
+#include "game/movement/teleport.hpp"
+#include "items/bed.hpp"
+#include "items/containers/depot/depotchest.hpp"
+#include "items/containers/depot/depotlocker.hpp"
+#include "items/containers/inbox/inbox.hpp"
+#include "items/containers/mailbox/mailbox.hpp"
+#include "items/containers/rewards/reward.hpp"
+#include "items/containers/rewards/rewardchest.hpp"
+#include "items/trashholder.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "map/house/house.hpp"
+#include "map/house/housetile.hpp"
+
+namespace {
+	// Items outside the map (players, depots) are not accounted to any sector
+	constexpr uint32_t NO_SECTOR = std::numeric_limits<uint32_t>::max();
+	// Objects are created through std::make_shared, which places the control block next to the object
+	constexpr uint64_t SHARED_CONTROL_BLOCK_SIZE = 2 * sizeof(void*);
+}
+
+MemoryCensus MemoryCensus::run(size_t topCount, const std::string &jsonPath) {
+	MemoryCensus census = collect();
+	census.exportMetrics(topCount);
+
+	if (!jsonPath.empty()) {
+		std::ofstream file(jsonPath, std::ios::out | std::ios::trunc);
+		if (file.is_open()) {
+			file << census.toJson(topCount);
+		} else {
+			g_logger().error("[{}] Failed to write memory census to {}", __FUNCTION__, jsonPath);
+		}
+	}
+
+	g_logger().info("Memory census: {} items ({} KiB) and {} tiles ({} KiB) counted in {} milliseconds", census.items.count, census.items.bytes / 1024, census.tiles.count, census.tiles.bytes / 1024, census.duration);
+	for (const auto &[kind, entry] : census.byContainerKind) {
+		g_logger().info("Memory census: {} {} using {} KiB", entry.count, kind, entry.bytes / 1024);
+	}
+	return census;
+}
+
+MemoryCensus MemoryCensus::collect() {
+	Benchmark bm_census;
+	MemoryCensus census;
+
+	for (const auto &[sectorKey, sector] : g_game().map.mapSectors) {
+		for (int8_t z = 0; z < MAP_MAX_LAYERS; ++z) {
+			const auto &floor = sector.getFloor(z);
+			if (!floor) {
+				continue;
+			}
+
+			std::shared_lock sl(floor->getMutex());
+			for (const auto &row : floor->getTiles()) {
+				for (const auto &[tile, cachedTile] : row) {
+					if (tile) {
+						census.addTile(tile, sectorKey);
+					}
+				}
+			}
+		}
+	}
+
+	for (const auto &[_, player] : g_game().getPlayers()) {
+		census.addPlayer(player);
+	}
+
+	census.visited.clear();
+	census.duration = bm_census.duration();
+	return census;
+}
+
+void MemoryCensus::addTile(const std::shared_ptr<Tile> &tile, uint32_t sectorKey) {
+	uint64_t bytes = SHARED_CONTROL_BLOCK_SIZE;
+	if (tile->getHouse()) {
+		bytes += sizeof(HouseTile);
+	} else if (dynamic_cast<const StaticTile*>(tile.get())) {
+		bytes += sizeof(StaticTile);
+	} else {
+		bytes += sizeof(DynamicTile);
+	}
+
+	if (const auto itemList = tile->getItemList()) {
+		bytes += itemList->size() * sizeof(std::shared_ptr<Item>);
+		for (const auto &item : *itemList) {
+			addItem(item, "map", sectorKey);
+		}
+	}
+
+	if (const auto &ground = tile->getGround()) {
+		addItem(ground, "map", sectorKey);
+	}
+
+	tiles.add(bytes);
+	bySector[sectorKey].bytes += bytes;
+}
+
+void MemoryCensus::addPlayer(const std::shared_ptr<Player> &player) {
+	for (int32_t slot = CONST_SLOT_FIRST; slot <= CONST_SLOT_LAST; ++slot) {
+		if (const auto &item = player->inventory[slot]) {
+			addItem(item, "inventory", NO_SECTOR);
+		}
+	}
+
+	for (const auto &[_, depotLocker] : player->depotLockerMap) {
+		addItem(depotLocker, "depot", NO_SECTOR);
+	}
+	for (const auto &[_, depotChest] : player->depotChests) {
+		addItem(depotChest, "depot", NO_SECTOR);
+	}
+	if (player->inbox) {
+		addItem(player->inbox, "inbox", NO_SECTOR);
+	}
+	for (const auto &[_, reward] : player->rewardMap) {
+		addItem(reward, "reward", NO_SECTOR);
+	}
+}
+
+void MemoryCensus::addItem(const std::shared_ptr<Item> &item, std::string_view source, uint32_t sectorKey) {
+	if (!item || !visited.emplace(item.get()).second) {
+		return;
+	}
+
+	const uint64_t bytes = getItemBytes(item);
+	items.add(bytes);
+	byItemType[item->getID()].add(bytes);
+	bySource[source].add(bytes);
+	if (sectorKey != NO_SECTOR) {
+		bySector[sectorKey].add(bytes);
+	}
+
+	const auto &container = item->getContainer();
+	if (!container) {
+		return;
+	}
+
+	byContainerKind[getContainerKind(item)].add(bytes);
+	for (const auto &child : container->getItemList()) {
+		addItem(child, source, sectorKey);
+	}
+}
+
+uint64_t MemoryCensus::getItemBytes(const std::shared_ptr<Item> &item) {
+	uint64_t bytes = SHARED_CONTROL_BLOCK_SIZE + item->getAttributesMemoryUsage();
+	if (const auto &container = item->getContainer()) {
+		bytes += sizeof(Container) + container->size() * sizeof(std::shared_ptr<Item>);
+	} else if (item->getTeleport()) {
+		bytes += sizeof(Teleport);
+	} else if (item->getMagicField()) {
+		bytes += sizeof(MagicField);
+	} else if (item->getDoor()) {
+		bytes += sizeof(Door);
+	} else if (item->getBed()) {
+		bytes += sizeof(BedItem);
+	} else if (item->getMailbox()) {
+		bytes += sizeof(Mailbox);
+	} else if (item->getTrashHolder()) {
+		bytes += sizeof(TrashHolder);
+	} else {
+		bytes += sizeof(Item);
+	}
+	return bytes;
+}
+
+std::string_view MemoryCensus::getContainerKind(const std::shared_ptr<Item> &item) {
+	const auto &container = item->getContainer();
+	if (container->getDepotLocker()) {
+		return "depot_locker";
+	} else if (container->isDepotChest()) {
+		return "depot_chest";
+	} else if (container->isInbox()) {
+		return "inbox";
+	} else if (container->getRewardChest()) {
+		return "reward_chest";
+	} else if (container->getReward()) {
+		return "reward_bag";
+	} else if (container->isStoreInbox()) {
+		return "store_inbox";
+	}
+	return "container";
+}
+
+template <typename Key>
+std::vector<std::pair<Key, MemoryCensus::Entry>> MemoryCensus::getTop(const std::map<Key, Entry> &entries, size_t topCount) {
+	std::vector<std::pair<Key, Entry>> top(entries.begin(), entries.end());
+	const auto byBytes = [](const auto &a, const auto &b) { return a.second.bytes > b.second.bytes; };
+	if (top.size() > topCount) {
+		std::ranges::partial_sort(top, top.begin() + topCount, byBytes);
+		top.resize(topCount);
+	} else {
+		std::ranges::sort(top, byBytes);
+	}
+	return top;
+}
+
+std::string MemoryCensus::toJson(size_t topCount) const {
+	const auto escape = [](std::string_view text) {
+		std::string escaped;
+		escaped.reserve(text.size());
+		for (const char c : text) {
+			if (c == '"' || c == '\\') {
+				escaped.push_back('\\');
+			}
+			escaped.push_back(c);
+		}
+		return escaped;
+	};
+	const auto entryJson = [](const Entry &entry) {
+		return fmt::format("\"count\": {}, \"bytes\": {}", entry.count, entry.bytes);
+	};
+
+	std::string json;
+	json.append(fmt::format("{{\n\t\"duration_ms\": {},\n", duration));
+	json.append(fmt::format("\t\"items\": {{ {} }},\n", entryJson(items)));
+	json.append(fmt::format("\t\"tiles\": {{ {} }},\n", entryJson(tiles)));
+
+	json.append("\t\"sources\": [");
+	for (auto it = bySource.begin(); it != bySource.end(); ++it) {
+		json.append(fmt::format("{}\n\t\t{{ \"source\": \"{}\", {} }}", it == bySource.begin() ? "" : ",", it->first, entryJson(it->second)));
+	}
+	json.append("\n\t],\n\t\"container_kinds\": [");
+	for (auto it = byContainerKind.begin(); it != byContainerKind.end(); ++it) {
+		json.append(fmt::format("{}\n\t\t{{ \"kind\": \"{}\", {} }}", it == byContainerKind.begin() ? "" : ",", it->first, entryJson(it->second)));
+	}
+
+	json.append("\n\t],\n\t\"item_types\": [");
+	bool first = true;
+	for (const auto &[itemId, entry] : getTop(byItemType, topCount)) {
+		json.append(fmt::format("{}\n\t\t{{ \"id\": {}, \"name\": \"{}\", {} }}", first ? "" : ",", itemId, escape(Item::items[itemId].name), entryJson(entry)));
+		first = false;
+	}
+
+	json.append("\n\t],\n\t\"sectors\": [");
+	first = true;
+	for (const auto &[sectorKey, entry] : getTop(bySector, topCount)) {
+		const uint32_t x = (sectorKey & 0xFFFF) * SECTOR_SIZE;
+		const uint32_t y = (sectorKey >> 16) * SECTOR_SIZE;
+		json.append(fmt::format("{}\n\t\t{{ \"x\": {}, \"y\": {}, {} }}", first ? "" : ",", x, y, entryJson(entry)));
+		first = false;
+	}
+	json.append("\n\t]\n}\n");
+	return json;
+}
+
+void MemoryCensus::exportMetrics(size_t topCount) const {
+	g_metrics().setGauge("memory_census_bytes", static_cast<int64_t>(items.bytes), { { "group", "items" } });
+	g_metrics().setGauge("memory_census_bytes", static_cast<int64_t>(tiles.bytes), { { "group", "tiles" } });
+	g_metrics().setGauge("memory_census_count", static_cast<int64_t>(items.count), { { "group", "items" } });
+	g_metrics().setGauge("memory_census_count", static_cast<int64_t>(tiles.count), { { "group", "tiles" } });
+
+	for (const auto &[source, entry] : bySource) {
+		g_metrics().setGauge("memory_census_source_bytes", static_cast<int64_t>(entry.bytes), { { "source", std::string(source) } });
+	}
+	for (const auto &[kind, entry] : byContainerKind) {
+		g_metrics().setGauge("memory_census_container_bytes", static_cast<int64_t>(entry.bytes), { { "kind", std::string(kind) } });
+		g_metrics().setGauge("memory_census_container_count", static_cast<int64_t>(entry.count), { { "kind", std::string(kind) } });
+	}
+	for (const auto &[itemId, entry] : getTop(byItemType, topCount)) {
+		g_metrics().setGauge("memory_census_item_type_bytes", static_cast<int64_t>(entry.bytes), { { "item_id", std::to_string(itemId) } });
+	}
+}
@@ -0,0 +1,82 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Item;
+class Player;
+class Tile;
+
+/**
+ * On-demand memory census of the items held by the game.
+ *
+ * Walks the instantiated map tiles, the online players (inventory, depot chests,
+ * depot lockers, inbox and rewards) and every nested container, and accounts the
+ * estimated bytes of each object by item type, container kind, source and map sector.
+ * Must run on the dispatcher thread.
+ */
+class MemoryCensus {
+public:
+	struct Entry {
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+
+		void add(uint64_t addBytes) {
+			++count;
+			bytes += addBytes;
+		}
+	};
+
+	/**
+	 * Collects the census, exports it as metrics gauges, writes it as JSON to the given
+	 * path (if not empty) and logs a summary.
+	 * @param topCount Number of item types and sectors kept in the JSON and metrics.
+	 */
+	static MemoryCensus run(size_t topCount, const std::string &jsonPath);
+
+	static MemoryCensus collect();
+
+	std::string toJson(size_t topCount) const;
+	void exportMetrics(size_t topCount) const;
+
+	const Entry &getItems() const {
+		return items;
+	}
+	const Entry &getTiles() const {
+		return tiles;
+	}
+	uint64_t getTotalBytes() const {
+		return items.bytes + tiles.bytes;
+	}
+	double getDuration() const {
+		return duration;
+	}
+
+private:
+	void addTile(const std::shared_ptr<Tile> &tile, uint32_t sectorKey);
+	void addPlayer(const std::shared_ptr<Player> &player);
+	void addItem(const std::shared_ptr<Item> &item, std::string_view source, uint32_t sectorKey);
+
+	static uint64_t getItemBytes(const std::shared_ptr<Item> &item);
+	static std::string_view getContainerKind(const std::shared_ptr<Item> &item);
+
+	template <typename Key>
+	static std::vector<std::pair<Key, Entry>> getTop(const std::map<Key, Entry> &entries, size_t topCount);
+
+	Entry items;
+	Entry tiles;
+	std::map<uint16_t, Entry> byItemType;
+	std::map<std::string_view, Entry> byContainerKind;
+	std::map<std::string_view, Entry> bySource;
+	std::map<uint32_t, Entry> bySector;
+
+	// Containers can be reachable from more than one root (e.g. depot chests inside lockers)
+	phmap::flat_hash_set<const Item*> visited;
+	double duration = 0;
+};
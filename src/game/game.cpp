@@ -490,6 +490,9 @@ void Game::start(ServiceManager* manager) {
 	g_dispatcher().cycleEvent(
 		EVENT_LUA_GARBAGE_COLLECTION, [this] { g_luaEnvironment().collectGarbage(); }, "Calling GC"
 	);
+	g_dispatcher().cycleEvent(
+		EVENT_PLAYER_SAVE_INTERVAL, [] { g_saveManager().saveDuePlayers(); }, "SaveManager::saveDuePlayers"
+	);
 	auto marketItemsPriceIntervalMinutes = g_configManager().getNumber(MARKET_REFRESH_PRICES, __FUNCTION__);
 	if (marketItemsPriceIntervalMinutes > 0) {
 		auto marketItemsPriceIntervalMS = marketItemsPriceIntervalMinutes * 60000;
@@ -6195,8 +6198,8 @@ void Game::playerSpeakToNpc(std::shared_ptr<Player> player, const std::string &t
 	player->updateUIExhausted();
 }
 
-std::shared_ptr<Task> Game::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) const {
-	return Player::createPlayerTask(delay, std::move(f), std::move(context));
+std::shared_ptr<Task> Game::createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string_view context) const {
+	return Player::createPlayerTask(delay, std::move(f), context);
 }
 
 //--
@@ -7891,13 +7894,37 @@ void Game::addDistanceEffect(const CreatureVector &spectators, const Position &f
 }
 
 void Game::checkImbuements() {
+	// Each interval decays every online player once, even while earlier rounds are still queued
 	for (const auto &[mapPlayerId, mapPlayer] : getPlayers()) {
-		if (!mapPlayer) {
-			continue;
+		if (mapPlayer) {
+			imbuementDecayQueue.push_back(mapPlayerId);
 		}
+	}
 
-		mapPlayer->updateInventoryImbuement();
+	if (imbuementDecayRunning || imbuementDecayQueue.empty()) {
+		return;
 	}
+
+	imbuementDecayRunning = true;
+	g_dispatcher().addResumableEvent(
+		[this](const TickBudget &budget) {
+			while (!imbuementDecayQueue.empty()) {
+				const auto playerId = imbuementDecayQueue.front();
+				imbuementDecayQueue.pop_front();
+				if (const auto &player = getPlayerByID(playerId)) {
+					player->updateInventoryImbuement();
+				}
+
+				if (!imbuementDecayQueue.empty() && budget.isExhausted()) {
+					return true;
+				}
+			}
+
+			imbuementDecayRunning = false;
+			return false;
+		},
+		"Game::checkImbuements"
+	);
 }
 
 void Game::checkLight() {
@@ -10287,18 +10314,43 @@ bool Game::removeFiendishMonster(uint32_t id, bool create /* = true*/) {
 }
 
 void Game::updateForgeableMonsters() {
-	forgeableMonsters.clear();
-	for (auto [monsterId, monster] : monsters) {
-		auto monsterTile = monster->getTile();
-		if (!monsterTile) {
-			continue;
-		}
+	if (forgeableMonstersUpdating) {
+		return;
+	}
 
-		if (monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT)) {
-			forgeableMonsters.push_back(monster->getID());
-		}
+	// Monsters can be removed between slices, so they are looked up again by id
+	std::vector<uint32_t> monsterIds;
+	monsterIds.reserve(monsters.size());
+	for (const auto &[monsterId, monster] : monsters) {
+		monsterIds.push_back(monsterId);
 	}
 
+	forgeableMonstersUpdating = true;
+	g_dispatcher().addResumableEvent(
+		[this, monsterIds = std::move(monsterIds), forgeable = std::vector<uint32_t>(), index = size_t(0)](const TickBudget &budget) mutable {
+			while (index < monsterIds.size()) {
+				const auto monster = getMonsterByID(monsterIds[index++]);
+				const auto monsterTile = monster ? monster->getTile() : nullptr;
+				if (monsterTile && monster->canBeForgeMonster() && !monsterTile->hasFlag(TILESTATE_NOLOGOUT)) {
+					forgeable.push_back(monster->getID());
+				}
+
+				if (index < monsterIds.size() && budget.isExhausted()) {
+					return true;
+				}
+			}
+
+			// The previous list stays in use until this one is complete
+			forgeableMonsters = std::move(forgeable);
+			forgeableMonstersUpdating = false;
+			updateFiendishMonsters();
+			return false;
+		},
+		"Game::updateForgeableMonsters"
+	);
+}
+
+void Game::updateFiendishMonsters() {
 	for (const auto monsterId : getFiendishMonsters()) {
 		if (!getMonsterByID(monsterId)) {
 			removeFiendishMonster(monsterId);
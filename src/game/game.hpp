@@ -60,6 +60,7 @@ static constexpr int32_t EVENT_DECAYINTERVAL = 250;
 static constexpr int32_t EVENT_DECAY_BUCKETS = 4;
 static constexpr int32_t EVENT_FORGEABLEMONSTERCHECKINTERVAL = 300000;
 static constexpr int32_t EVENT_LUA_GARBAGE_COLLECTION = 60000 * 10; // 10min
+static constexpr int32_t EVENT_PLAYER_SAVE_INTERVAL = 1000;
 
 static constexpr std::chrono::minutes CACHE_EXPIRATION_TIME { 10 }; // 10min
 static constexpr std::chrono::minutes HIGHSCORE_CACHE_EXPIRATION_TIME { 10 }; // 10min
@@ -646,6 +647,7 @@ public:
 	void createFiendishMonsters();
 	void createInfluencedMonsters();
 	void updateForgeableMonsters();
+	void updateFiendishMonsters();
 	void checkForgeEventId(uint32_t monsterId);
 	uint32_t makeFiendishMonster(uint32_t forgeableMonsterId = 0, bool createForgeableMonsters = false);
 	uint32_t makeInfluencedMonster();
@@ -752,7 +754,7 @@ private:
 	bool playerYell(std::shared_ptr<Player> player, const std::string &text);
 	bool playerSpeakTo(std::shared_ptr<Player> player, SpeakClasses type, const std::string &receiver, const std::string &text);
 	void playerSpeakToNpc(std::shared_ptr<Player> player, const std::string &text);
-	std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string context) const;
+	std::shared_ptr<Task> createPlayerTask(uint32_t delay, std::function<void(void)> f, std::string_view context) const;
 
 	/**
 	 * @brief Finds the managed container for loot or obtain based on the given parameters.
@@ -864,6 +866,10 @@ private:
 	std::map<uint32_t, std::shared_ptr<Npc>> npcs;
 	std::map<uint32_t, std::shared_ptr<Monster>> monsters;
 	std::vector<uint32_t> forgeableMonsters;
+	bool forgeableMonstersUpdating = false;
+	// Players whose imbuements are still to be decayed, see checkImbuements
+	std::deque<uint32_t> imbuementDecayQueue;
+	bool imbuementDecayRunning = false;
 
 	std::map<uint32_t, std::unique_ptr<TeamFinder>> teamFinderMap; // [leaderGUID] = TeamFinder*
 
@@ -10,8 +10,10 @@
 #include "pch.hpp"
 
 #include "game/scheduling/dispatcher.hpp"
+#include "config/configmanager.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
 #include "utils/tools.hpp"
 
 thread_local DispatcherContext Dispatcher::dispacherContext;
@@ -29,10 +31,21 @@ void Dispatcher::init() {
 		while (!threadPool.isStopped()) {
 			UPDATE_OTSYS_TIME();
 
+			const auto cycleStart = std::chrono::steady_clock::now();
+			cycleTasks = 0;
+
 			executeEvents();
 			executeScheduledEvents();
 			mergeEvents();
 
+			if (cycleTasks > 0) {
+				const auto cycleDuration = std::chrono::steady_clock::now() - cycleStart;
+				taskTracer.recordCycle(cycleTasks, cycleDuration, OTSYS_TIME());
+				g_metrics().recordLatency("dispatcher_cycle_latency", cycleDuration);
+				g_metrics().addCounter("dispatcher_cycles", 1);
+				g_metrics().addCounter("dispatcher_tasks", static_cast<double>(cycleTasks));
+			}
+
 			if (!hasPendingTasks) {
 				signalSchedule.wait_for(asyncLock, timeUntilNextScheduledTask());
 			}
@@ -40,14 +53,29 @@ void Dispatcher::init() {
 	});
 }
 
+bool Dispatcher::executeTask(const Task &task) {
+	const auto start = std::chrono::steady_clock::now();
+	if (!task.execute()) {
+		return false;
+	}
+
+	const auto wait = start - task.getDueTime();
+	taskTracer.recordTask(task.getContext(), std::chrono::steady_clock::now() - start, wait, OTSYS_TIME());
+	if (wait.count() > 0) {
+		g_metrics().recordLatency("task_wait_latency", wait, "task", task.getContext());
+	}
+	return true;
+}
+
 void Dispatcher::executeSerialEvents(std::vector<Task> &tasks) {
 	dispacherContext.group = TaskGroup::Serial;
 	dispacherContext.type = DispatcherType::Event;
 
 	for (const auto &task : tasks) {
 		dispacherContext.taskName = task.getContext();
-		if (task.execute()) {
+		if (executeTask(task)) {
 			++dispatcherCycle;
+			++cycleTasks;
 		}
 	}
 	tasks.clear();
@@ -56,28 +84,19 @@ void Dispatcher::executeSerialEvents(std::vector<Task> &tasks) {
 }
 
 void Dispatcher::executeParallelEvents(std::vector<Task> &tasks, const uint8_t groupId) {
-	std::atomic_uint_fast64_t totalTaskSize = tasks.size();
-	std::atomic_bool isTasksCompleted = false;
-
-	for (const auto &task : tasks) {
-		threadPool.detach_task([groupId, &task, &isTasksCompleted, &totalTaskSize] {
-			dispacherContext.type = DispatcherType::AsyncEvent;
-			dispacherContext.group = static_cast<TaskGroup>(groupId);
-			dispacherContext.taskName = task.getContext();
-
-			task.execute();
+	cycleTasks += tasks.size();
 
-			dispacherContext.reset();
+	// The dispatcher thread runs tasks too, and idle workers steal the ones left behind a slow task
+	threadPool.parallelFor(0, tasks.size(), [this, groupId, &tasks](size_t index) {
+		const auto &task = tasks[index];
+		dispacherContext.type = DispatcherType::AsyncEvent;
+		dispacherContext.group = static_cast<TaskGroup>(groupId);
+		dispacherContext.taskName = task.getContext();
 
-			totalTaskSize.fetch_sub(1);
-			if (totalTaskSize.load() == 0) {
-				isTasksCompleted.store(true);
-				isTasksCompleted.notify_one();
-			}
-		});
-	}
+		executeTask(task);
 
-	isTasksCompleted.wait(false);
+		dispacherContext.reset();
+	});
 
 	tasks.clear();
 }
@@ -99,7 +118,7 @@ void Dispatcher::executeEvents(const TaskGroup startGroup) {
 }
 
 void Dispatcher::executeScheduledEvents() {
-	auto &threadScheduledTasks = getThreadTask()->scheduledTasks;
+	const auto &thread = getThreadTask();
 
 	auto it = scheduledTasks.begin();
 	while (it != scheduledTasks.end()) {
@@ -112,9 +131,17 @@ void Dispatcher::executeScheduledEvents() {
 		dispacherContext.group = TaskGroup::Serial;
 		dispacherContext.taskName = task->getContext();
 
-		if (task->execute() && task->isCycle()) {
+		const bool executed = executeTask(*task);
+		if (executed) {
+			++cycleTasks;
+		}
+
+		if (executed && task->isCycle()) {
 			task->updateTime();
-			threadScheduledTasks.emplace_back(task);
+			// The slot may be shared with other threads
+			std::scoped_lock lock(thread->mutex);
+			thread->scheduledTasks.emplace_back(task);
+			thread->hasScheduledTasks.store(true, std::memory_order_release);
 		} else {
 			scheduledTasksRef.erase(task->getId());
 		}
@@ -138,12 +165,8 @@ void Dispatcher::mergeAsyncEvents() {
 	constexpr uint8_t end = static_cast<uint8_t>(TaskGroup::Last);
 
 	for (const auto &thread : threads) {
-		std::scoped_lock lock(thread->mutex);
 		for (uint_fast8_t i = start; i < end; ++i) {
-			if (!thread->tasks[i].empty()) {
-				m_tasks[i].insert(m_tasks[i].end(), make_move_iterator(thread->tasks[i].begin()), make_move_iterator(thread->tasks[i].end()));
-				thread->tasks[i].clear();
-			}
+			thread->tasks[i].drainTo(m_tasks[i]);
 		}
 	}
 }
@@ -153,13 +176,11 @@ void Dispatcher::mergeEvents() {
 	constexpr uint8_t serial = static_cast<uint8_t>(TaskGroup::Serial);
 
 	for (const auto &thread : threads) {
-		std::scoped_lock lock(thread->mutex);
-		if (!thread->tasks[serial].empty()) {
-			m_tasks[serial].insert(m_tasks[serial].end(), make_move_iterator(thread->tasks[serial].begin()), make_move_iterator(thread->tasks[serial].end()));
-			thread->tasks[serial].clear();
-		}
+		thread->tasks[serial].drainTo(m_tasks[serial]);
 
-		if (!thread->scheduledTasks.empty()) {
+		// A task scheduled after the exchange is taken now or in the next cycle
+		if (thread->hasScheduledTasks.exchange(false, std::memory_order_acq_rel)) {
+			std::scoped_lock lock(thread->mutex);
 			scheduledTasks.insert(make_move_iterator(thread->scheduledTasks.begin()), make_move_iterator(thread->scheduledTasks.end()));
 			thread->scheduledTasks.clear();
 		}
@@ -181,13 +202,23 @@ std::chrono::milliseconds Dispatcher::timeUntilNextScheduledTask() const {
 	return std::max<std::chrono::milliseconds>(timeRemaining, CHRONO_0);
 }
 
-void Dispatcher::addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace_back(expiresAfterMs, std::move(f), context);
+void Dispatcher::addEvent(TaskFunction &&f, std::string_view context, uint32_t expiresAfterMs) {
+	getThreadTask()->tasks[static_cast<uint8_t>(TaskGroup::Serial)].push(Task(expiresAfterMs, std::move(f), context));
 	notify();
 }
 
+void Dispatcher::addResumableEvent(std::function<bool(const TickBudget &)> &&job, std::string_view context) {
+	addEvent(
+		[this, job = std::move(job), context]() mutable {
+			const TickBudget budget(std::chrono::milliseconds(std::max<int32_t>(1, g_configManager().getNumber(DISPATCHER_JOB_BUDGET, __FUNCTION__))));
+			if (job(budget)) {
+				addResumableEvent(std::move(job), context);
+			}
+		},
+		context
+	);
+}
+
 uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
 	const auto &thread = getThreadTask();
 	std::scoped_lock lock(thread->mutex);
@@ -195,15 +226,14 @@ uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
 	auto eventId = scheduledTasksRef
 					   .emplace(task->getId(), thread->scheduledTasks.emplace_back(task))
 					   .first->first;
+	thread->hasScheduledTasks.store(true, std::memory_order_release);
 
 	notify();
 	return eventId;
 }
 
-void Dispatcher::asyncEvent(std::function<void(void)> &&f, TaskGroup group) {
-	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(group)].emplace_back(0, std::move(f), dispacherContext.taskName);
+void Dispatcher::asyncEvent(TaskFunction &&f, TaskGroup group) {
+	getThreadTask()->tasks[static_cast<uint8_t>(group)].push(Task(0, std::move(f), dispacherContext.taskName));
 	notify();
 }
 
@@ -215,11 +245,11 @@ void Dispatcher::stopEvent(uint64_t eventId) {
 	}
 }
 
-void DispatcherContext::addEvent(std::function<void(void)> &&f) const {
+void DispatcherContext::addEvent(TaskFunction &&f) const {
 	g_dispatcher().addEvent(std::move(f), taskName);
 }
 
-void DispatcherContext::tryAddEvent(std::function<void(void)> &&f) const {
+void DispatcherContext::tryAddEvent(TaskFunction &&f) const {
 	if (!f) {
 		return;
 	}
@@ -10,10 +10,14 @@
 #pragma once
 
 #include "task.hpp"
+#include "task_tracer.hpp"
+#include "lib/thread/mpsc_queue.hpp"
 #include "lib/thread/thread_pool.hpp"
 
 static constexpr uint16_t DISPATCHER_TASK_EXPIRATION = 2000;
 static constexpr uint16_t SCHEDULER_MINTICKS = 50;
+// Tasks of each group a thread can have queued without locking
+static constexpr size_t DISPATCHER_THREAD_QUEUE_CAPACITY = 1024;
 
 enum class TaskGroup : int8_t {
 	ThreadPool = -1,
@@ -56,10 +60,10 @@ struct DispatcherContext {
 	}
 
 	// postpone the event
-	void addEvent(std::function<void(void)> &&f) const;
+	void addEvent(TaskFunction &&f) const;
 
 	// if the context is async, the event will be postponed, if not, it will be executed immediately.
-	void tryAddEvent(std::function<void(void)> &&f) const;
+	void tryAddEvent(TaskFunction &&f) const;
 
 private:
 	void reset() {
@@ -75,6 +79,22 @@ private:
 	friend class Dispatcher;
 };
 
+/**
+ * Time a resumable event may still spend in the current dispatcher cycle.
+ */
+class TickBudget {
+public:
+	explicit TickBudget(std::chrono::milliseconds budget) :
+		deadline(std::chrono::steady_clock::now() + budget) { }
+
+	bool isExhausted() const {
+		return std::chrono::steady_clock::now() >= deadline;
+	}
+
+private:
+	std::chrono::steady_clock::time_point deadline;
+};
+
 /**
  * Dispatcher allow you to dispatch a task async to be executed
  * in the dispatching thread. You can dispatch with an expiration
@@ -84,7 +104,8 @@ class Dispatcher {
 public:
 	explicit Dispatcher(ThreadPool &threadPool) :
 		threadPool(threadPool) {
-		threads.reserve(threadPool.get_thread_count() + 1);
+		// Parallel workers post tasks too, plus the dispatcher and a slot shared by the threads outside the pools
+		threads.reserve(threadPool.get_thread_count() + threadPool.getParallelWorkerCount() + 2);
 		for (uint_fast16_t i = 0; i < threads.capacity(); ++i) {
 			threads.emplace_back(std::make_unique<ThreadTask>());
 		}
@@ -96,18 +117,31 @@ public:
 
 	static Dispatcher &getInstance();
 
-	void addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs = 0);
+	// Starts the dispatcher loop on a thread of the pool, it runs until the pool is stopped
+	void init();
+	void shutdown() {
+		signalSchedule.notify_all();
+	}
 
-	uint64_t cycleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context) {
+	void addEvent(TaskFunction &&f, std::string_view context, uint32_t expiresAfterMs = 0);
+
+	/**
+	 * Runs a long serial job in slices, one per dispatcher cycle, each limited by the dispatcherJobBudget config.
+	 * The job returns true while it has work left and is queued again, so the tasks queued meanwhile run first.
+	 * It must check the budget after each unit of work and keep its progress in its own captures.
+	 */
+	void addResumableEvent(std::function<bool(const TickBudget &)> &&job, std::string_view context);
+
+	uint64_t cycleEvent(uint32_t delay, TaskFunction &&f, std::string_view context) {
 		return scheduleEvent(delay, std::move(f), context, true);
 	}
 
 	uint64_t scheduleEvent(const std::shared_ptr<Task> &task);
-	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context) {
+	uint64_t scheduleEvent(uint32_t delay, TaskFunction &&f, std::string_view context) {
 		return scheduleEvent(delay, std::move(f), context, false);
 	}
 
-	void asyncEvent(std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel);
+	void asyncEvent(TaskFunction &&f, TaskGroup group = TaskGroup::GenericParallel);
 
 	uint64_t asyncCycleEvent(uint32_t delay, std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel) {
 		return scheduleEvent(
@@ -115,9 +149,9 @@ public:
 		);
 	}
 
-	uint64_t asyncScheduleEvent(uint32_t delay, std::function<void(void)> &&f, TaskGroup group = TaskGroup::GenericParallel) {
+	uint64_t asyncScheduleEvent(uint32_t delay, TaskFunction &&f, TaskGroup group = TaskGroup::GenericParallel) {
 		return scheduleEvent(
-			delay, [this, f = std::move(f), group] { asyncEvent([f] { f(); }, group); }, dispacherContext.taskName, false, false
+			delay, [this, f = std::move(f), group]() mutable { asyncEvent(std::move(f), group); }, dispacherContext.taskName, false, false
 		);
 	}
 
@@ -131,27 +165,29 @@ public:
 		return dispacherContext;
 	}
 
+	const TaskTracer &getTaskTracer() const {
+		return taskTracer;
+	}
+
 private:
 	thread_local static DispatcherContext dispacherContext;
 
 	const auto &getThreadTask() const {
-		return threads[ThreadPool::getThreadId()];
+		// Threads outside the pools (e.g. password verification) share the last slot, its queues take any number of producers
+		return threads[std::min<size_t>(ThreadPool::getThreadId(), threads.size() - 1)];
 	}
 
-	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context, bool cycle, bool log = true) {
+	uint64_t scheduleEvent(uint32_t delay, TaskFunction &&f, std::string_view context, bool cycle, bool log = true) {
 		return scheduleEvent(std::make_shared<Task>(std::move(f), context, delay, cycle, log));
 	}
 
-	void init();
-	void shutdown() {
-		signalSchedule.notify_all();
-	}
-
 	inline void mergeAsyncEvents();
 	inline void mergeEvents();
 	inline void executeEvents(const TaskGroup startGroup = TaskGroup::Serial);
 	inline void executeScheduledEvents();
 
+	// Runs the task, recording how long it waited and ran
+	inline bool executeTask(const Task &task);
 	inline void executeSerialEvents(std::vector<Task> &tasks);
 	inline void executeParallelEvents(std::vector<Task> &tasks, const uint8_t groupId);
 	inline std::chrono::milliseconds timeUntilNextScheduledTask() const;
@@ -175,6 +211,10 @@ private:
 
 	uint_fast64_t dispatcherCycle = 0;
 
+	TaskTracer taskTracer;
+	// Tasks run in the current iteration of the dispatcher loop
+	uint64_t cycleTasks = 0;
+
 	ThreadPool &threadPool;
 	std::condition_variable signalSchedule;
 	std::atomic_bool hasPendingTasks = false;
@@ -183,14 +223,14 @@ private:
 	// Thread Events
 	struct ThreadTask {
 		ThreadTask() {
-			for (auto &task : tasks) {
-				task.reserve(2000);
-			}
 			scheduledTasks.reserve(2000);
 		}
 
-		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
+		// Taken by the dispatcher without locking
+		std::array<OverflowingMpscQueue<Task, DISPATCHER_THREAD_QUEUE_CAPACITY>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
 		std::vector<std::shared_ptr<Task>> scheduledTasks;
+		// Set when scheduledTasks has tasks, so the dispatcher only locks when there is something to take
+		std::atomic_bool hasScheduledTasks = false;
 		std::mutex mutex;
 	};
 	std::vector<std::unique_ptr<ThreadTask>> threads;
@@ -199,8 +239,6 @@ private:
 	std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> m_tasks;
 	phmap::btree_multiset<std::shared_ptr<Task>, Task::Compare> scheduledTasks;
 	phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Task>> scheduledTasksRef;
-
-	friend class CanaryServer;
 };
 
 constexpr auto g_dispatcher = Dispatcher::getInstance;
@@ -0,0 +1,338 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/player_journal.hpp"
+#include "database/database.hpp"
+
+namespace {
+	// [payload size][crc32 of the payload]
+	constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+	// sequence, guid, type, key, value
+	constexpr size_t PAYLOAD_SIZE = sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t) + sizeof(int64_t);
+
+	// The journal is only read back by the server that wrote it, so values are kept in host byte order
+	template <typename T>
+	void write(std::string &buffer, T value) {
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	T read(const char*&data) {
+		T value;
+		std::memcpy(&value, data, sizeof(T));
+		data += sizeof(T);
+		return value;
+	}
+
+	uint32_t checksum(const char* data, size_t size) {
+		return static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size)));
+	}
+
+	std::string_view getColumn(PlayerJournalType type) {
+		switch (type) {
+			case PlayerJournalType::Experience:
+				return "experience";
+			case PlayerJournalType::Level:
+				return "level";
+			case PlayerJournalType::HealthMax:
+				return "healthmax";
+			case PlayerJournalType::ManaMax:
+				return "manamax";
+			case PlayerJournalType::Capacity:
+				return "cap";
+			default:
+				return {};
+		}
+	}
+}
+
+PlayerJournal &PlayerJournal::getInstance() {
+	return inject<PlayerJournal>();
+}
+
+bool PlayerJournal::start(const std::string &path, std::chrono::seconds interval) {
+	filePath = path;
+	compactInterval = interval;
+
+	std::string contents;
+	if (std::ifstream input(filePath, std::ios::binary); input) {
+		contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+	}
+
+	if (!contents.empty()) {
+		std::vector<PlayerJournalRecord> records;
+		const size_t decoded = decode(contents, records);
+		if (decoded < contents.size()) {
+			g_logger().warn("[{}] Dropped the last {} bytes of {}, cut short or corrupted", __FUNCTION__, contents.size() - decoded, filePath);
+		}
+
+		fold(records, values);
+		if (!writeToDatabase(values)) {
+			g_logger().error("[{}] Failed to write the {} records of {} to the database", __FUNCTION__, records.size(), filePath);
+			return false;
+		}
+		g_logger().info("Replayed {} player journal records of {} players.", records.size(), values.size());
+		values.clear();
+	}
+
+	// Everything in it is in the database now
+	file = std::fopen(filePath.c_str(), "wb");
+	if (!file) {
+		g_logger().error("[{}] Failed to open {}", __FUNCTION__, filePath);
+		return false;
+	}
+
+	enabled = true;
+	writer = std::thread([this] { work(); });
+	return true;
+}
+
+void PlayerJournal::shutdown() {
+	if (!writer.joinable()) {
+		return;
+	}
+
+	{
+		std::scoped_lock lock(pendingMutex);
+		stopping = true;
+	}
+	pendingSignal.notify_one();
+	writer.join();
+	enabled = false;
+}
+
+void PlayerJournal::append(uint32_t guid, PlayerJournalType type, int64_t value, uint32_t key /* = 0*/) {
+	if (!isEnabled()) {
+		return;
+	}
+
+	{
+		std::scoped_lock lock(pendingMutex);
+		pending.push_back({ sequence.fetch_add(1, std::memory_order_acq_rel) + 1, guid, type, key, value });
+	}
+	pendingSignal.notify_one();
+}
+
+uint64_t PlayerJournal::beginSave(uint32_t guid) {
+	if (!isEnabled()) {
+		return 0;
+	}
+
+	std::scoped_lock lock(savesMutex);
+	++savesInProgress[guid];
+	if (compacting) {
+		savedWhileCompacting.emplace(guid);
+	}
+	return sequence.load(std::memory_order_acquire);
+}
+
+void PlayerJournal::endSave(uint32_t guid, uint64_t savedSequence, bool success) {
+	if (!isEnabled()) {
+		return;
+	}
+
+	{
+		std::scoped_lock lock(savesMutex);
+		if (auto it = savesInProgress.find(guid); it != savesInProgress.end() && --it->second == 0) {
+			savesInProgress.erase(it);
+		}
+		if (compacting) {
+			savedWhileCompacting.emplace(guid);
+		}
+	}
+
+	if (success) {
+		append(guid, PlayerJournalType::Saved, static_cast<int64_t>(savedSequence));
+	}
+}
+
+void PlayerJournal::work() {
+	std::vector<PlayerJournalRecord> batch;
+	auto compactAt = std::chrono::steady_clock::now() + compactInterval;
+	while (true) {
+		bool stop;
+		{
+			std::unique_lock lock(pendingMutex);
+			pendingSignal.wait_until(lock, compactAt, [this] { return stopping || !pending.empty(); });
+			batch.swap(pending);
+			stop = stopping;
+		}
+
+		if (!batch.empty()) {
+			buffer.clear();
+			for (const auto &record : batch) {
+				encode(record, buffer);
+			}
+			// Flushed to the OS, which keeps it through a crash of the server
+			std::fwrite(buffer.data(), 1, buffer.size(), file);
+			std::fflush(file);
+
+			fold(batch, values);
+			batch.clear();
+		}
+
+		if (stop) {
+			compact();
+			break;
+		}
+
+		if (std::chrono::steady_clock::now() >= compactAt) {
+			compact();
+			compactAt = std::chrono::steady_clock::now() + compactInterval;
+		}
+	}
+
+	std::fclose(file);
+	file = nullptr;
+}
+
+bool PlayerJournal::compact() {
+	// Saves committed so far have appended their Saved records already
+	std::vector<PlayerJournalRecord> batch;
+	{
+		std::scoped_lock lock(savesMutex, pendingMutex);
+		batch.swap(pending);
+		compacting = true;
+		for (const auto &[guid, _] : savesInProgress) {
+			savedWhileCompacting.emplace(guid);
+		}
+	}
+	fold(batch, values);
+
+	Benchmark bm_compact;
+	const bool written = values.empty() || writeToDatabase(values);
+
+	std::scoped_lock lock(savesMutex);
+	compacting = false;
+	if (!written) {
+		savedWhileCompacting.clear();
+		// The file still has the older ones, the next compaction retries
+		buffer.clear();
+		for (const auto &record : batch) {
+			encode(record, buffer);
+		}
+		std::fwrite(buffer.data(), 1, buffer.size(), file);
+		std::fflush(file);
+		g_logger().error("[{}] Failed to write the journal of {} players to the database", __FUNCTION__, values.size());
+		return false;
+	}
+
+	if (!values.empty()) {
+		g_logger().debug("[{}] Wrote the journal of {} players to the database in {} milliseconds", __FUNCTION__, values.size(), bm_compact.duration());
+	}
+	std::erase_if(values, [this](const auto &entry) {
+		return !savedWhileCompacting.contains(entry.first);
+	});
+	savedWhileCompacting.clear();
+	return rewrite();
+}
+
+bool PlayerJournal::rewrite() {
+	file = std::freopen(filePath.c_str(), "wb", file);
+	if (!file) {
+		g_logger().error("[{}] Failed to reopen {}, the journal is disabled", __FUNCTION__, filePath);
+		enabled = false;
+		return false;
+	}
+
+	buffer.clear();
+	for (const auto &[guid, playerValues] : values) {
+		for (const auto &[type, column] : playerValues.columns) {
+			encode({ column.sequence, guid, type, 0, column.value }, buffer);
+		}
+	}
+	std::fwrite(buffer.data(), 1, buffer.size(), file);
+	std::fflush(file);
+	return true;
+}
+
+bool PlayerJournal::writeToDatabase(const Values &values) {
+	// Throws on failure, so the transaction is rolled back instead of committing part of it
+	return DBTransaction::executeWithinTransaction([&values]() {
+		Database &db = Database::getInstance();
+		for (const auto &[guid, playerValues] : values) {
+			std::string query = "UPDATE `players` SET ";
+			for (const auto &[type, column] : playerValues.columns) {
+				// The database keeps the capacity in ounces
+				const int64_t value = type == PlayerJournalType::Capacity ? column.value / 100 : column.value;
+				fmt::format_to(std::back_inserter(query), "`{}` = {},", getColumn(type), value);
+			}
+			query.back() = ' ';
+			fmt::format_to(std::back_inserter(query), "WHERE `id` = {}", guid);
+			if (!db.executeQuery(query)) {
+				throw DatabaseException(fmt::format("Failed to update the journaled columns of player {}", guid));
+			}
+		}
+		return true;
+	});
+}
+
+void PlayerJournal::encode(const PlayerJournalRecord &record, std::string &buffer) {
+	const size_t start = buffer.size();
+	write<uint32_t>(buffer, PAYLOAD_SIZE);
+	write<uint32_t>(buffer, 0);
+	write<uint64_t>(buffer, record.sequence);
+	write<uint32_t>(buffer, record.guid);
+	write<uint8_t>(buffer, static_cast<uint8_t>(record.type));
+	write<uint32_t>(buffer, record.key);
+	write<int64_t>(buffer, record.value);
+
+	const uint32_t crc = checksum(buffer.data() + start + HEADER_SIZE, PAYLOAD_SIZE);
+	std::memcpy(buffer.data() + start + sizeof(uint32_t), &crc, sizeof(crc));
+}
+
+size_t PlayerJournal::decode(std::string_view buffer, std::vector<PlayerJournalRecord> &records) {
+	size_t offset = 0;
+	while (buffer.size() - offset >= HEADER_SIZE) {
+		const char* data = buffer.data() + offset;
+		const auto size = read<uint32_t>(data);
+		const auto crc = read<uint32_t>(data);
+		if (size != PAYLOAD_SIZE || buffer.size() - offset - HEADER_SIZE < size || checksum(data, size) != crc) {
+			break;
+		}
+
+		PlayerJournalRecord record;
+		record.sequence = read<uint64_t>(data);
+		record.guid = read<uint32_t>(data);
+		record.type = static_cast<PlayerJournalType>(read<uint8_t>(data));
+		record.key = read<uint32_t>(data);
+		record.value = read<int64_t>(data);
+		records.emplace_back(record);
+		offset += HEADER_SIZE + size;
+	}
+	return offset;
+}
+
+void PlayerJournal::fold(const std::vector<PlayerJournalRecord> &records, Values &values) {
+	for (const auto &record : records) {
+		if (record.type != PlayerJournalType::Saved) {
+			// Types no longer journaled, left in the file by an older build
+			if (!getColumn(record.type).empty()) {
+				values[record.guid].columns[record.type] = { record.value, record.sequence };
+			}
+			continue;
+		}
+
+		auto it = values.find(record.guid);
+		if (it == values.end()) {
+			continue;
+		}
+
+		const auto savedSequence = static_cast<uint64_t>(record.value);
+		const auto isSaved = [savedSequence](const auto &entry) {
+			return entry.second.sequence <= savedSequence;
+		};
+		std::erase_if(it->second.columns, isSaved);
+		if (it->second.columns.empty()) {
+			values.erase(it);
+		}
+	}
+}
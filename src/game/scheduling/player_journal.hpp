@@ -0,0 +1,132 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+// Written to the file, a type is never renumbered
+enum class PlayerJournalType : uint8_t {
+	Experience = 1,
+	Level = 2,
+	HealthMax = 3,
+	ManaMax = 4,
+	Capacity = 5,
+	// Every change of the player up to value (a journal sequence) is in the database
+	Saved = 8,
+};
+
+struct PlayerJournalRecord {
+	uint64_t sequence = 0;
+	uint32_t guid = 0;
+	PlayerJournalType type = PlayerJournalType::Experience;
+	uint32_t key = 0;
+	int64_t value = 0;
+
+	bool operator==(const PlayerJournalRecord &) const = default;
+};
+
+/**
+ * Append-only log of the player changes a crash would lose until their next save.
+ * The game appends records on the dispatcher, a writer thread writes them to the file and keeps
+ * the latest value of each, and every compact interval writes those values to the database
+ * and empties the file. At startup, the records left by a crash are written the same way.
+ *
+ * Only experience and the stats it drives are journaled. The bank balance and the storages
+ * change together with items (deposits, quest rewards), which only the full save writes, so
+ * they are left to it: writing them alone would pair them with older items.
+ *
+ * Each record is stored as [payload size][crc32 of the payload][payload], so a record cut by the
+ * crash, and everything after it, is detected and dropped.
+ */
+class PlayerJournal {
+public:
+	// Latest journaled value of each player column, with the sequence that set it
+	struct Value {
+		int64_t value = 0;
+		uint64_t sequence = 0;
+	};
+	struct PlayerValues {
+		std::map<PlayerJournalType, Value> columns;
+	};
+	using Values = std::map<uint32_t, PlayerValues>;
+
+	PlayerJournal() = default;
+
+	// Singleton - ensures we don't accidentally copy it
+	PlayerJournal(const PlayerJournal &) = delete;
+	void operator=(const PlayerJournal &) = delete;
+
+	static PlayerJournal &getInstance();
+
+	bool isEnabled() const {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Writes the records left in the file by the last run to the database and starts the writer.
+	 * Called once at startup, before players can log in.
+	 */
+	bool start(const std::string &filePath, std::chrono::seconds compactInterval);
+	// Writes the pending records to the database and stops the writer
+	void shutdown();
+
+	// Dispatcher thread, no-op when the journal is disabled
+	void append(uint32_t guid, PlayerJournalType type, int64_t value, uint32_t key = 0);
+
+	/**
+	 * Called by a save before it reads the player, returns the sequence to pass to endSave.
+	 * Once the save is committed, every record of the player up to that sequence is dropped.
+	 */
+	uint64_t beginSave(uint32_t guid);
+	void endSave(uint32_t guid, uint64_t savedSequence, bool success);
+
+	static void encode(const PlayerJournalRecord &record, std::string &buffer);
+	/**
+	 * Decodes the records of buffer, stopping at the first one cut short or failing its checksum.
+	 * @return How many bytes were decoded, less than the buffer size when its tail was dropped.
+	 */
+	static size_t decode(std::string_view buffer, std::vector<PlayerJournalRecord> &records);
+	// Keeps the latest value of each record, dropping the ones older than a Saved record and the unknown types
+	static void fold(const std::vector<PlayerJournalRecord> &records, Values &values);
+
+private:
+	void work();
+	bool compact();
+	// Replaces the file contents with values
+	bool rewrite();
+	static bool writeToDatabase(const Values &values);
+
+	std::atomic_bool enabled = false;
+	std::atomic<uint64_t> sequence = 0;
+
+	std::mutex pendingMutex;
+	std::condition_variable pendingSignal;
+	std::vector<PlayerJournalRecord> pending;
+	bool stopping = false;
+
+	// Writer thread only
+	std::FILE* file = nullptr;
+	std::string filePath;
+	std::chrono::seconds compactInterval {};
+	Values values;
+	std::string buffer;
+
+	/**
+	 * A save may read a player before a compaction writes it and commit after, writing back older
+	 * values: the values of players saved while compacting are kept and written again next time.
+	 * Only held for bookkeeping, the database is written without it.
+	 */
+	std::mutex savesMutex;
+	phmap::flat_hash_map<uint32_t, uint32_t> savesInProgress;
+	phmap::flat_hash_set<uint32_t> savedWhileCompacting;
+	bool compacting = false;
+
+	std::thread writer;
+};
+
+constexpr auto g_playerJournal = PlayerJournal::getInstance;
@@ -0,0 +1,98 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/player_save_scheduler.hpp"
+
+void PlayerSaveScheduler::setLimits(std::chrono::milliseconds newInterval, int64_t newSavesPerSecond) {
+	std::scoped_lock lock(mutex);
+	interval = std::max(newInterval, std::chrono::milliseconds(1));
+	savesPerSecond = std::max<int64_t>(newSavesPerSecond, 1);
+}
+
+std::chrono::milliseconds PlayerSaveScheduler::getSlot(uint32_t guid) const {
+	// Guids are mostly consecutive, mixed so they don't all land at the start of the interval
+	const uint64_t hash = (static_cast<uint64_t>(guid) * 0x9E3779B97F4A7C15ULL) >> 32;
+	return std::chrono::milliseconds((hash * static_cast<uint64_t>(interval.count())) >> 32);
+}
+
+PlayerSaveScheduler::Clock::time_point PlayerSaveScheduler::getDueAt(uint32_t guid, Clock::time_point now) const {
+	const auto sinceSlot = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) - getSlot(guid);
+	// Rounded down, now may come before the first slot on a freshly booted machine
+	auto intervals = sinceSlot / interval;
+	if (sinceSlot % interval < std::chrono::milliseconds::zero()) {
+		--intervals;
+	}
+	return Clock::time_point(std::chrono::duration_cast<Clock::duration>(intervals * interval + getSlot(guid)));
+}
+
+std::vector<uint32_t> PlayerSaveScheduler::pick(std::vector<Candidate> candidates, Clock::time_point now) {
+	std::scoped_lock lock(mutex);
+	// A second's worth, overdraft from saves beyond the budget is paid back first
+	budget = std::min(budget + savesPerSecond, savesPerSecond);
+
+	lag = {};
+	++picks;
+	std::erase_if(candidates, [this, now](const Candidate &candidate) {
+		auto [it, inserted] = states.try_emplace(candidate.guid, State { now });
+		it->second.seenAt = picks;
+		const auto dueAt = getDueAt(candidate.guid, now);
+		if (inserted || it->second.queued || it->second.savedAt >= dueAt) {
+			return true;
+		}
+
+		++lag.overdue;
+		lag.max = std::max(lag.max, std::chrono::duration_cast<std::chrono::milliseconds>(now - dueAt));
+		return false;
+	});
+	// Logged out, a save of theirs still running finds no state to report to
+	phmap::erase_if(states, [this](const auto &entry) {
+		return entry.second.seenAt != picks;
+	});
+
+	const auto count = static_cast<size_t>(std::clamp<int64_t>(budget, 0, static_cast<int64_t>(candidates.size())));
+	std::ranges::partial_sort(candidates, candidates.begin() + count, std::ranges::greater {}, &Candidate::changes);
+
+	std::vector<uint32_t> guids;
+	guids.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		states[candidates[i].guid].queued = true;
+		guids.push_back(candidates[i].guid);
+	}
+	return guids;
+}
+
+std::chrono::milliseconds PlayerSaveScheduler::onSaved(uint32_t guid, Clock::time_point savedAt, bool success) {
+	std::scoped_lock lock(mutex);
+	--budget;
+
+	auto it = states.find(guid);
+	if (it == states.end()) {
+		return {};
+	}
+
+	it->second.queued = false;
+	if (!success) {
+		// Still due, retried by a later pick
+		return {};
+	}
+
+	const auto dueAt = getDueAt(guid, savedAt);
+	const auto previousSave = std::exchange(it->second.savedAt, savedAt);
+	if (previousSave >= dueAt) {
+		return {};
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(savedAt - dueAt);
+}
+
+PlayerSaveScheduler::Lag PlayerSaveScheduler::getLag() const {
+	std::scoped_lock lock(mutex);
+	return lag;
+}
@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Spreads the saves of online players across the save interval instead of saving everyone at once.
+ * Each player gets a slot in the interval from a hash of its guid and is due once per interval,
+ * at its slot. Every second, the due players are picked, the ones with the most unsaved changes
+ * first, until the saves of that second (including the ones made for other reasons, like a logout)
+ * reach the budget. Players left over stay due and are picked in the next seconds.
+ *
+ * The dispatcher picks, saves report back from any thread.
+ */
+class PlayerSaveScheduler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Candidate {
+		uint32_t guid = 0;
+		// Unsaved changes, the largest are saved first
+		size_t changes = 0;
+	};
+
+	struct Lag {
+		// Due players not saved yet
+		size_t overdue = 0;
+		std::chrono::milliseconds max {};
+	};
+
+	void setLimits(std::chrono::milliseconds interval, int64_t savesPerSecond);
+
+	// Offset of the guid's slot from the start of each interval
+	std::chrono::milliseconds getSlot(uint32_t guid) const;
+	// Start of the guid's latest slot not after now
+	Clock::time_point getDueAt(uint32_t guid, Clock::time_point now) const;
+
+	/**
+	 * Called once per second with the online players, returns the guids to save now. Players seen
+	 * for the first time just logged in and count as saved, the ones missing logged out.
+	 */
+	std::vector<uint32_t> pick(std::vector<Candidate> candidates, Clock::time_point now);
+
+	/**
+	 * Called after every player save, scheduled or not, so it counts against the budget.
+	 * @return How long after its slot the player was saved, zero when it wasn't due.
+	 */
+	std::chrono::milliseconds onSaved(uint32_t guid, Clock::time_point savedAt, bool success);
+
+	// Overdue players as of the last pick
+	Lag getLag() const;
+
+private:
+	struct State {
+		Clock::time_point savedAt;
+		bool queued = false;
+		uint64_t seenAt = 0;
+	};
+
+	mutable std::mutex mutex;
+	phmap::flat_hash_map<uint32_t, State> states;
+	std::chrono::milliseconds interval { 1 };
+	int64_t savesPerSecond = 0;
+	// Saves left this second, negative when other saves went over the budget
+	int64_t budget = 0;
+	uint64_t picks = 0;
+	Lag lag;
+};
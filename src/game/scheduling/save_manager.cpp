@@ -2,7 +2,9 @@
 
 #include "game/game.hpp"
 #include "game/scheduling/save_manager.hpp"
+#include "game/scheduling/player_journal.hpp"
 #include "io/iologindata.hpp"
+#include "lib/metrics/metrics.hpp"
 
 SaveManager::SaveManager(ThreadPool &threadPool, KVStore &kvStore, Logger &logger, Game &game) :
 	threadPool(threadPool), kv(kvStore), logger(logger), game(game) { }
@@ -14,9 +16,59 @@ SaveManager &SaveManager::getInstance() {
 void SaveManager::saveAll() {
 	Benchmark bm_saveAll;
 	logger.info("Saving server...");
-	const auto players = game.getPlayers();
+	saveGameState(getPlayersToSave(false));
+	saveMap(IOMapSerialize::snapshotHouses());
+	logger.info("Server saved in {} milliseconds.", bm_saveAll.duration());
+}
 
-	for (const auto &[_, player] : players) {
+void SaveManager::scheduleAll() {
+	auto scheduledAt = std::chrono::steady_clock::now();
+	m_scheduledAt = scheduledAt;
+
+	// The houses are copied here on the dispatcher and written by a worker, so the game only pauses for the snapshot
+	Benchmark bm_snapshot;
+	const auto snapshot = IOMapSerialize::snapshotHouses();
+	logger.info("Saving server, houses snapshot taken in {} milliseconds...", bm_snapshot.duration());
+
+	auto players = getPlayersToSave(isStaggeringPlayerSaves());
+
+	// Disable save async if the config is set to false
+	if (!g_configManager().getBoolean(TOGGLE_SAVE_ASYNC, __FUNCTION__)) {
+		Benchmark bm_saveAll;
+		saveGameState(players);
+		logger.info("Server saved in {} milliseconds, houses are written in the background.", bm_saveAll.duration());
+		threadPool.detach_task([this, snapshot]() {
+			saveMap(snapshot);
+		});
+		return;
+	}
+
+	threadPool.detach_task([this, scheduledAt, snapshot, players = std::move(players)]() {
+		if (m_scheduledAt.load() != scheduledAt) {
+			logger.warn("Skipping save for server because another save has been scheduled.");
+			return;
+		}
+		Benchmark bm_saveAll;
+		saveGameState(players);
+		saveMap(snapshot);
+		logger.info("Server saved in {} milliseconds.", bm_saveAll.duration());
+	});
+}
+
+std::vector<std::shared_ptr<Player>> SaveManager::getPlayersToSave(bool staggered) const {
+	std::vector<std::shared_ptr<Player>> players;
+	for (const auto &[_, player] : game.getPlayers()) {
+		// The houses are written in this pass, so are the players holding items that came from or went to them
+		if (!staggered || player->hasMovedHouseItems()) {
+			player->clearMovedHouseItems();
+			players.push_back(player);
+		}
+	}
+	return players;
+}
+
+void SaveManager::saveGameState(const std::vector<std::shared_ptr<Player>> &players) {
+	for (const auto &player : players) {
 		player->loginPosition = player->getPosition();
 		doSavePlayer(player);
 	}
@@ -26,28 +78,40 @@ void SaveManager::saveAll() {
 		saveGuild(guild);
 	}
 
-	saveMap();
 	saveKV();
-	logger.info("Server saved in {} milliseconds.", bm_saveAll.duration());
 }
 
-void SaveManager::scheduleAll() {
-	auto scheduledAt = std::chrono::steady_clock::now();
-	m_scheduledAt = scheduledAt;
+bool SaveManager::isStaggeringPlayerSaves() const {
+	return g_configManager().getNumber(PLAYER_SAVE_INTERVAL, __FUNCTION__) > 0;
+}
 
-	// Disable save async if the config is set to false
-	if (!g_configManager().getBoolean(TOGGLE_SAVE_ASYNC, __FUNCTION__)) {
-		saveAll();
+void SaveManager::saveDuePlayers() {
+	if (!isStaggeringPlayerSaves() || game.getGameState() != GAME_STATE_NORMAL) {
 		return;
 	}
 
-	threadPool.detach_task([this, scheduledAt]() {
-		if (m_scheduledAt.load() != scheduledAt) {
-			logger.warn("Skipping save for server because another save has been scheduled.");
-			return;
+	const auto interval = std::chrono::seconds(g_configManager().getNumber(PLAYER_SAVE_INTERVAL, __FUNCTION__));
+	m_playerSaveScheduler.setLimits(interval, g_configManager().getNumber(PLAYER_SAVE_BUDGET, __FUNCTION__));
+
+	const auto &players = game.getPlayers();
+	std::vector<PlayerSaveScheduler::Candidate> candidates;
+	candidates.reserve(players.size());
+	for (const auto &[_, player] : players) {
+		candidates.push_back({ player->getGUID(), player->getUnsavedChanges() });
+	}
+
+	for (const uint32_t guid : m_playerSaveScheduler.pick(std::move(candidates), std::chrono::steady_clock::now())) {
+		const auto player = game.getPlayerByGUID(guid);
+		if (!player) {
+			continue;
 		}
-		saveAll();
-	});
+		player->loginPosition = player->getPosition();
+		schedulePlayer(player);
+	}
+
+	const auto lag = m_playerSaveScheduler.getLag();
+	g_metrics().setGauge("player_saves_overdue", static_cast<int64_t>(lag.overdue));
+	g_metrics().setGauge("player_save_max_lag_ms", lag.max.count());
 }
 
 void SaveManager::schedulePlayer(std::weak_ptr<Player> playerPtr) {
@@ -96,10 +160,19 @@ bool SaveManager::doSavePlayer(std::shared_ptr<Player> player) {
 		logger.debug("Saving player {}.", player->getName());
 	}
 
+	// Journaled changes up to here are read by this save
+	const uint64_t journalSequence = g_playerJournal().beginSave(player->getGUID());
 	bool saveSuccess = IOLoginData::savePlayer(player);
 	if (!saveSuccess) {
 		logger.error("Failed to save player {}.", player->getName());
 	}
+	g_playerJournal().endSave(player->getGUID(), journalSequence, saveSuccess);
+
+	// Time the player waited past its slot, a save every interval makes this zero
+	const auto lag = m_playerSaveScheduler.onSaved(player->getGUID(), std::chrono::steady_clock::now(), saveSuccess);
+	if (lag > std::chrono::milliseconds::zero()) {
+		g_metrics().recordLatency("player_save_lag", lag);
+	}
 
 	auto duration = bm_savePlayer.duration();
 	logger.debug("Saving player {} took {} milliseconds.", player->getName(), duration);
@@ -128,12 +201,20 @@ void SaveManager::saveGuild(std::shared_ptr<Guild> guild) {
 	logger.debug("Saving guild {} took {} milliseconds.", guild->getName(), duration);
 }
 
-void SaveManager::saveMap() {
+void SaveManager::saveMap(const std::shared_ptr<IOMapSerialize::HouseSnapshot> &snapshot) {
+	std::scoped_lock lock(m_mapSaveLock);
+	if (snapshot->version <= m_mapSavedVersion) {
+		logger.warn("Skipping save for map because a newer snapshot has already been saved.");
+		return;
+	}
+
 	Benchmark bm_saveMap;
 	logger.debug("Saving map...");
-	bool saveSuccess = Map::save();
+	bool saveSuccess = IOMapSerialize::saveHouses(*snapshot);
 	if (!saveSuccess) {
 		logger.error("Failed to save map.");
+	} else {
+		m_mapSavedVersion = snapshot->version;
 	}
 
 	auto duration = bm_saveMap.duration();
@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include "game/scheduling/player_save_scheduler.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "io/iomapserialize.hpp"
 #include "kv/kv.hpp"
 
 class SaveManager {
@@ -23,12 +25,21 @@ public:
 
 	void saveAll();
 	void scheduleAll();
+	// Dispatcher, every second: saves the online players due, see PlayerSaveScheduler
+	void saveDuePlayers();
 
 	bool savePlayer(std::shared_ptr<Player> player);
 	void saveGuild(std::shared_ptr<Guild> guild);
 
 private:
-	void saveMap();
+	/**
+	 * Dispatcher, the online players a server save writes: all of them, or when saveDuePlayers
+	 * staggers their saves, the ones who moved items to or from a house since the last one.
+	 */
+	std::vector<std::shared_ptr<Player>> getPlayersToSave(bool staggered) const;
+	void saveGameState(const std::vector<std::shared_ptr<Player>> &players);
+	bool isStaggeringPlayerSaves() const;
+	void saveMap(const std::shared_ptr<IOMapSerialize::HouseSnapshot> &snapshot);
 	void saveKV();
 
 	void schedulePlayer(std::weak_ptr<Player> player);
@@ -36,6 +47,11 @@ private:
 
 	std::atomic<std::chrono::steady_clock::time_point> m_scheduledAt;
 	phmap::parallel_flat_hash_map<uint32_t, std::chrono::steady_clock::time_point> m_playerMap;
+	PlayerSaveScheduler m_playerSaveScheduler;
+
+	// Serializes house writes and discards snapshots older than the last one written
+	std::mutex m_mapSaveLock;
+	int64_t m_mapSavedVersion = 0;
 
 	ThreadPool &threadPool;
 	KVStore &kv;
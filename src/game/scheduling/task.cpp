@@ -16,8 +16,8 @@
 
 std::atomic_uint_fast64_t Task::LAST_EVENT_ID = 0;
 
-Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context) :
-	func(std::move(f)), context(context), utime(OTSYS_TIME()), expiration(expiresAfterMs > 0 ? OTSYS_TIME() + expiresAfterMs : 0) {
+Task::Task(uint32_t expiresAfterMs, TaskFunction &&f, std::string_view context) :
+	func(std::move(f)), context(context), utime(OTSYS_TIME()), expiration(expiresAfterMs > 0 ? OTSYS_TIME() + expiresAfterMs : 0), dueTime(std::chrono::steady_clock::now()) {
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
 		return;
@@ -26,8 +26,8 @@ Task::Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_v
 	assert(!this->context.empty() && "Context cannot be empty!");
 }
 
-Task::Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
-	func(std::move(f)), context(context), utime(OTSYS_TIME() + delay), delay(delay), cycle(cycle), log(log) {
+Task::Task(TaskFunction &&f, std::string_view context, uint32_t delay, bool cycle /* = false*/, bool log /*= true*/) :
+	func(std::move(f)), context(context), utime(OTSYS_TIME() + delay), dueTime(std::chrono::steady_clock::now() + std::chrono::milliseconds(delay)), delay(delay), cycle(cycle), log(log) {
 	if (this->context.empty()) {
 		g_logger().error("[{}]: task context cannot be empty!", __FUNCTION__);
 		return;
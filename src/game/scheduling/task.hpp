@@ -8,14 +8,15 @@
  */
 
 #pragma once
+#include "task_function.hpp"
 #include "utils/tools.hpp"
 #include <unordered_set>
 
 class Task {
 public:
-	Task(uint32_t expiresAfterMs, std::function<void(void)> &&f, std::string_view context);
+	Task(uint32_t expiresAfterMs, TaskFunction &&f, std::string_view context);
 
-	Task(std::function<void(void)> &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
+	Task(TaskFunction &&f, std::string_view context, uint32_t delay, bool cycle = false, bool log = true);
 
 	~Task() = default;
 
@@ -43,6 +44,11 @@ public:
 		return utime;
 	}
 
+	// When the task was queued, or when it became due if delayed
+	auto getDueTime() const {
+		return dueTime;
+	}
+
 	bool hasExpired() const {
 		return expiration != 0 && expiration < OTSYS_TIME();
 	}
@@ -66,6 +72,7 @@ private:
 
 	void updateTime() {
 		utime = OTSYS_TIME() + delay;
+		dueTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
 	}
 
 	bool hasTraceableContext() const {
@@ -82,10 +89,12 @@ private:
 			"Game::updateCreatureWalk",
 			"Game::updateForgeableMonsters",
 			"GlobalEvents::think",
+			"LuaCoroutineScheduler::resumeDue",
 			"LuaEnvironment::executeTimerEvent",
 			"Modules::executeOnRecvbyte",
 			"OutputMessagePool::sendAll",
 			"ProtocolGame::addGameTask",
+			"ProtocolGame::flushInboundPackets",
 			"ProtocolGame::parsePacketFromDispatcher",
 			"Raids::checkRaids",
 			"SpawnMonster::checkSpawnMonster",
@@ -106,11 +115,13 @@ private:
 		}
 	};
 
-	std::function<void(void)> func = nullptr;
-	std::string context;
+	TaskFunction func = nullptr;
+	// Contexts are string literals or __FUNCTION__, so a view keeps queuing a task free of allocations
+	std::string_view context;
 
 	int64_t utime = 0;
 	int64_t expiration = 0;
+	std::chrono::steady_clock::time_point dueTime;
 
 	uint64_t id = 0;
 	uint32_t delay = 0;
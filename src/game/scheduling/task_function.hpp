@@ -0,0 +1,136 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Move-only void() callable of a dispatcher task. Callables of up to INLINE_SIZE bytes
+ * are kept in place, so queuing a typical lambda (this, a shared_ptr and a few ids)
+ * doesn't allocate; std::function only keeps two pointers inline.
+ * Larger callables, or ones that may throw when moved, are kept on the heap.
+ */
+class TaskFunction {
+public:
+	static constexpr size_t INLINE_SIZE = 56;
+
+	TaskFunction() noexcept = default;
+	TaskFunction(std::nullptr_t) noexcept { }
+
+	template <typename F>
+		requires(!std::is_same_v<std::decay_t<F>, TaskFunction> && std::is_invocable_v<std::decay_t<F> &>)
+	TaskFunction(F &&f) {
+		using Callable = std::decay_t<F>;
+		// Empty std::function and null function pointers stay empty
+		if constexpr (std::is_pointer_v<Callable> || std::is_same_v<Callable, std::function<void(void)>>) {
+			if (!static_cast<bool>(f)) {
+				return;
+			}
+		}
+
+		if constexpr (isInline<Callable>()) {
+			new (storage) Callable(std::forward<F>(f));
+			ops = &inlineOps<Callable>;
+		} else {
+			*reinterpret_cast<Callable**>(storage) = new Callable(std::forward<F>(f));
+			ops = &heapOps<Callable>;
+		}
+	}
+
+	TaskFunction(TaskFunction &&other) noexcept {
+		moveFrom(other);
+	}
+
+	TaskFunction &operator=(TaskFunction &&other) noexcept {
+		if (this != &other) {
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	TaskFunction &operator=(std::nullptr_t) noexcept {
+		reset();
+		return *this;
+	}
+
+	~TaskFunction() {
+		reset();
+	}
+
+	// non-copyable
+	TaskFunction(const TaskFunction &) = delete;
+	TaskFunction &operator=(const TaskFunction &) = delete;
+
+	// Like std::function, a mutable callable can be called through a const reference
+	void operator()() const {
+		ops->invoke(storage);
+	}
+
+	explicit operator bool() const noexcept {
+		return ops != nullptr;
+	}
+
+	friend bool operator==(const TaskFunction &function, std::nullptr_t) noexcept {
+		return !function;
+	}
+
+	// Whether the callable was kept in place rather than allocated
+	bool isInline() const noexcept {
+		return ops && ops->inlined;
+	}
+
+private:
+	struct Operations {
+		void (*invoke)(void* storage);
+		// Moves the callable to the empty storage "to" and destroys it in "from"
+		void (*relocate)(void* from, void* to) noexcept;
+		void (*destroy)(void* storage) noexcept;
+		bool inlined;
+	};
+
+	template <typename Callable>
+	static constexpr bool isInline() {
+		return sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Callable>;
+	}
+
+	template <typename Callable>
+	static constexpr Operations inlineOps {
+		[](void* storage) { (*static_cast<Callable*>(storage))(); },
+		[](void* from, void* to) noexcept {
+			new (to) Callable(std::move(*static_cast<Callable*>(from)));
+			static_cast<Callable*>(from)->~Callable();
+		},
+		[](void* storage) noexcept { static_cast<Callable*>(storage)->~Callable(); },
+		true
+	};
+
+	template <typename Callable>
+	static constexpr Operations heapOps {
+		[](void* storage) { (**static_cast<Callable**>(storage))(); },
+		[](void* from, void* to) noexcept { *static_cast<Callable**>(to) = *static_cast<Callable**>(from); },
+		[](void* storage) noexcept { delete *static_cast<Callable**>(storage); },
+		false
+	};
+
+	void moveFrom(TaskFunction &other) noexcept {
+		if (other.ops) {
+			other.ops->relocate(other.storage, storage);
+			ops = std::exchange(other.ops, nullptr);
+		}
+	}
+
+	void reset() noexcept {
+		if (ops) {
+			std::exchange(ops, nullptr)->destroy(storage);
+		}
+	}
+
+	alignas(std::max_align_t) mutable std::byte storage[INLINE_SIZE];
+	const Operations* ops = nullptr;
+};
@@ -0,0 +1,111 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/task_tracer.hpp"
+
+#include "lib/logging/log_with_spd_log.hpp"
+
+namespace {
+	constexpr int64_t MINUTE_MS = 60 * 1000;
+
+	double toMilliseconds(std::chrono::nanoseconds duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+void TaskTracer::recordTask(std::string_view context, std::chrono::nanoseconds duration, std::chrono::nanoseconds wait, int64_t nowMs) {
+	const int64_t minute = nowMs / MINUTE_MS;
+	if (minute == currentMinute.load(std::memory_order_relaxed) && duration.count() <= admitNanoseconds.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	std::scoped_lock lock(mutex);
+	auto &entry = getMinute(minute);
+	if (entry.minute != minute) {
+		return;
+	}
+
+	auto &slowest = entry.slowest;
+	if (slowest.size() >= SLOWEST_PER_MINUTE && duration <= slowest.back().duration) {
+		return;
+	}
+
+	const auto it = std::ranges::upper_bound(slowest, duration, std::greater<>(), &SlowTask::duration);
+	slowest.insert(it, SlowTask { std::string(context), duration, std::max(wait, std::chrono::nanoseconds::zero()) });
+	if (slowest.size() > SLOWEST_PER_MINUTE) {
+		slowest.pop_back();
+	}
+
+	if (minute == currentMinute.load(std::memory_order_relaxed) && slowest.size() >= SLOWEST_PER_MINUTE) {
+		admitNanoseconds.store(slowest.back().duration.count(), std::memory_order_relaxed);
+	}
+}
+
+void TaskTracer::recordCycle(uint64_t tasks, std::chrono::nanoseconds duration, int64_t nowMs) {
+	std::scoped_lock lock(mutex);
+	auto &entry = getMinute(nowMs / MINUTE_MS);
+	if (entry.minute != nowMs / MINUTE_MS) {
+		return;
+	}
+
+	++entry.cycles;
+	entry.tasks += tasks;
+	entry.maxCycleTasks = std::max(entry.maxCycleTasks, tasks);
+	entry.maxCycleDuration = std::max(entry.maxCycleDuration, duration);
+}
+
+std::vector<TaskTracer::Minute> TaskTracer::getMinutes() const {
+	std::vector<Minute> result;
+	{
+		std::scoped_lock lock(mutex);
+		for (const auto &entry : minutes) {
+			if (entry.minute >= 0) {
+				result.push_back(entry);
+			}
+		}
+	}
+
+	std::ranges::sort(result, std::greater<>(), &Minute::minute);
+	return result;
+}
+
+void TaskTracer::dump(size_t count) const {
+	const auto recorded = getMinutes();
+	if (recorded.empty()) {
+		g_logger().info("[TaskTracer] No dispatcher tasks recorded yet");
+		return;
+	}
+
+	const int64_t newest = recorded.front().minute;
+	for (const auto &entry : recorded | std::views::take(count)) {
+		g_logger().info(
+			"[TaskTracer] {} minute(s) ago: {} cycles, {:.1f} tasks per cycle, {} tasks and {:.2f} ms in the longest cycles",
+			newest - entry.minute, entry.cycles, static_cast<double>(entry.tasks) / std::max<uint64_t>(1, entry.cycles),
+			entry.maxCycleTasks, toMilliseconds(entry.maxCycleDuration)
+		);
+		for (const auto &task : entry.slowest) {
+			g_logger().info("[TaskTracer]   {}: {:.2f} ms, waited {:.2f} ms", task.context, toMilliseconds(task.duration), toMilliseconds(task.wait));
+		}
+	}
+}
+
+TaskTracer::Minute &TaskTracer::getMinute(int64_t minute) {
+	auto &entry = minutes[static_cast<size_t>(minute) % MINUTES];
+	if (entry.minute < minute) {
+		entry = Minute { minute };
+	}
+
+	if (minute > currentMinute.load(std::memory_order_relaxed)) {
+		currentMinute.store(minute, std::memory_order_relaxed);
+		admitNanoseconds.store(0, std::memory_order_relaxed);
+	}
+	return entry;
+}
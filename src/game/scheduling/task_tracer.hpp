@@ -0,0 +1,66 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Keeps the slowest dispatcher tasks of each of the last minutes, with how long they waited
+ * in the queue, and the task counts of the dispatcher cycles, so an overrun tick can be
+ * traced back to the task contexts that caused it.
+ *
+ * Tasks faster than the slowest ones already kept for the current minute are rejected
+ * without taking the lock, so recording is cheap for almost every task.
+ */
+class TaskTracer {
+public:
+	static constexpr size_t SLOWEST_PER_MINUTE = 10;
+	static constexpr size_t MINUTES = 10;
+
+	struct SlowTask {
+		std::string context;
+		std::chrono::nanoseconds duration { 0 };
+		std::chrono::nanoseconds wait { 0 };
+	};
+
+	struct Minute {
+		int64_t minute = -1;
+		uint64_t cycles = 0;
+		uint64_t tasks = 0;
+		uint64_t maxCycleTasks = 0;
+		std::chrono::nanoseconds maxCycleDuration { 0 };
+		// Slowest first
+		std::vector<SlowTask> slowest;
+	};
+
+	TaskTracer() = default;
+
+	// non-copyable
+	TaskTracer(const TaskTracer &) = delete;
+	TaskTracer &operator=(const TaskTracer &) = delete;
+
+	// Thread-safe, parallel tasks are recorded from the thread pool
+	void recordTask(std::string_view context, std::chrono::nanoseconds duration, std::chrono::nanoseconds wait, int64_t nowMs);
+	void recordCycle(uint64_t tasks, std::chrono::nanoseconds duration, int64_t nowMs);
+
+	// The minutes with anything recorded, most recent first
+	std::vector<Minute> getMinutes() const;
+
+	// Logs the kept minutes, most recent first
+	void dump(size_t minutes) const;
+
+private:
+	// mutex must be held
+	Minute &getMinute(int64_t minute);
+
+	mutable std::mutex mutex;
+	std::array<Minute, MINUTES> minutes;
+	std::atomic<int64_t> currentMinute = -1;
+	// Duration a task needs to enter the current minute, 0 while it isn't full
+	std::atomic<int64_t> admitNanoseconds = 0;
+};
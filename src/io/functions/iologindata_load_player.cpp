@@ -20,13 +20,18 @@
 
 void IOLoginDataLoad::loadItems(ItemsMap &itemsMap, DBResult_ptr result, const std::shared_ptr<Player> &player) {
 	try {
+		const size_t sidColumn = result->getColumnIndex("sid");
+		const size_t pidColumn = result->getColumnIndex("pid");
+		const size_t typeColumn = result->getColumnIndex("itemtype");
+		const size_t countColumn = result->getColumnIndex("count");
+		const size_t attributesColumn = result->getColumnIndex("attributes");
 		do {
-			uint32_t sid = result->getNumber<uint32_t>("sid");
-			uint32_t pid = result->getNumber<uint32_t>("pid");
-			uint16_t type = result->getNumber<uint16_t>("itemtype");
-			uint16_t count = result->getNumber<uint16_t>("count");
+			uint32_t sid = result->getNumber<uint32_t>(sidColumn);
+			uint32_t pid = result->getNumber<uint32_t>(pidColumn);
+			uint16_t type = result->getNumber<uint16_t>(typeColumn);
+			uint16_t count = result->getNumber<uint16_t>(countColumn);
 			unsigned long attrSize;
-			const char* attr = result->getStream("attributes", attrSize);
+			const char* attr = result->getStream(attributesColumn, attrSize);
 			PropStream propStream;
 			propStream.init(attr, attrSize);
 
@@ -764,25 +764,34 @@ bool IOLoginDataSave::savePlayerBosstiary(std::shared_ptr<Player> player) {
 	return true;
 }
 
-bool IOLoginDataSave::savePlayerStorage(std::shared_ptr<Player> player) {
+bool IOLoginDataSave::savePlayerStorage(std::shared_ptr<Player> player, uint64_t &savedSequence) {
 	if (!player) {
 		g_logger().warn("[IOLoginData::savePlayer] - Player nullptr: {}", __FUNCTION__);
 		return false;
 	}
 
+	player->genReservedStorageRange();
+
+	// Only the keys changed since the last committed save are written, see PlayerStorage
+	const auto changes = player->storage.getChanges();
+	savedSequence = changes.sequence;
+
 	Database &db = Database::getInstance();
-	std::ostringstream query;
-	query << "DELETE FROM `player_storage` WHERE `player_id` = " << player->getGUID();
-	if (!db.executeQuery(query.str())) {
-		return false;
+	if (!changes.erased.empty()) {
+		std::string query = fmt::format("DELETE FROM `player_storage` WHERE `player_id` = {} AND `key` IN ({})", player->getGUID(), fmt::join(changes.erased.begin(), changes.erased.end(), ","));
+		if (!db.executeQuery(query)) {
+			return false;
+		}
 	}
 
-	query.str("");
+	if (changes.updated.empty()) {
+		return true;
+	}
 
+	std::ostringstream query;
 	DBInsert storageQuery("INSERT INTO `player_storage` (`player_id`, `key`, `value`) VALUES ");
-	player->genReservedStorageRange();
-
-	for (const auto &[key, value] : player->storageMap) {
+	storageQuery.upsert({ "value" });
+	for (const auto &[key, value] : changes.updated) {
 		query << player->getGUID() << ',' << key << ',' << value;
 		if (!storageQuery.addRow(query)) {
 			return false;
@@ -26,7 +26,7 @@ public:
 	static bool savePlayerTaskHuntingClass(std::shared_ptr<Player> player);
 	static bool savePlayerForgeHistory(std::shared_ptr<Player> player);
 	static bool savePlayerBosstiary(std::shared_ptr<Player> player);
-	static bool savePlayerStorage(std::shared_ptr<Player> player);
+	static bool savePlayerStorage(std::shared_ptr<Player> player, uint64_t &savedSequence);
 
 protected:
 	using ItemBlockList = std::list<std::pair<int32_t, std::shared_ptr<Item>>>;
@@ -175,6 +175,9 @@ bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result
 		// Load instant spells list
 		IOLoginDataLoad::loadPlayerInstantSpellList(player, result);
 
+		// What the database holds, nothing to save yet
+		player->markSaved(player->getSaveMark());
+
 		if (disableIrrelevantInfo) {
 			return true;
 		}
@@ -199,22 +202,30 @@ bool IOLoginData::loadPlayer(std::shared_ptr<Player> player, DBResult_ptr result
 }
 
 bool IOLoginData::savePlayer(std::shared_ptr<Player> player) {
-	bool success = DBTransaction::executeWithinTransaction([player]() {
-		return savePlayerGuard(player);
+	uint64_t storageSequence = 0;
+	Player::SaveMark saveMark;
+	bool success = DBTransaction::executeWithinTransaction([player, &storageSequence, &saveMark]() {
+		return savePlayerGuard(player, storageSequence, saveMark);
 	});
 
 	if (!success) {
 		g_logger().error("[{}] Error occurred saving player", __FUNCTION__);
+	} else {
+		// The storage changes are only forgotten once committed, a failed save writes them again next time
+		player->storage.markSaved(storageSequence);
+		player->markSaved(saveMark);
 	}
 
 	return success;
 }
 
-bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player) {
+bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player, uint64_t &storageSequence, Player::SaveMark &saveMark) {
 	if (!player) {
 		throw DatabaseException("Player nullptr in function: " + std::string(__FUNCTION__));
 	}
 
+	saveMark = player->getSaveMark();
+
 	if (!IOLoginDataSave::savePlayerFirst(player)) {
 		throw DatabaseException("[" + std::string(__FUNCTION__) + "] - Failed to save player first: " + player->getName());
 	}
@@ -271,7 +282,7 @@ bool IOLoginData::savePlayerGuard(std::shared_ptr<Player> player) {
 		throw DatabaseException("[PlayerWheel::saveDBPlayerSlotPointsOnLogout] - Failed to save player wheel info: " + player->getName());
 	}
 
-	if (!IOLoginDataSave::savePlayerStorage(player)) {
+	if (!IOLoginDataSave::savePlayerStorage(player, storageSequence)) {
 		throw DatabaseException("[IOLoginDataSave::savePlayerStorage] - Failed to save player storage: " + player->getName());
 	}
 
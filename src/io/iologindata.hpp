@@ -44,5 +44,5 @@ public:
 	static void removeGuidVIPGroupEntry(uint32_t accountId, uint32_t guid);
 
 private:
-	static bool savePlayerGuard(std::shared_ptr<Player> player);
+	static bool savePlayerGuard(std::shared_ptr<Player> player, uint64_t &storageSequence, Player::SaveMark &saveMark);
 };
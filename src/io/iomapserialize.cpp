@@ -22,9 +22,10 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 		return;
 	}
 
+	const size_t dataColumn = result->getColumnIndex("data");
 	do {
 		unsigned long attrSize;
-		const char* attr = result->getStream("data", attrSize);
+		const char* attr = result->getStream(dataColumn, attrSize);
 
 		PropStream propStream;
 		propStream.init(attr, attrSize);
@@ -62,9 +63,9 @@ void IOMapSerialize::loadHouseItems(Map* map) {
 	g_logger().info("Loaded house items in {} milliseconds", bm_context.duration());
 }
 
-bool IOMapSerialize::saveHouseItems() {
-	bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseItemsGuard();
+bool IOMapSerialize::saveHouseItems(const HouseSnapshot &snapshot) {
+	bool success = DBTransaction::executeWithinTransaction([&snapshot]() {
+		return SaveHouseItemsGuard(snapshot);
 	});
 
 	if (!success) {
@@ -74,7 +75,7 @@ bool IOMapSerialize::saveHouseItems() {
 	return success;
 }
 
-bool IOMapSerialize::SaveHouseItemsGuard() {
+bool IOMapSerialize::SaveHouseItemsGuard(const HouseSnapshot &snapshot) {
 	Database &db = Database::getInstance();
 	std::ostringstream query;
 
@@ -84,22 +85,10 @@ bool IOMapSerialize::SaveHouseItemsGuard() {
 	}
 
 	DBInsert stmt("INSERT INTO `tile_store` (`house_id`, `data`) VALUES ");
-
-	PropWriteStream stream;
-	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
-		// save house items
-		for (const auto &tile : house->getTiles()) {
-			saveTile(stream, tile);
-
-			size_t attributesSize;
-			const char* attributes = stream.getStream(attributesSize);
-			if (attributesSize > 0) {
-				query << house->getId() << ',' << db.escapeBlob(attributes, attributesSize);
-				if (!stmt.addRow(query)) {
-					return false;
-				}
-				stream.clear();
-			}
+	for (const auto &[houseId, data] : snapshot.tileItems) {
+		query << houseId << ',' << db.escapeBlob(data.data(), data.size());
+		if (!stmt.addRow(query)) {
+			return false;
 		}
 	}
 
@@ -315,9 +304,76 @@ bool IOMapSerialize::loadHouseInfo() {
 	return true;
 }
 
-bool IOMapSerialize::saveHouseInfo() {
-	bool success = DBTransaction::executeWithinTransaction([]() {
-		return SaveHouseInfoGuard();
+std::shared_ptr<IOMapSerialize::HouseSnapshot> IOMapSerialize::snapshotHouses() {
+	Benchmark bm_snapshot;
+	Database &db = Database::getInstance();
+
+	auto snapshot = std::make_shared<HouseSnapshot>();
+	snapshot->version = getTimeUsNow();
+	snapshot->ownerChanges = g_game().map.houses.getOwnerChanges();
+
+	PropWriteStream stream;
+	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
+		snapshot->houseRows.emplace_back(fmt::format("{},{},{},{},{},{},{},{},{}", house->getId(), house->getOwner(), house->getPaidUntil(), house->getPayRentWarnings(), db.escapeString(house->getName()), house->getTownId(), house->getRent(), house->getSize(), house->getBedCount()));
+
+		std::string listText;
+		if (house->getAccessList(GUEST_LIST, listText) && !listText.empty()) {
+			snapshot->accessListRows.emplace_back(fmt::format("{},{},{},{}", house->getId(), GUEST_LIST, db.escapeString(listText), snapshot->version));
+			listText.clear();
+		}
+
+		if (house->getAccessList(SUBOWNER_LIST, listText) && !listText.empty()) {
+			snapshot->accessListRows.emplace_back(fmt::format("{},{},{},{}", house->getId(), SUBOWNER_LIST, db.escapeString(listText), snapshot->version));
+			listText.clear();
+		}
+
+		for (std::shared_ptr<Door> door : house->getDoors()) {
+			if (door->getAccessList(listText) && !listText.empty()) {
+				snapshot->accessListRows.emplace_back(fmt::format("{},{},{},{}", house->getId(), door->getDoorId(), db.escapeString(listText), snapshot->version));
+				listText.clear();
+			}
+		}
+
+		// save house items
+		for (const auto &tile : house->getTiles()) {
+			saveTile(stream, tile);
+
+			size_t attributesSize;
+			const char* attributes = stream.getStream(attributesSize);
+			if (attributesSize > 0) {
+				snapshot->tileItems.emplace_back(house->getId(), std::string(attributes, attributesSize));
+				stream.clear();
+			}
+		}
+	}
+
+	g_logger().debug("Snapshot of {} houses and {} house tiles taken in {} milliseconds", snapshot->houseRows.size(), snapshot->tileItems.size(), bm_snapshot.duration());
+	return snapshot;
+}
+
+bool IOMapSerialize::saveHouses(const HouseSnapshot &snapshot) {
+	Benchmark bm_houses;
+	bool savedInfo = false;
+	double infoDuration = 0;
+	for (uint32_t tries = 0; tries < 6; tries++) {
+		if (!savedInfo) {
+			Benchmark bm_info;
+			savedInfo = saveHouseInfo(snapshot);
+			infoDuration = bm_info.duration();
+		}
+
+		Benchmark bm_items;
+		if (savedInfo && saveHouseItems(snapshot)) {
+			g_logger().debug("Houses written in {} milliseconds (info {} ms, items {} ms)", bm_houses.duration(), infoDuration, bm_items.duration());
+			return true;
+		}
+	}
+	return false;
+}
+
+bool IOMapSerialize::saveHouseInfo(const HouseSnapshot &snapshot) {
+	bool success = DBTransaction::executeWithinTransaction([&snapshot]() {
+		return SaveHouseInfoGuard(snapshot);
 	});
 
 	if (!success) {
@@ -327,17 +383,22 @@ bool IOMapSerialize::saveHouseInfo() {
 	return success;
 }
 
-bool IOMapSerialize::SaveHouseInfoGuard() {
+bool IOMapSerialize::SaveHouseInfoGuard(const HouseSnapshot &snapshot) {
 	Database &db = Database::getInstance();
 
-	std::ostringstream query;
-	DBInsert houseUpdate("INSERT INTO `houses` (`id`, `owner`, `paid`, `warnings`, `name`, `town_id`, `rent`, `size`, `beds`) VALUES ");
-	houseUpdate.upsert({ "owner", "paid", "warnings", "name", "town_id", "rent", "size", "beds" });
+	const auto &houses = g_game().map.houses;
+	// An owner changed since the snapshot and wrote itself to the database, the stale owners
+	// and rents are left to the next save
+	const bool writeOwners = houses.getOwnerChanges() == snapshot.ownerChanges;
 
-	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
-		std::string values = fmt::format("{},{},{},{},{},{},{},{},{}", house->getId(), house->getOwner(), house->getPaidUntil(), house->getPayRentWarnings(), db.escapeString(house->getName()), house->getTownId(), house->getRent(), house->getSize(), house->getBedCount());
-
-		if (!houseUpdate.addRow(values)) {
+	DBInsert houseUpdate("INSERT INTO `houses` (`id`, `owner`, `paid`, `warnings`, `name`, `town_id`, `rent`, `size`, `beds`) VALUES ");
+	if (writeOwners) {
+		houseUpdate.upsert({ "owner", "paid", "warnings", "name", "town_id", "rent", "size", "beds" });
+	} else {
+		houseUpdate.upsert({ "name", "town_id", "rent", "size", "beds" });
+	}
+	for (const auto &row : snapshot.houseRows) {
+		if (!houseUpdate.addRow(row)) {
 			return false;
 		}
 	}
@@ -346,39 +407,17 @@ bool IOMapSerialize::SaveHouseInfoGuard() {
 		return false;
 	}
 
+	// Changed while writing: rolled back and retried without the owners. A change after this
+	// check waits on the rows locked by this transaction, so it lands after the commit.
+	if (writeOwners && houses.getOwnerChanges() != snapshot.ownerChanges) {
+		return false;
+	}
+
 	DBInsert listUpdate("INSERT INTO `house_lists` (`house_id` , `listid` , `list`, `version`) VALUES ");
 	listUpdate.upsert({ "list", "version" });
-	auto version = getTimeUsNow();
-
-	for (const auto &[key, house] : g_game().map.houses.getHouses()) {
-		std::string listText;
-		if (house->getAccessList(GUEST_LIST, listText) && !listText.empty()) {
-			query << house->getId() << ',' << GUEST_LIST << ',' << db.escapeString(listText) << ',' << version;
-			if (!listUpdate.addRow(query)) {
-				return false;
-			}
-
-			listText.clear();
-		}
-
-		if (house->getAccessList(SUBOWNER_LIST, listText) && !listText.empty()) {
-			query << house->getId() << ',' << SUBOWNER_LIST << ',' << db.escapeString(listText) << ',' << version;
-			if (!listUpdate.addRow(query)) {
-				return false;
-			}
-
-			listText.clear();
-		}
-
-		for (std::shared_ptr<Door> door : house->getDoors()) {
-			if (door->getAccessList(listText) && !listText.empty()) {
-				query << house->getId() << ',' << door->getDoorId() << ',' << db.escapeString(listText) << ',' << version;
-				if (!listUpdate.addRow(query)) {
-					return false;
-				}
-
-				listText.clear();
-			}
+	for (const auto &row : snapshot.accessListRows) {
+		if (!listUpdate.addRow(row)) {
+			return false;
 		}
 	}
 
@@ -386,7 +425,7 @@ bool IOMapSerialize::SaveHouseInfoGuard() {
 		return false;
 	}
 
-	if (!db.executeQuery(fmt::format("DELETE FROM `house_lists` WHERE `version` < {}", version))) {
+	if (!db.executeQuery(fmt::format("DELETE FROM `house_lists` WHERE `version` < {}", snapshot.version))) {
 		return false;
 	}
 
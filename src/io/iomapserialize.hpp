@@ -13,14 +13,40 @@
 
 class IOMapSerialize {
 public:
+	/**
+	 * Copy of everything the house save writes, taken on the dispatcher so the
+	 * database work can run on another thread without touching live game objects.
+	 */
+	struct HouseSnapshot {
+		// Formatted rows of the `houses` and `house_lists` tables
+		std::vector<std::string> houseRows;
+		std::vector<std::string> accessListRows;
+		// House id and raw serialized items of each house tile
+		std::vector<std::pair<uint32_t, std::string>> tileItems;
+		int64_t version = 0;
+		// Houses::getOwnerChanges when taken, the owners and rents are only written while it matches
+		uint64_t ownerChanges = 0;
+	};
+
 	static void loadHouseItems(Map* map);
-	static bool saveHouseItems();
 	static bool loadHouseInfo();
-	static bool saveHouseInfo();
+
+	/**
+	 * Serializes the houses, their access lists and their items.
+	 * Must run on the dispatcher thread.
+	 */
+	static std::shared_ptr<HouseSnapshot> snapshotHouses();
+	/**
+	 * Writes a snapshot to the database, retrying on failure.
+	 * Safe to call from any thread.
+	 */
+	static bool saveHouses(const HouseSnapshot &snapshot);
 
 private:
-	static bool SaveHouseInfoGuard();
-	static bool SaveHouseItemsGuard();
+	static bool saveHouseInfo(const HouseSnapshot &snapshot);
+	static bool saveHouseItems(const HouseSnapshot &snapshot);
+	static bool SaveHouseInfoGuard(const HouseSnapshot &snapshot);
+	static bool SaveHouseItemsGuard(const HouseSnapshot &snapshot);
 	static void saveItem(PropWriteStream &stream, std::shared_ptr<Item> item);
 	static void saveTile(PropWriteStream &stream, std::shared_ptr<Tile> tile);
 
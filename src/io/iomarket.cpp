@@ -43,19 +43,27 @@ MarketOfferList IOMarket::getActiveOffers(MarketAction_t action) {
 
 	const int32_t marketOfferDuration = g_configManager().getNumber(MARKET_OFFER_DURATION, __FUNCTION__);
 
+	const size_t idColumn = result->getColumnIndex("id");
+	const size_t itemTypeColumn = result->getColumnIndex("itemtype");
+	const size_t amountColumn = result->getColumnIndex("amount");
+	const size_t priceColumn = result->getColumnIndex("price");
+	const size_t tierColumn = result->getColumnIndex("tier");
+	const size_t createdColumn = result->getColumnIndex("created");
+	const size_t anonymousColumn = result->getColumnIndex("anonymous");
+	const size_t playerNameColumn = result->getColumnIndex("player_name");
 	do {
 		MarketOffer offer;
-		offer.itemId = result->getNumber<uint16_t>("itemtype");
-		offer.amount = result->getNumber<uint16_t>("amount");
-		offer.price = result->getNumber<uint64_t>("price");
-		offer.timestamp = result->getNumber<uint32_t>("created") + marketOfferDuration;
-		offer.counter = result->getNumber<uint32_t>("id") & 0xFFFF;
-		if (result->getNumber<uint16_t>("anonymous") == 0) {
-			offer.playerName = result->getString("player_name");
+		offer.itemId = result->getNumber<uint16_t>(itemTypeColumn);
+		offer.amount = result->getNumber<uint16_t>(amountColumn);
+		offer.price = result->getNumber<uint64_t>(priceColumn);
+		offer.timestamp = result->getNumber<uint32_t>(createdColumn) + marketOfferDuration;
+		offer.counter = result->getNumber<uint32_t>(idColumn) & 0xFFFF;
+		if (result->getNumber<uint16_t>(anonymousColumn) == 0) {
+			offer.playerName = result->getString(playerNameColumn);
 		} else {
 			offer.playerName = "Anonymous";
 		}
-		offer.tier = getTierFromDatabaseTable(result->getString("tier"));
+		offer.tier = getTierFromDatabaseTable(result->getString(tierColumn));
 		offerList.push_back(offer);
 	} while (result->next());
 	return offerList;
@@ -11,59 +11,70 @@
 
 #include "items/functions/item/attribute.hpp"
 
-/*
-=============================
-* ItemAttribute class (Attributes methods)
-=============================
-*/
-const std::string &ItemAttribute::getAttributeString(ItemAttribute_t type) const {
-	static std::string emptyString;
-	if (!isAttributeString(type)) {
-		return emptyString;
+ItemAttribute::ItemAttribute(const ItemAttribute &other) :
+	attributeBits(other.attributeBits), integerValues(other.integerValues) {
+	if (other.coldStorage) {
+		coldStorage = std::make_unique<ColdStorage>(*other.coldStorage);
 	}
+}
 
-	auto attribute = getAttribute(type);
-	if (!attribute) {
-		return emptyString;
+ItemAttribute &ItemAttribute::operator=(const ItemAttribute &other) {
+	if (this != &other) {
+		attributeBits = other.attributeBits;
+		integerValues = other.integerValues;
+		coldStorage = other.coldStorage ? std::make_unique<ColdStorage>(*other.coldStorage) : nullptr;
 	}
+	return *this;
+}
 
-	return *attribute->getString().get();
+ItemAttribute::ColdStorage &ItemAttribute::initColdStorage() {
+	if (!coldStorage) {
+		coldStorage = std::make_unique<ColdStorage>();
+	}
+	return *coldStorage;
 }
 
-const int64_t &ItemAttribute::getAttributeValue(ItemAttribute_t type) const {
-	static int64_t emptyInt;
-	if (!isAttributeInteger(type)) {
-		return emptyInt;
+size_t ItemAttribute::getDynamicMemoryUsage() const {
+	size_t bytes = 0;
+	if (integerValues.capacity() > INLINE_INTEGER_SLOTS) {
+		bytes += integerValues.capacity() * sizeof(int64_t);
 	}
 
-	auto attribute = getAttribute(type);
-	if (!attribute) {
-		return emptyInt;
+	if (!coldStorage) {
+		return bytes;
 	}
 
-	return attribute->getInteger();
+	bytes += sizeof(ColdStorage) + coldStorage->strings.capacity() * sizeof(std::shared_ptr<std::string>);
+	for (const auto &string : coldStorage->strings) {
+		// make_shared control block plus the string buffer when it doesn't fit the small string optimization
+		bytes += sizeof(std::string) + 2 * sizeof(void*) + (string->capacity() > 15 ? string->capacity() + 1 : 0);
+	}
+	// Red-black tree node overhead (three pointers and a color) per custom attribute
+	bytes += coldStorage->customAttributeMap.size() * (sizeof(std::pair<const std::string, CustomAttribute>) + 4 * sizeof(void*));
+	return bytes;
 }
 
-const Attributes* ItemAttribute::getAttribute(ItemAttribute_t type) const {
-	if (hasAttribute(type)) {
-		for (const Attributes &attribute : attributeVector) {
-			if (attribute.getAttributeType() == type) {
-				return &attribute;
-			}
-		}
+/*
+=============================
+* ItemAttribute class (Attributes methods)
+=============================
+*/
+const std::string &ItemAttribute::getAttributeString(ItemAttribute_t type) const {
+	static std::string emptyString;
+	if (!isAttributeString(type) || !hasAttribute(type)) {
+		return emptyString;
 	}
-	return nullptr;
+
+	return *coldStorage->strings[getSlot(stringAttributeBits, type)];
 }
 
-Attributes &ItemAttribute::getAttributesByType(ItemAttribute_t type) {
-	for (Attributes &attribute : attributeVector) {
-		if (attribute.getAttributeType() == type) {
-			return attribute;
-		}
+const int64_t &ItemAttribute::getAttributeValue(ItemAttribute_t type) const {
+	static int64_t emptyInt;
+	if (!isAttributeInteger(type) || !hasAttribute(type)) {
+		return emptyInt;
 	}
 
-	attributeVector.emplace_back(type);
-	return attributeVector.back();
+	return integerValues[getSlot(integerAttributeBits, type)];
 }
 
 void ItemAttribute::setAttribute(ItemAttribute_t type, int64_t value) {
@@ -71,7 +82,14 @@ void ItemAttribute::setAttribute(ItemAttribute_t type, int64_t value) {
 		return;
 	}
 
-	getAttributesByType(type).setValue(value);
+	const size_t slot = getSlot(integerAttributeBits, type);
+	if (hasAttribute(type)) {
+		integerValues[slot] = value;
+		return;
+	}
+
+	integerValues.insert(integerValues.begin() + slot, value);
+	attributeBits |= getAttributeBit(type);
 }
 
 void ItemAttribute::setAttribute(ItemAttribute_t type, const std::string &value) {
@@ -83,18 +101,32 @@ void ItemAttribute::setAttribute(ItemAttribute_t type, const std::string &value)
 		return;
 	}
 
-	getAttributesByType(type).setValue(value);
+	auto &strings = initColdStorage().strings;
+	const size_t slot = getSlot(stringAttributeBits, type);
+	// Strings are shared between copies of an item, so a new value always gets a new string
+	auto newValue = std::make_shared<std::string>(value);
+	if (hasAttribute(type)) {
+		strings[slot] = std::move(newValue);
+		return;
+	}
+
+	strings.insert(strings.begin() + slot, std::move(newValue));
+	attributeBits |= getAttributeBit(type);
 }
 
 bool ItemAttribute::removeAttribute(ItemAttribute_t type) {
-	for (auto it = attributeVector.begin(); it != attributeVector.end(); ++it) {
-		if (it->getAttributeType() == type) {
-			*it = std::move(attributeVector.back());
-			attributeVector.pop_back();
-			return true;
-		}
+	if (!hasAttribute(type)) {
+		return false;
 	}
-	return false;
+
+	if (isAttributeInteger(type)) {
+		integerValues.erase(integerValues.begin() + getSlot(integerAttributeBits, type));
+	} else if (isAttributeString(type)) {
+		auto &strings = coldStorage->strings;
+		strings.erase(strings.begin() + getSlot(stringAttributeBits, type));
+	}
+	attributeBits &= ~getAttributeBit(type);
+	return true;
 }
 
 /*
@@ -103,7 +135,11 @@ bool ItemAttribute::removeAttribute(ItemAttribute_t type) {
 =============================
 */
 const std::map<std::string, CustomAttribute, std::less<>> &ItemAttribute::getCustomAttributeMap() const {
-	return customAttributeMap;
+	static const std::map<std::string, CustomAttribute, std::less<>> emptyMap;
+	if (!coldStorage) {
+		return emptyMap;
+	}
+	return coldStorage->customAttributeMap;
 }
 
 /*
@@ -112,42 +148,51 @@ const std::map<std::string, CustomAttribute, std::less<>> &ItemAttribute::getCus
 =============================
 */
 const CustomAttribute* ItemAttribute::getCustomAttribute(const std::string &attributeName) const {
-	if (customAttributeMap.contains(asLowerCaseString(attributeName))) {
-		return &customAttributeMap.at(asLowerCaseString(attributeName));
+	if (!coldStorage) {
+		return nullptr;
+	}
+
+	auto it = coldStorage->customAttributeMap.find(asLowerCaseString(attributeName));
+	if (it == coldStorage->customAttributeMap.end()) {
+		return nullptr;
 	}
-	return nullptr;
+	return &it->second;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const int64_t value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	initColdStorage().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const std::string &value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	initColdStorage().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const double value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	initColdStorage().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::setCustomAttribute(const std::string &key, const bool value) {
 	CustomAttribute attribute(key, value);
-	customAttributeMap[asLowerCaseString(key)] = attribute;
+	initColdStorage().customAttributeMap[asLowerCaseString(key)] = attribute;
 }
 
 void ItemAttribute::addCustomAttribute(const std::string &key, const CustomAttribute &customAttribute) {
-	customAttributeMap[asLowerCaseString(key)] = customAttribute;
+	initColdStorage().customAttributeMap[asLowerCaseString(key)] = customAttribute;
 }
 
 bool ItemAttribute::removeCustomAttribute(const std::string &attributeName) {
-	auto it = customAttributeMap.find(asLowerCaseString(attributeName));
-	if (it == customAttributeMap.end()) {
+	if (!coldStorage) {
+		return false;
+	}
+
+	auto it = coldStorage->customAttributeMap.find(asLowerCaseString(attributeName));
+	if (it == coldStorage->customAttributeMap.end()) {
 		return false;
 	}
 
-	customAttributeMap.erase(it);
+	coldStorage->customAttributeMap.erase(it);
 	return true;
 }
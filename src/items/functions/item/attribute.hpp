@@ -15,7 +15,7 @@
 
 class ItemAttributeHelper {
 public:
-	bool isAttributeInteger(ItemAttribute_t type) const {
+	constexpr bool isAttributeInteger(ItemAttribute_t type) const {
 		switch (type) {
 			case ItemAttribute_t::STORE:
 			case ItemAttribute_t::ACTIONID:
@@ -48,7 +48,7 @@ public:
 		}
 	}
 
-	bool isAttributeString(ItemAttribute_t type) const {
+	constexpr bool isAttributeString(ItemAttribute_t type) const {
 		switch (type) {
 			case ItemAttribute_t::DESCRIPTION:
 			case ItemAttribute_t::TEXT:
@@ -64,74 +64,39 @@ public:
 				return false;
 		}
 	}
-};
-
-class Attributes : public ItemAttributeHelper {
-public:
-	explicit Attributes(ItemAttribute_t type) :
-		type(type), value(getDefaultValueForType(type)) { }
-	~Attributes() = default;
-
-	Attributes(const Attributes &i) :
-		type(i.type), value(i.value) { }
-	Attributes(Attributes &&attribute) noexcept :
-		type(attribute.type), value(std::move(attribute.value)) { }
-
-	Attributes &operator=(Attributes &&other) noexcept {
-		type = other.type;
-		value = std::move(other.value);
-		return *this;
-	}
-
-	const ItemAttribute_t &getAttributeType() const {
-		return type;
-	}
-
-	std::variant<int64_t, std::shared_ptr<std::string>> getDefaultValueForType(ItemAttribute_t attributeType) const {
-		ItemAttributeHelper helper;
-		if (helper.isAttributeInteger(attributeType)) {
-			return 0;
-		} else if (helper.isAttributeString(attributeType)) {
-			return std::make_shared<std::string>();
-		} else {
-			return {};
-		}
-	}
 
-	void setValue(int64_t newValue) {
-		if (std::holds_alternative<int64_t>(value)) {
-			value = newValue;
-		}
-	}
-	void setValue(const std::string &newValue) {
-		if (std::holds_alternative<std::shared_ptr<std::string>>(value)) {
-			value = std::make_shared<std::string>(newValue);
-		}
-	}
-	const int64_t &getInteger() const {
-		if (std::holds_alternative<int64_t>(value)) {
-			return std::get<int64_t>(value);
-		}
-		static int64_t emptyValue;
-		return emptyValue;
+	static constexpr uint64_t getAttributeBit(ItemAttribute_t type) {
+		return type < 64 ? (uint64_t { 1 } << type) : 0;
 	}
 
-	const std::shared_ptr<std::string> getString() const {
-		if (std::holds_alternative<std::shared_ptr<std::string>>(value)) {
-			return std::get<std::shared_ptr<std::string>>(value);
+	// Mask of every integer (or string) attribute type
+	static constexpr uint64_t getAttributeKindBits(bool integer) {
+		uint64_t bits = 0;
+		for (uint64_t type = 0; type < 64; ++type) {
+			const auto attribute = static_cast<ItemAttribute_t>(type);
+			if (integer ? ItemAttributeHelper().isAttributeInteger(attribute) : ItemAttributeHelper().isAttributeString(attribute)) {
+				bits |= getAttributeBit(attribute);
+			}
 		}
-		static std::shared_ptr<std::string> emptyPtr;
-		return emptyPtr;
+		return bits;
 	}
-
-private:
-	ItemAttribute_t type;
-	std::variant<int64_t, std::shared_ptr<std::string>> value;
 };
 
+/**
+ * Attributes are stored compactly: a bitmask tells which attributes are present, integer values are packed
+ * in type order inside a small inline buffer (the slot of an attribute is the number of present integer
+ * attributes with a lower type), and strings and custom attributes, which few items have, live in a separately
+ * allocated cold storage.
+ */
 class ItemAttribute : public ItemAttributeHelper {
 public:
 	ItemAttribute() = default;
+	~ItemAttribute() = default;
+
+	ItemAttribute(const ItemAttribute &other);
+	ItemAttribute &operator=(const ItemAttribute &other);
+	ItemAttribute(ItemAttribute &&other) noexcept = default;
+	ItemAttribute &operator=(ItemAttribute &&other) noexcept = default;
 
 	// CustomAttribute map methods
 	const std::map<std::string, CustomAttribute, std::less<>> &getCustomAttributeMap() const;
@@ -153,24 +118,36 @@ public:
 	const std::string &getAttributeString(ItemAttribute_t type) const;
 	const int64_t &getAttributeValue(ItemAttribute_t type) const;
 
-	const std::vector<Attributes> &getAttributeVector() const {
-		return attributeVector;
+	// Bitmask of the present attributes, bit N set means ItemAttribute_t N is present
+	uint64_t getAttributeBits() const {
+		return attributeBits;
 	}
 
 	bool hasAttribute(ItemAttribute_t type) const {
-		for (const auto &attr : attributeVector) {
-			if (attr.getAttributeType() == type) {
-				return true;
-			}
-		}
-		return false;
+		return (attributeBits & getAttributeBit(type)) != 0;
 	}
 
-	const Attributes* getAttribute(ItemAttribute_t type) const;
-
-	Attributes &getAttributesByType(ItemAttribute_t type);
+	// Heap bytes owned by this object, not counting sizeof(ItemAttribute) itself
+	size_t getDynamicMemoryUsage() const;
 
 private:
-	std::map<std::string, CustomAttribute, std::less<>> customAttributeMap;
-	std::vector<Attributes> attributeVector;
+	struct ColdStorage {
+		std::vector<std::shared_ptr<std::string>> strings;
+		std::map<std::string, CustomAttribute, std::less<>> customAttributeMap;
+	};
+
+	// Most items carry at most decay state, duration and one more integer (charges, action id...)
+	static constexpr size_t INLINE_INTEGER_SLOTS = 3;
+	static constexpr uint64_t integerAttributeBits = getAttributeKindBits(true);
+	static constexpr uint64_t stringAttributeBits = getAttributeKindBits(false);
+
+	size_t getSlot(uint64_t kindBits, ItemAttribute_t type) const {
+		return static_cast<size_t>(std::popcount(attributeBits & kindBits & (getAttributeBit(type) - 1)));
+	}
+
+	ColdStorage &initColdStorage();
+
+	uint64_t attributeBits = 0;
+	absl::InlinedVector<int64_t, INLINE_INTEGER_SLOTS> integerValues;
+	std::unique_ptr<ColdStorage> coldStorage;
 };
@@ -256,23 +256,18 @@ bool Item::equals(std::shared_ptr<Item> compareItem) const {
 		return false;
 	}
 
-	for (const auto &attribute : getAttributeVector()) {
-		if (attribute.getAttributeType() == ItemAttribute_t::STORE) {
-			continue;
-		}
+	// Only attributes present on both items are compared
+	uint64_t sharedBits = getAttributeBits() & compareItem->getAttributeBits() & ~ItemAttributeHelper::getAttributeBit(ItemAttribute_t::STORE);
+	while (sharedBits != 0) {
+		const auto type = static_cast<ItemAttribute_t>(std::countr_zero(sharedBits));
+		sharedBits &= sharedBits - 1;
 
-		for (const auto &compareAttribute : compareItem->getAttributeVector()) {
-			if (attribute.getAttributeType() != compareAttribute.getAttributeType()) {
-				continue;
-			}
-
-			if (isAttributeInteger(attribute.getAttributeType()) && attribute.getInteger() != compareAttribute.getInteger()) {
-				return false;
-			}
+		if (isAttributeInteger(type) && getInteger(type) != compareItem->getInteger(type)) {
+			return false;
+		}
 
-			if (isAttributeString(attribute.getAttributeType()) && attribute.getString() != compareAttribute.getString()) {
-				return false;
-			}
+		if (isAttributeString(type) && getString(type) != compareItem->getString(type)) {
+			return false;
 		}
 	}
 
@@ -3264,18 +3259,16 @@ bool Item::hasMarketAttributes() const {
 		return true;
 	}
 
-	for (const auto &attribute : getAttributeVector()) {
-		if (attribute.getAttributeType() == ItemAttribute_t::CHARGES && static_cast<uint16_t>(attribute.getInteger()) != items[id].charges) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::CHARGES) && static_cast<uint16_t>(getInteger(ItemAttribute_t::CHARGES)) != items[id].charges) {
+		return false;
+	}
 
-		if (attribute.getAttributeType() == ItemAttribute_t::DURATION && static_cast<uint32_t>(attribute.getInteger()) != getDefaultDuration()) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::DURATION) && static_cast<uint32_t>(getInteger(ItemAttribute_t::DURATION)) != getDefaultDuration()) {
+		return false;
+	}
 
-		if (attribute.getAttributeType() == ItemAttribute_t::TIER && static_cast<uint8_t>(attribute.getInteger()) != getTier()) {
-			return false;
-		}
+	if (hasAttribute(ItemAttribute_t::TIER) && static_cast<uint8_t>(getInteger(ItemAttribute_t::TIER)) != getTier()) {
+		return false;
 	}
 
 	return !hasImbuements() && !isStoreItem() && !hasOwner();
@@ -31,7 +31,7 @@ class BedItem;
 class Imbuement;
 class Item;
 
-// This class ItemProperties that serves as an interface to access and modify attributes of an item. The item's attributes are stored in an instance of ItemAttribute. The class ItemProperties has methods to get and set integer and string attributes, check if an attribute exists, remove an attribute, get the underlying attribute bits, and get a vector of attributes. It also has methods to get and set custom attributes, which are stored in a std::map<std::string, CustomAttribute, std::less<>>. The class has a data member attributePtr of type std::unique_ptr<ItemAttribute> that stores a pointer to the item's attributes methods.
+// This class ItemProperties that serves as an interface to access and modify attributes of an item. The item's attributes are stored in an instance of ItemAttribute. The class ItemProperties has methods to get and set integer and string attributes, check if an attribute exists, remove an attribute, and get the underlying attribute bits. It also has methods to get and set custom attributes, which are stored in a std::map<std::string, CustomAttribute, std::less<>>. The class has a data member attributePtr of type std::unique_ptr<ItemAttribute> that stores a pointer to the item's attributes methods.
 class ItemProperties {
 public:
 	template <typename T>
@@ -104,6 +104,15 @@ public:
 		return !getCustomAttributeMap().empty();
 	}
 
+	// Bytes used by the attribute storage, zero when the item has no attributes
+	size_t getAttributesMemoryUsage() const {
+		if (!attributePtr) {
+			return 0;
+		}
+
+		return sizeof(ItemAttribute) + attributePtr->getDynamicMemoryUsage();
+	}
+
 	bool removeCustomAttribute(const std::string &attributeName) {
 		if (!attributePtr) {
 			return false;
@@ -172,13 +181,12 @@ protected:
 		return attributePtr;
 	}
 
-	const std::vector<Attributes> &getAttributeVector() const {
-		static std::vector<Attributes> emptyVector = {};
+	uint64_t getAttributeBits() const {
 		if (!attributePtr) {
-			return emptyVector;
+			return 0;
 		}
 
-		return attributePtr->getAttributeVector();
+		return attributePtr->getAttributeBits();
 	}
 
 	const int64_t &getInteger(ItemAttribute_t type) const {
@@ -7,34 +7,93 @@
  * Website: https://docs.opentibiabr.com/
  */
 #include <spdlog/spdlog.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
 
 #include "pch.hpp"
 #include "lib/di/container.hpp"
 
+namespace {
+	// In messages, the writer thread only falls behind on bursts
+	constexpr size_t ASYNC_QUEUE_SIZE = 8192;
+
+	constexpr spdlog::level::level_enum toSpdLevel(LogLevel level) {
+		switch (level) {
+			case LogLevel::Trace:
+				return spdlog::level::trace;
+			case LogLevel::Debug:
+				return spdlog::level::debug;
+			case LogLevel::Info:
+				return spdlog::level::info;
+			case LogLevel::Warning:
+				return spdlog::level::warn;
+			case LogLevel::Error:
+				return spdlog::level::err;
+			case LogLevel::Critical:
+				return spdlog::level::critical;
+			default:
+				return spdlog::level::off;
+		}
+	}
+}
+
 LogWithSpdLog::LogWithSpdLog() {
-	setLevel("info");
-	spdlog::set_pattern("[%Y-%d-%m %H:%M:%S.%e] [%^%l%$] %v ");
+	auto sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+	sink->set_pattern("[%Y-%d-%m %H:%M:%S.%e] [%^%l%$] %v ");
 
 #ifdef DEBUG_LOG
-	spdlog::set_pattern("[%Y-%d-%m %H:%M:%S.%e] [thread %t] [%^%l%$] %v ");
+	sink->set_pattern("[%Y-%d-%m %H:%M:%S.%e] [thread %t] [%^%l%$] %v ");
 #endif
+
+	threadPool = std::make_shared<spdlog::details::thread_pool>(ASYNC_QUEUE_SIZE, 1);
+	asyncLogger = std::make_shared<spdlog::async_logger>("canary", sink, threadPool, spdlog::async_overflow_policy::overrun_oldest);
+	syncLogger = std::make_shared<spdlog::logger>("canary", sink);
+	// Errors are written and flushed before the call returns, so a crash right after can't lose them
+	syncLogger->flush_on(spdlog::level::err);
+
+	// The level is checked by Logger::shouldLog before formatting
+	for (const auto &logger : { asyncLogger, syncLogger }) {
+		logger->set_level(spdlog::level::trace);
+	}
+
+	setMinimumLevel(LogLevel::Info);
 }
 
+LogWithSpdLog::~LogWithSpdLog() = default;
+
 Logger &LogWithSpdLog::getInstance() {
 	return inject<Logger>();
 }
 
 void LogWithSpdLog::setLevel(const std::string &name) {
 	debug("Setting log level to: {}.", name);
-	auto level = spdlog::level::from_str(name);
-	spdlog::set_level(level);
+	setMinimumLevel(getLevelFromName(name));
 }
 
 std::string LogWithSpdLog::getLevel() const {
-	auto level = spdlog::level::to_string_view(spdlog::get_level());
-	return std::string { level.begin(), level.end() };
+	return std::string { getLevelName(getMinimumLevel()) };
 }
 
 void LogWithSpdLog::log(const std::string &lvl, const fmt::basic_string_view<char> msg) const {
-	spdlog::log(spdlog::level::from_str(lvl), msg);
+	if (const auto level = getLevelFromName(lvl); shouldLog(level)) {
+		log(level, msg);
+	}
+}
+
+void LogWithSpdLog::log(LogLevel level, const fmt::basic_string_view<char> msg) const {
+	// The sink is shared and locked, an error may come out ahead of older queued messages
+	if (!async.load(std::memory_order_acquire) || level >= LogLevel::Error) {
+		syncLogger->log(toSpdLevel(level), msg);
+	} else {
+		asyncLogger->log(toSpdLevel(level), msg);
+	}
+}
+
+void LogWithSpdLog::shutdown() {
+	if (!async.exchange(false)) {
+		return;
+	}
+
+	// The writer thread is joined once it wrote everything queued before
+	threadPool.reset();
 }
@@ -10,10 +10,24 @@
 
 #include "lib/logging/logger.hpp"
 
+namespace spdlog {
+	class logger;
+	namespace details {
+		class thread_pool;
+	}
+}
+
+/**
+ * Console logger, messages are formatted on the calling thread and written by a
+ * background thread so logging never waits on the console.
+ *
+ * Up to warning, a full queue overwrites its oldest message; errors and critical
+ * messages wait for room instead, so they are never lost.
+ */
 class LogWithSpdLog final : public Logger {
 public:
 	LogWithSpdLog();
-	~LogWithSpdLog() override = default;
+	~LogWithSpdLog() override;
 
 	static Logger &getInstance();
 
@@ -21,6 +35,15 @@ public:
 	std::string getLevel() const override;
 
 	void log(const std::string &lvl, fmt::basic_string_view<char> msg) const override;
+	void log(LogLevel level, fmt::basic_string_view<char> msg) const override;
+
+	void shutdown() override;
+
+private:
+	std::shared_ptr<spdlog::details::thread_pool> threadPool;
+	std::shared_ptr<spdlog::logger> asyncLogger;
+	std::shared_ptr<spdlog::logger> syncLogger;
+	std::atomic<bool> async = true;
 };
 
 constexpr auto g_logger = LogWithSpdLog::getInstance;
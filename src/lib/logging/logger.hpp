@@ -9,33 +9,26 @@
 #pragma once
 
 #ifndef USE_PRECOMPILED_HEADERS
+	#include <atomic>
+	#include <string>
 	#include <fmt/format.h>
 #endif
 
-#define LOG_LEVEL_TRACE \
-	std::string {       \
-		"trace"         \
-	}
-#define LOG_LEVEL_DEBUG \
-	std::string {       \
-		"debug"         \
-	}
-#define LOG_LEVEL_INFO \
-	std::string {      \
-		"info"         \
-	}
-#define LOG_LEVEL_WARNING \
-	std::string {         \
-		"warning"         \
-	}
-#define LOG_LEVEL_ERROR \
-	std::string {       \
-		"error"         \
-	}
-#define LOG_LEVEL_CRITICAL \
-	std::string {          \
-		"critical"         \
-	}
+// Lowest level compiled in, set with -DLOG_ACTIVE_LEVEL=<level> on cmake. Calls below it are
+// removed at compile time, the others are still checked against the runtime level first
+#ifndef LOG_ACTIVE_LEVEL
+	#define LOG_ACTIVE_LEVEL 0
+#endif
+
+enum class LogLevel : uint8_t {
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Critical,
+	Off,
+};
 
 class Logger {
 public:
@@ -50,63 +43,169 @@ public:
 	[[nodiscard]] virtual std::string getLevel() const = 0;
 	virtual void log(const std::string &lvl, fmt::basic_string_view<char> msg) const = 0;
 
+	// Called with the level already checked, loggers that only implement the string overload still work
+	virtual void log(LogLevel level, fmt::basic_string_view<char> msg) const {
+		log(std::string { getLevelName(level) }, msg);
+	}
+
+	// Writes everything still queued, the messages logged afterwards are written synchronously
+	virtual void shutdown() { }
+
+	static constexpr bool isCompiledIn(LogLevel level) {
+		return static_cast<uint8_t>(level) >= LOG_ACTIVE_LEVEL;
+	}
+
+	bool shouldLog(LogLevel level) const {
+		return isCompiledIn(level) && level >= minimumLevel.load(std::memory_order_relaxed);
+	}
+
+	LogLevel getMinimumLevel() const {
+		return minimumLevel.load(std::memory_order_relaxed);
+	}
+
+	static constexpr std::string_view getLevelName(LogLevel level) {
+		switch (level) {
+			case LogLevel::Trace:
+				return "trace";
+			case LogLevel::Debug:
+				return "debug";
+			case LogLevel::Info:
+				return "info";
+			case LogLevel::Warning:
+				return "warning";
+			case LogLevel::Error:
+				return "error";
+			case LogLevel::Critical:
+				return "critical";
+			default:
+				return "off";
+		}
+	}
+
+	// Same names as spdlog, unknown names turn logging off
+	static constexpr LogLevel getLevelFromName(std::string_view name) {
+		for (auto level = LogLevel::Trace; level != LogLevel::Off; level = static_cast<LogLevel>(static_cast<uint8_t>(level) + 1)) {
+			if (name == getLevelName(level)) {
+				return level;
+			}
+		}
+		if (name == "warn") {
+			return LogLevel::Warning;
+		}
+		if (name == "err") {
+			return LogLevel::Error;
+		}
+		return LogLevel::Off;
+	}
+
 	template <typename... Args>
 	void trace(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		trace(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (isCompiledIn(LogLevel::Trace)) {
+			logFormatted(LogLevel::Trace, fmt, std::forward<Args>(args)...);
+		}
 	}
 
 	template <typename... Args>
 	void debug(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		debug(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (isCompiledIn(LogLevel::Debug)) {
+			logFormatted(LogLevel::Debug, fmt, std::forward<Args>(args)...);
+		}
 	}
 
 	template <typename... Args>
 	void info(fmt::format_string<Args...> fmt, Args &&... args) {
-		info(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (isCompiledIn(LogLevel::Info)) {
+			logFormatted(LogLevel::Info, fmt, std::forward<Args>(args)...);
+		}
 	}
 
 	template <typename... Args>
 	void warn(const fmt::format_string<Args...> &fmt, Args &&... args) {
-		warn(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (isCompiledIn(LogLevel::Warning)) {
+			logFormatted(LogLevel::Warning, fmt, std::forward<Args>(args)...);
+		}
 	}
 
 	template <typename... Args>
 	void error(const fmt::format_string<Args...> fmt, Args &&... args) {
-		error(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (isCompiledIn(LogLevel::Error)) {
+			logFormatted(LogLevel::Error, fmt, std::forward<Args>(args)...);
+		}
 	}
 
 	template <typename... Args>
 	void critical(const fmt::format_string<Args...> fmt, Args &&... args) {
-		critical(fmt::format(fmt, std::forward<Args>(args)...));
+		if constexpr (isCompiledIn(LogLevel::Critical)) {
+			logFormatted(LogLevel::Critical, fmt, std::forward<Args>(args)...);
+		}
 	}
 
 	template <typename T>
 	void trace(const T &msg) {
-		log(LOG_LEVEL_TRACE, msg);
+		if constexpr (isCompiledIn(LogLevel::Trace)) {
+			logMessage(LogLevel::Trace, msg);
+		}
 	}
 
 	template <typename T>
 	void debug(const T &msg) {
-		log(LOG_LEVEL_DEBUG, msg);
+		if constexpr (isCompiledIn(LogLevel::Debug)) {
+			logMessage(LogLevel::Debug, msg);
+		}
 	}
 
 	template <typename T>
 	void info(const T &msg) {
-		log(LOG_LEVEL_INFO, msg);
+		if constexpr (isCompiledIn(LogLevel::Info)) {
+			logMessage(LogLevel::Info, msg);
+		}
 	}
 
 	template <typename T>
 	void warn(const T &msg) {
-		log(LOG_LEVEL_WARNING, msg);
+		if constexpr (isCompiledIn(LogLevel::Warning)) {
+			logMessage(LogLevel::Warning, msg);
+		}
 	}
 
 	template <typename T>
 	void error(const T &msg) {
-		log(LOG_LEVEL_ERROR, msg);
+		if constexpr (isCompiledIn(LogLevel::Error)) {
+			logMessage(LogLevel::Error, msg);
+		}
 	}
 
 	template <typename T>
 	void critical(const T &msg) {
-		log(LOG_LEVEL_CRITICAL, msg);
+		if constexpr (isCompiledIn(LogLevel::Critical)) {
+			logMessage(LogLevel::Critical, msg);
+		}
+	}
+
+protected:
+	void setMinimumLevel(LogLevel level) {
+		minimumLevel.store(level, std::memory_order_relaxed);
 	}
+
+private:
+	// The level is checked before formatting, a disabled call costs a relaxed load
+	template <typename... Args>
+	void logFormatted(LogLevel level, fmt::format_string<Args...> fmt, Args &&... args) const {
+		if (!shouldLog(level)) {
+			return;
+		}
+
+		fmt::memory_buffer buffer;
+		fmt::format_to(std::back_inserter(buffer), fmt, std::forward<Args>(args)...);
+		log(level, fmt::basic_string_view<char>(buffer.data(), buffer.size()));
+	}
+
+	template <typename T>
+	void logMessage(LogLevel level, const T &msg) const {
+		if (shouldLog(level)) {
+			log(level, msg);
+		}
+	}
+
+	std::atomic<LogLevel> minimumLevel = LogLevel::Trace;
 };
@@ -81,15 +81,22 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(method, "method", "method");
 	DEFINE_LATENCY_CLASS(lua, "lua", "scope");
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
+	DEFINE_LATENCY_CLASS(query_kind, "query_kind", "kind");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(login, "login", "stage");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
 		"lua_latency",
 		"query_latency",
+		"query_kind_latency",
 		"task_latency",
 		"lock_latency",
+		"login_latency",
+		"task_wait_latency",
+		"dispatcher_cycle_latency",
+		"player_save_lag",
 	};
 
 	class Metrics final {
@@ -129,6 +136,45 @@ namespace metrics {
 			upDownCounters[name]->Add(value, attrskv);
 		}
 
+		/**
+		 * Sets an absolute value, recorded as the delta from the last value set for the same name and attributes.
+		 */
+		void setGauge(std::string_view name, int64_t value, std::map<std::string, std::string> attrs = {}) {
+			std::scoped_lock lock(mutex_);
+			if (!getMeter()) {
+				return;
+			}
+			if (upDownCounters.find(name) == upDownCounters.end()) {
+				std::string nameStr(name);
+				upDownCounters[name] = getMeter()->CreateInt64UpDownCounter(nameStr);
+			}
+
+			std::string gaugeKey(name);
+			for (const auto &[key, attrValue] : attrs) {
+				gaugeKey.append(fmt::format("|{}={}", key, attrValue));
+			}
+			auto &lastValue = gaugeValues[gaugeKey];
+			auto attrskv = opentelemetry::common::KeyValueIterableView<decltype(attrs)> { attrs };
+			upDownCounters[name]->Add(value - lastValue, attrskv);
+			lastValue = value;
+		}
+
+		/**
+		 * Records a latency that wasn't measured by a single scope, e.g. the time a task waited in a queue.
+		 */
+		void recordLatency(std::string_view histogramName, std::chrono::nanoseconds latency, std::string_view scopeKey = {}, std::string_view scope = {}) {
+			auto it = latencyHistograms.find(std::string(histogramName));
+			if (it == latencyHistograms.end() || it->second == nullptr) {
+				return;
+			}
+			std::map<std::string, std::string> attrs;
+			if (!scopeKey.empty()) {
+				attrs.emplace(scopeKey, scope);
+			}
+			auto attrskv = opentelemetry::common::KeyValueIterableView<decltype(attrs)> { attrs };
+			it->second->Record(static_cast<double>(latency.count()) / 1000, attrskv, defaultContext);
+		}
+
 		friend class ScopedLatency;
 
 	protected:
@@ -136,6 +182,7 @@ namespace metrics {
 		phmap::parallel_flat_hash_map<std::string, Histogram<double>> latencyHistograms;
 		phmap::flat_hash_map<std::string, UpDownCounter<int64_t>> upDownCounters;
 		phmap::flat_hash_map<std::string, Counter<double>> counters;
+		phmap::flat_hash_map<std::string, int64_t> gaugeValues;
 
 		Meter getMeter() {
 			auto provider = metrics_api::Provider::GetMeterProvider();
@@ -187,15 +234,22 @@ namespace metrics {
 	DEFINE_LATENCY_CLASS(method, "method", "method");
 	DEFINE_LATENCY_CLASS(lua, "lua", "scope");
 	DEFINE_LATENCY_CLASS(query, "query", "truncated_query");
+	DEFINE_LATENCY_CLASS(query_kind, "query_kind", "kind");
 	DEFINE_LATENCY_CLASS(task, "task", "task");
 	DEFINE_LATENCY_CLASS(lock, "lock", "scope");
+	DEFINE_LATENCY_CLASS(login, "login", "stage");
 
 	const std::vector<std::string> latencyNames {
 		"method_latency",
 		"lua_latency",
 		"query_latency",
+		"query_kind_latency",
 		"task_latency",
 		"lock_latency",
+		"login_latency",
+		"task_wait_latency",
+		"dispatcher_cycle_latency",
+		"player_save_lag",
 	};
 
 	class Metrics final {
@@ -215,6 +269,10 @@ namespace metrics {
 
 		void addUpDownCounter([[maybe_unused]] std::string_view name, [[maybe_unused]] int value, [[maybe_unused]] const std::map<std::string, std::string> &attrs = {}) { }
 
+		void setGauge([[maybe_unused]] std::string_view name, [[maybe_unused]] int64_t value, [[maybe_unused]] const std::map<std::string, std::string> &attrs = {}) { }
+
+		void recordLatency([[maybe_unused]] std::string_view histogramName, [[maybe_unused]] std::chrono::nanoseconds latency, [[maybe_unused]] std::string_view scopeKey = {}, [[maybe_unused]] std::string_view scope = {}) { }
+
 		friend class ScopedLatency;
 	};
 }
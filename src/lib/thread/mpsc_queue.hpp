@@ -0,0 +1,165 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Bounded lock-free queue with any number of producers and a single consumer.
+ * Values are built in place in preallocated cells, each with a sequence number telling
+ * whether it is free for the producer of that lap or ready for the consumer,
+ * so pushing never allocates nor locks; it fails when the queue is full.
+ *
+ * A value whose producer claimed its cell but didn't finish writing it holds back
+ * the consumer (and the values behind it) until it is published.
+ */
+template <typename T, size_t Capacity>
+class MpscQueue {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	MpscQueue() {
+		for (size_t i = 0; i < Capacity; ++i) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	~MpscQueue() {
+		drain([](T &&) { });
+	}
+
+	// non-copyable
+	MpscQueue(const MpscQueue &) = delete;
+	MpscQueue &operator=(const MpscQueue &) = delete;
+
+	// Any thread, value is only moved from when it was pushed
+	template <typename... Args>
+	bool tryEmplace(Args &&... args) {
+		size_t position = tail.load(std::memory_order_relaxed);
+		while (true) {
+			auto &cell = cells[position & MASK];
+			const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+			if (difference == 0) {
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					new (cell.storage) T(std::forward<Args>(args)...);
+					cell.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool tryPush(T &&value) {
+		return tryEmplace(std::move(value));
+	}
+
+	// Consumer thread only
+	bool tryPop(T &value) {
+		auto &cell = cells[head & MASK];
+		if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+			return false;
+		}
+
+		auto* stored = std::launder(reinterpret_cast<T*>(cell.storage));
+		value = std::move(*stored);
+		stored->~T();
+		cell.sequence.store(head + Capacity, std::memory_order_release);
+		++head;
+		return true;
+	}
+
+	/**
+	 * Consumer thread only, passes every published value to consumer in push order.
+	 * Takes at most one queue's worth, so busy producers can't keep the consumer in here.
+	 * @return How many values were consumed.
+	 */
+	template <typename Consumer>
+	size_t drain(Consumer &&consumer) {
+		size_t consumed = 0;
+		for (; consumed < Capacity; ++consumed) {
+			auto &cell = cells[head & MASK];
+			if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+				break;
+			}
+
+			auto* stored = std::launder(reinterpret_cast<T*>(cell.storage));
+			consumer(std::move(*stored));
+			stored->~T();
+			cell.sequence.store(head + Capacity, std::memory_order_release);
+			++head;
+		}
+		return consumed;
+	}
+
+	static constexpr size_t capacity() {
+		return Capacity;
+	}
+
+private:
+	static constexpr size_t MASK = Capacity - 1;
+	// Keeps the producers' and the consumer's counters on their own cache lines
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct Cell {
+		std::atomic<size_t> sequence;
+		alignas(T) std::byte storage[sizeof(T)];
+	};
+
+	std::unique_ptr<Cell[]> cells = std::make_unique<Cell[]>(Capacity);
+	alignas(CACHE_LINE) std::atomic<size_t> tail = 0;
+	alignas(CACHE_LINE) size_t head = 0;
+};
+
+/**
+ * MpscQueue that never refuses a value: while it is full, values go to a locked vector
+ * until the consumer takes them, and so do the ones pushed after them, keeping each
+ * producer's order. Sized so the fallback is only hit on bursts.
+ */
+template <typename T, size_t Capacity>
+class OverflowingMpscQueue {
+public:
+	// Any thread
+	void push(T &&value) {
+		if (!overflowed.load(std::memory_order_acquire) && queue.tryPush(std::move(value))) {
+			return;
+		}
+
+		std::scoped_lock lock(mutex);
+		overflow.emplace_back(std::move(value));
+		overflowed.store(true, std::memory_order_release);
+	}
+
+	// Consumer thread only, appends the queued values in push order
+	void drainTo(std::vector<T> &values) {
+		const auto append = [&values](T &&value) {
+			values.emplace_back(std::move(value));
+		};
+		queue.drain(append);
+
+		// Values pushed while the queue was full come after everything in it, so the queue is
+		// emptied first even past the drain's cap. Producers don't push to it while overflowed.
+		if (overflowed.load(std::memory_order_acquire)) {
+			while (queue.drain(append) != 0) { }
+			std::scoped_lock lock(mutex);
+			values.insert(values.end(), std::make_move_iterator(overflow.begin()), std::make_move_iterator(overflow.end()));
+			overflow.clear();
+			overflowed.store(false, std::memory_order_release);
+		}
+	}
+
+private:
+	MpscQueue<T, Capacity> queue;
+	std::vector<T> overflow;
+	std::atomic_bool overflowed = false;
+	std::mutex mutex;
+};
@@ -0,0 +1,108 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/thread/task_graph.hpp"
+#include "lib/thread/thread_pool.hpp"
+#include "utils/benchmark.hpp"
+
+TaskGraph::TaskGraph(ThreadPool &threadPool) :
+	threadPool(threadPool) { }
+
+void TaskGraph::add(std::string name, const std::vector<std::string> &dependencies, Task task, bool onCallerThread /* = false*/) {
+	const auto findNode = [this](const std::string &nodeName) {
+		return std::ranges::find(nodes, nodeName, &Node::name);
+	};
+
+	if (findNode(name) != nodes.end()) {
+		throw std::invalid_argument(fmt::format("Task '{}' was already added", name));
+	}
+
+	const size_t index = nodes.size();
+	for (const auto &dependency : dependencies) {
+		const auto it = findNode(dependency);
+		if (it == nodes.end()) {
+			throw std::invalid_argument(fmt::format("Task '{}' depends on unknown task '{}'", name, dependency));
+		}
+		it->dependents.push_back(index);
+	}
+
+	nodes.push_back({ std::move(name), std::move(task), onCallerThread, dependencies.size(), {} });
+}
+
+std::string TaskGraph::run() {
+	std::unique_lock lock(mutex);
+	for (size_t index = 0; index < nodes.size(); ++index) {
+		if (nodes[index].pendingDependencies == 0) {
+			start(index);
+		}
+	}
+
+	while (true) {
+		signal.wait(lock, [this] { return !callerThreadTasks.empty() || unfinished == 0; });
+		if (callerThreadTasks.empty()) {
+			break;
+		}
+
+		const size_t index = callerThreadTasks.front();
+		callerThreadTasks.pop_front();
+		if (!failedTask.empty()) {
+			--unfinished;
+			continue;
+		}
+
+		lock.unlock();
+		execute(index);
+		lock.lock();
+	}
+
+	return failedTask;
+}
+
+void TaskGraph::start(size_t index) {
+	// mutex must be held
+	++unfinished;
+	if (nodes[index].onCallerThread) {
+		callerThreadTasks.push_back(index);
+		signal.notify_all();
+		return;
+	}
+
+	threadPool.detach_task([this, index] { execute(index); });
+}
+
+void TaskGraph::execute(size_t index) {
+	auto &node = nodes[index];
+	Benchmark bm_task;
+	bool succeeded = false;
+	try {
+		succeeded = node.task();
+	} catch (const std::exception &e) {
+		g_logger().error("[TaskGraph] Task '{}' threw: {}", node.name, e.what());
+	}
+	const double duration = bm_task.duration();
+
+	std::scoped_lock lock(mutex);
+	timings.push_back({ node.name, duration });
+	if (!succeeded && failedTask.empty()) {
+		failedTask = node.name;
+	}
+
+	if (failedTask.empty()) {
+		for (const size_t dependent : node.dependents) {
+			if (--nodes[dependent].pendingDependencies == 0) {
+				start(dependent);
+			}
+		}
+	}
+
+	--unfinished;
+	signal.notify_all();
+}
@@ -0,0 +1,72 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class ThreadPool;
+
+/**
+ * Runs a set of named tasks with declared dependencies, each task starting on the
+ * thread pool as soon as all of its dependencies succeeded. Tasks that must not leave
+ * the calling thread (e.g. anything touching the Lua state) are run by run() itself.
+ */
+class TaskGraph {
+public:
+	using Task = std::function<bool()>;
+
+	struct Timing {
+		std::string name;
+		// Milliseconds
+		double duration;
+	};
+
+	explicit TaskGraph(ThreadPool &threadPool);
+
+	/**
+	 * Adds a task, its dependencies must already be added (so the graph has no cycles).
+	 * @param onCallerThread Runs the task on the thread calling run() instead of the thread pool.
+	 * @throws std::invalid_argument on a duplicated name or unknown dependency.
+	 */
+	void add(std::string name, const std::vector<std::string> &dependencies, Task task, bool onCallerThread = false);
+
+	/**
+	 * Runs every task and waits for them. A task fails by returning false or throwing;
+	 * no task starts after a failure, the ones already running are waited for.
+	 * @return The name of the first task that failed, empty if all of them succeeded.
+	 */
+	std::string run();
+
+	// Duration of each task that ran, in completion order
+	const std::vector<Timing> &getTimings() const {
+		return timings;
+	}
+
+private:
+	struct Node {
+		std::string name;
+		Task task;
+		bool onCallerThread = false;
+		size_t pendingDependencies = 0;
+		std::vector<size_t> dependents;
+	};
+
+	void start(size_t index);
+	void execute(size_t index);
+
+	ThreadPool &threadPool;
+	std::vector<Node> nodes;
+	std::vector<Timing> timings;
+
+	std::mutex mutex;
+	std::condition_variable signal;
+	std::deque<size_t> callerThreadTasks;
+	// Tasks started (queued or running) and not finished yet
+	size_t unfinished = 0;
+	std::string failedTask;
+};
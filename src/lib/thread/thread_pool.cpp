@@ -26,12 +26,12 @@
 #endif
 
 ThreadPool::ThreadPool(Logger &logger) :
-	logger(logger), BS::thread_pool(std::max<int>(getNumberOfCores(), DEFAULT_NUMBER_OF_THREADS)) {
+	logger(logger), BS::thread_pool(std::max<int>(getNumberOfCores(), DEFAULT_NUMBER_OF_THREADS)), workStealingPool(std::max<size_t>(2, getNumberOfCores()) - 1) {
 	start();
 }
 
 void ThreadPool::start() {
-	logger.info("Running with {} threads.", get_thread_count());
+	logger.info("Running with {} threads and {} parallel workers.", get_thread_count(), workStealingPool.getWorkerCount());
 }
 
 void ThreadPool::shutdown() {
@@ -10,6 +10,7 @@
 
 #include "lib/logging/logger.hpp"
 #include "BS_thread_pool.hpp"
+#include "lib/thread/work_stealing_pool.hpp"
 
 class ThreadPool : public BS::thread_pool {
 public:
@@ -38,7 +39,28 @@ public:
 		return stopped;
 	}
 
+	/**
+	 * Spreads f(index) over the work-stealing workers and the calling thread, for CPU work such as the
+	 * dispatcher's parallel groups or per creature computations. See WorkStealingPool::parallelFor.
+	 */
+	template <typename F>
+	void parallelFor(size_t begin, size_t end, F &&f, size_t grain = 1) {
+		workStealingPool.parallelFor(begin, end, std::forward<F>(f), grain);
+	}
+
+	template <typename Range, typename F>
+	void parallelForEach(Range &&range, F &&f, size_t grain = 1) {
+		workStealingPool.parallelForEach(std::forward<Range>(range), std::forward<F>(f), grain);
+	}
+
+	// Threads running parallelFor chunks, besides the ones of the thread pool itself
+	size_t getParallelWorkerCount() const {
+		return workStealingPool.getWorkerCount();
+	}
+
 private:
 	Logger &logger;
 	bool stopped = false;
+	// One worker less than the cores, as the thread calling parallelFor runs chunks too
+	WorkStealingPool workStealingPool;
 };
@@ -0,0 +1,148 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lib/thread/work_stealing_pool.hpp"
+
+namespace {
+	// The pool the current thread works for and the index of its deque
+	thread_local const WorkStealingPool* currentPool = nullptr;
+	thread_local size_t currentQueue = 0;
+}
+
+WorkStealingPool::WorkStealingPool(size_t workerCount) {
+	queues.reserve(workerCount + 1);
+	for (size_t i = 0; i <= workerCount; ++i) {
+		queues.emplace_back(std::make_unique<JobQueue>());
+	}
+
+	workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; ++i) {
+		workers.emplace_back([this, i] { work(i); });
+	}
+}
+
+WorkStealingPool::~WorkStealingPool() {
+	{
+		std::scoped_lock lock(sleepMutex);
+		stopping = true;
+	}
+	wakeUp.notify_all();
+
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+void WorkStealingPool::run(std::vector<std::function<void(void)>> &&jobs) {
+	if (jobs.empty()) {
+		return;
+	}
+
+	auto batch = std::make_shared<Batch>();
+	batch->pending.store(jobs.size(), std::memory_order_relaxed);
+	{
+		auto &queue = *queues[getQueueIndex()];
+		std::scoped_lock lock(queue.mutex);
+		for (auto &function : jobs) {
+			queue.jobs.push_back({ std::move(function), batch });
+		}
+	}
+
+	queuedJobs.fetch_add(jobs.size(), std::memory_order_release);
+	{
+		// Taken so a worker can't miss the wake up between checking queuedJobs and sleeping
+		std::scoped_lock lock(sleepMutex);
+	}
+	wakeUp.notify_all();
+
+	// Nothing left to run means the remaining jobs are running on other threads
+	while (true) {
+		const size_t pending = batch->pending.load(std::memory_order_acquire);
+		if (pending == 0) {
+			break;
+		}
+		if (!runOne()) {
+			batch->pending.wait(pending, std::memory_order_acquire);
+		}
+	}
+
+	if (batch->error) {
+		std::rethrow_exception(batch->error);
+	}
+}
+
+void WorkStealingPool::work(size_t index) {
+	currentPool = this;
+	currentQueue = index;
+
+	while (true) {
+		if (runOne()) {
+			continue;
+		}
+
+		std::unique_lock lock(sleepMutex);
+		wakeUp.wait(lock, [this] {
+			return stopping || queuedJobs.load(std::memory_order_acquire) > 0;
+		});
+		if (stopping) {
+			return;
+		}
+	}
+}
+
+bool WorkStealingPool::runOne() {
+	const size_t own = getQueueIndex();
+	std::optional<Job> job;
+	{
+		auto &queue = *queues[own];
+		std::scoped_lock lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job.emplace(std::move(queue.jobs.back()));
+			queue.jobs.pop_back();
+		}
+	}
+
+	for (size_t offset = 1; !job && offset < queues.size(); ++offset) {
+		auto &queue = *queues[(own + offset) % queues.size()];
+		std::scoped_lock lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job.emplace(std::move(queue.jobs.front()));
+			queue.jobs.pop_front();
+		}
+	}
+
+	if (!job) {
+		return false;
+	}
+
+	queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	execute(*job);
+	return true;
+}
+
+void WorkStealingPool::execute(Job &job) {
+	try {
+		job.function();
+	} catch (...) {
+		std::scoped_lock lock(job.batch->errorMutex);
+		if (!job.batch->error) {
+			job.batch->error = std::current_exception();
+		}
+	}
+
+	if (job.batch->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		job.batch->pending.notify_all();
+	}
+}
+
+size_t WorkStealingPool::getQueueIndex() const {
+	return currentPool == this ? currentQueue : workers.size();
+}
@@ -0,0 +1,119 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Fixed set of workers, each with its own deque of jobs. A worker runs its newest job and,
+ * once its deque is empty, steals the oldest job of another deque, so a slow job doesn't
+ * leave the other threads idle. A thread waiting for its jobs runs jobs meanwhile instead
+ * of blocking, which makes nested parallelFor calls safe.
+ */
+class WorkStealingPool {
+public:
+	// Chunks parallelFor splits a range into, per thread, so there is something left to steal
+	static constexpr size_t CHUNKS_PER_THREAD = 4;
+
+	explicit WorkStealingPool(size_t workerCount);
+	~WorkStealingPool();
+
+	// non-copyable
+	WorkStealingPool(const WorkStealingPool &) = delete;
+	WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+	size_t getWorkerCount() const {
+		return workers.size();
+	}
+
+	/**
+	 * Calls f(index) for every index in [begin, end), in chunks of at least grain indexes run by
+	 * the workers and the calling thread. Returns once every chunk finished, then rethrows the
+	 * first exception thrown by f, if any.
+	 * f runs concurrently: it must not touch game state that other chunks may touch too.
+	 */
+	template <typename F>
+	void parallelFor(size_t begin, size_t end, F &&f, size_t grain = 1) {
+		if (begin >= end) {
+			return;
+		}
+
+		const size_t count = end - begin;
+		const size_t chunks = std::min(std::max<size_t>(1, count / std::max<size_t>(1, grain)), (workers.size() + 1) * CHUNKS_PER_THREAD);
+		if (chunks == 1 || workers.empty()) {
+			for (size_t index = begin; index < end; ++index) {
+				f(index);
+			}
+			return;
+		}
+
+		std::vector<std::function<void(void)>> jobs;
+		jobs.reserve(chunks);
+		size_t chunkBegin = begin;
+		for (size_t chunk = 0; chunk < chunks; ++chunk) {
+			const size_t chunkEnd = chunkBegin + count / chunks + (chunk < count % chunks ? 1 : 0);
+			jobs.emplace_back([&f, chunkBegin, chunkEnd] {
+				for (size_t index = chunkBegin; index < chunkEnd; ++index) {
+					f(index);
+				}
+			});
+			chunkBegin = chunkEnd;
+		}
+		run(std::move(jobs));
+	}
+
+	// Calls f(element) for every element of a random access range (creatures, spectators...), see parallelFor
+	template <typename Range, typename F>
+	void parallelForEach(Range &&range, F &&f, size_t grain = 1) {
+		parallelFor(
+			0, std::ranges::size(range), [&range, &f](size_t index) {
+				f(std::ranges::begin(range)[index]);
+			},
+			grain
+		);
+	}
+
+	// Runs every job on the workers and the calling thread, returns once all of them finished
+	void run(std::vector<std::function<void(void)>> &&jobs);
+
+private:
+	struct Batch {
+		std::atomic_size_t pending = 0;
+		std::mutex errorMutex;
+		std::exception_ptr error;
+	};
+
+	struct Job {
+		std::function<void(void)> function;
+		// Shared with the waiting thread, which may return as soon as the last job finished
+		std::shared_ptr<Batch> batch;
+	};
+
+	struct JobQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void work(size_t index);
+
+	// Runs the newest job of the calling thread's deque, or else the oldest one of another deque
+	bool runOne();
+	static void execute(Job &job);
+
+	// The deque of the calling thread, threads outside the pool share the last one
+	size_t getQueueIndex() const;
+
+	std::vector<std::unique_ptr<JobQueue>> queues;
+	std::vector<std::thread> workers;
+
+	// Jobs in the deques, idle workers sleep while there are none
+	std::atomic_size_t queuedJobs = 0;
+	std::mutex sleepMutex;
+	std::condition_variable wakeUp;
+	bool stopping = false;
+};
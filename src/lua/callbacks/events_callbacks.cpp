@@ -30,6 +30,7 @@ EventsCallbacks &EventsCallbacks::getInstance() {
 
 void EventsCallbacks::addCallback(const std::shared_ptr<EventCallback> callback) {
 	m_callbacks.push_back(callback);
+	++m_callbackCount[callback->getType()];
 }
 
 std::vector<std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacks() const {
@@ -49,6 +50,11 @@ std::vector<std::shared_ptr<EventCallback>> EventsCallbacks::getCallbacksByType(
 	return eventCallbacks;
 }
 
+bool EventsCallbacks::hasCallback(EventCallback_t type) const {
+	return m_callbackCount.contains(type);
+}
+
 void EventsCallbacks::clear() {
 	m_callbacks.clear();
+	m_callbackCount.clear();
 }
@@ -64,6 +64,13 @@ public:
 	 */
 	std::vector<std::shared_ptr<EventCallback>> getCallbacksByType(EventCallback_t type) const;
 
+	/**
+	 * @brief Checks if any callback of the type is registered, without copying them.
+	 * @param type The type of callbacks to look for.
+	 * @return True if at least one callback of the type was added.
+	 */
+	bool hasCallback(EventCallback_t type) const;
+
 	/**
 	 * @brief Clears all registered event callbacks.
 	 */
@@ -119,6 +126,8 @@ public:
 private:
 	// Container for storing registered event callbacks.
 	std::vector<std::shared_ptr<EventCallback>> m_callbacks;
+	// Number of registered callbacks of each type.
+	phmap::flat_hash_map<EventCallback_t, size_t> m_callbackCount;
 };
 
 constexpr auto g_callbacks = EventsCallbacks::getInstance;
@@ -115,6 +115,10 @@ public:
 	void eventPlayerOnRequestQuestLog(std::shared_ptr<Player> player);
 	void eventPlayerOnRequestQuestLine(std::shared_ptr<Player> player, uint16_t questId);
 	void eventOnStorageUpdate(std::shared_ptr<Player> player, const uint32_t key, const int32_t value, int32_t oldValue, uint64_t currentTime);
+	// Lets Player::addStorageValue skip building the event arguments
+	bool hasStorageUpdateEvent() const {
+		return info.playerOnStorageUpdate != -1;
+	}
 	void eventPlayerOnCombat(std::shared_ptr<Player> player, std::shared_ptr<Creature> target, std::shared_ptr<Item> item, CombatDamage &damage);
 	void eventPlayerOnInventoryUpdate(std::shared_ptr<Player> player, std::shared_ptr<Item> item, Slots_t slot, bool equip);
 
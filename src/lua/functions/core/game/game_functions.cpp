@@ -12,6 +12,8 @@
 #include "core.hpp"
 #include "creatures/monsters/monster.hpp"
 #include "game/functions/game_reload.hpp"
+#include "game/functions/memory_census.hpp"
+#include "lua/scripts/lua_profiler.hpp"
 #include "game/game.hpp"
 #include "items/item.hpp"
 #include "io/iobestiary.hpp"
@@ -23,12 +25,14 @@
 #include "lua/creature/talkaction.hpp"
 #include "lua/functions/creatures/npc/npc_type_functions.hpp"
 #include "lua/scripts/lua_environment.hpp"
+#include "lua/scripts/lua_bytecode_cache.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
 #include "creatures/players/achievement/player_achievement.hpp"
 #include "creatures/players/cyclopedia/player_badge.hpp"
 #include "creatures/players/cyclopedia/player_title.hpp"
+#include "creatures/players/storages/storages.hpp"
 #include "map/spectators.hpp"
 
 // Game
@@ -202,6 +206,18 @@ int GameFunctions::luaGameGetExperienceForLevel(lua_State* L) {
 	return 1;
 }
 
+int GameFunctions::luaGameGetStorageKey(lua_State* L) {
+	// Game.getStorageKey(name)
+	// Resolves a storages.xml name to its key, meant to be called once when the script is loaded
+	const auto key = g_storages().getStorageKey(getString(L, 1));
+	if (key) {
+		lua_pushnumber(L, *key);
+	} else {
+		lua_pushnil(L);
+	}
+	return 1;
+}
+
 int GameFunctions::luaGameGetMonsterCount(lua_State* L) {
 	// Game.getMonsterCount()
 	lua_pushnumber(L, g_game().getMonstersOnline());
@@ -606,10 +622,93 @@ int GameFunctions::luaGameReload(lua_State* L) {
 	}
 
 	pushBoolean(L, g_gameReload().init(reloadType));
+	g_luaBytecodeCache().logReport("reload");
 	lua_gc(g_luaEnvironment().getLuaState(), LUA_GCCOLLECT, 0);
 	return 1;
 }
 
+int GameFunctions::luaGameRunMemoryCensus(lua_State* L) {
+	// Game.runMemoryCensus([topCount = 20[, jsonPath = "memory_census.json"]])
+	const auto topCount = getNumber<uint32_t>(L, 1, 20);
+	const auto jsonPath = getString(L, 2, "memory_census.json");
+	const auto census = MemoryCensus::run(topCount, jsonPath);
+
+	lua_createtable(L, 0, 5);
+	setField(L, "items", census.getItems().count);
+	setField(L, "itemBytes", census.getItems().bytes);
+	setField(L, "tiles", census.getTiles().count);
+	setField(L, "tileBytes", census.getTiles().bytes);
+	setField(L, "duration", census.getDuration());
+	return 1;
+}
+
+int GameFunctions::luaGameStartLuaProfiler(lua_State* L) {
+	// Game.startLuaProfiler([intervalMs = 1])
+	pushBoolean(L, g_luaProfiler().startSampling(g_luaEnvironment().getLuaState(), getNumber<uint32_t>(L, 1, 1)));
+	return 1;
+}
+
+int GameFunctions::luaGameStopLuaProfiler(lua_State* L) {
+	// Game.stopLuaProfiler()
+	const bool sampling = g_luaProfiler().isSampling();
+	g_luaProfiler().stopSampling();
+	pushBoolean(L, sampling);
+	return 1;
+}
+
+int GameFunctions::luaGameResetLuaProfiler(lua_State* L) {
+	// Game.resetLuaProfiler()
+	g_luaProfiler().reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameDumpLuaProfiler(lua_State* L) {
+	// Game.dumpLuaProfiler([topCount = 20[, foldedPath = "lua_profile.folded"]])
+	const auto topCount = getNumber<uint32_t>(L, 1, 20);
+	const auto foldedPath = getString(L, 2, "lua_profile.folded");
+	const auto &profiler = g_luaProfiler();
+	profiler.dump(topCount, foldedPath);
+
+	const auto scripts = profiler.getScripts(topCount);
+	lua_createtable(L, scripts.size(), 0);
+	int index = 0;
+	for (const auto &stats : scripts) {
+		lua_createtable(L, 0, 4);
+		setField(L, "name", stats.name);
+		setField(L, "calls", stats.calls);
+		setField(L, "totalMs", std::chrono::duration_cast<std::chrono::microseconds>(stats.total).count() / 1000.0);
+		setField(L, "maxMs", std::chrono::duration_cast<std::chrono::microseconds>(stats.max).count() / 1000.0);
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
+
+int GameFunctions::luaGameDumpSlowTasks(lua_State* L) {
+	// Game.dumpSlowTasks([minutes = 1])
+	// Logs the slowest dispatcher tasks and returns the ones of the most recent minute
+	const auto &taskTracer = g_dispatcher().getTaskTracer();
+	taskTracer.dump(getNumber<uint32_t>(L, 1, 1));
+
+	const auto minutes = taskTracer.getMinutes();
+	if (minutes.empty()) {
+		lua_newtable(L);
+		return 1;
+	}
+
+	const auto &slowest = minutes.front().slowest;
+	lua_createtable(L, slowest.size(), 0);
+	int index = 0;
+	for (const auto &task : slowest) {
+		lua_createtable(L, 0, 3);
+		setField(L, "context", task.context);
+		setField(L, "durationMs", std::chrono::duration<double, std::milli>(task.duration).count());
+		setField(L, "waitMs", std::chrono::duration<double, std::milli>(task.wait).count());
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
+
 int GameFunctions::luaGameHasEffect(lua_State* L) {
 	// Game.hasEffect(effectId)
 	uint16_t effectId = getNumber<uint16_t>(L, 1);
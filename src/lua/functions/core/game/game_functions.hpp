@@ -29,6 +29,7 @@ public:
 		registerMethod(L, "Game", "loadMapChunk", GameFunctions::luaGameloadMapChunk);
 
 		registerMethod(L, "Game", "getExperienceForLevel", GameFunctions::luaGameGetExperienceForLevel);
+		registerMethod(L, "Game", "getStorageKey", GameFunctions::luaGameGetStorageKey);
 		registerMethod(L, "Game", "getMonsterCount", GameFunctions::luaGameGetMonsterCount);
 		registerMethod(L, "Game", "getPlayerCount", GameFunctions::luaGameGetPlayerCount);
 		registerMethod(L, "Game", "getNpcCount", GameFunctions::luaGameGetNpcCount);
@@ -62,6 +63,12 @@ public:
 		registerMethod(L, "Game", "getClientVersion", GameFunctions::luaGameGetClientVersion);
 
 		registerMethod(L, "Game", "reload", GameFunctions::luaGameReload);
+		registerMethod(L, "Game", "runMemoryCensus", GameFunctions::luaGameRunMemoryCensus);
+		registerMethod(L, "Game", "startLuaProfiler", GameFunctions::luaGameStartLuaProfiler);
+		registerMethod(L, "Game", "stopLuaProfiler", GameFunctions::luaGameStopLuaProfiler);
+		registerMethod(L, "Game", "resetLuaProfiler", GameFunctions::luaGameResetLuaProfiler);
+		registerMethod(L, "Game", "dumpLuaProfiler", GameFunctions::luaGameDumpLuaProfiler);
+		registerMethod(L, "Game", "dumpSlowTasks", GameFunctions::luaGameDumpSlowTasks);
 
 		registerMethod(L, "Game", "hasDistanceEffect", GameFunctions::luaGameHasDistanceEffect);
 		registerMethod(L, "Game", "hasEffect", GameFunctions::luaGameHasEffect);
@@ -105,6 +112,7 @@ private:
 	static int luaGameloadMapChunk(lua_State* L);
 
 	static int luaGameGetExperienceForLevel(lua_State* L);
+	static int luaGameGetStorageKey(lua_State* L);
 	static int luaGameGetMonsterCount(lua_State* L);
 	static int luaGameGetPlayerCount(lua_State* L);
 	static int luaGameGetNpcCount(lua_State* L);
@@ -138,6 +146,12 @@ private:
 	static int luaGameGetClientVersion(lua_State* L);
 
 	static int luaGameReload(lua_State* L);
+	static int luaGameRunMemoryCensus(lua_State* L);
+	static int luaGameStartLuaProfiler(lua_State* L);
+	static int luaGameStopLuaProfiler(lua_State* L);
+	static int luaGameResetLuaProfiler(lua_State* L);
+	static int luaGameDumpLuaProfiler(lua_State* L);
+	static int luaGameDumpSlowTasks(lua_State* L);
 
 	static int luaGameGetOfflinePlayer(lua_State* L);
 	static int luaGameGetNormalizedPlayerName(lua_State* L);
@@ -705,6 +705,45 @@ int GlobalFunctions::luaStopEvent(lua_State* L) {
 	return 1;
 }
 
+int GlobalFunctions::luaStartCoroutine(lua_State* L) {
+	// startCoroutine(callback, ...)
+	lua_State* globalState = g_luaEnvironment().getLuaState();
+	if (!globalState) {
+		reportErrorFunc("No valid script interface!");
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	if (!isFunction(L, 1)) {
+		reportErrorFunc("callback parameter should be a function.");
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	const int arguments = lua_gettop(L) - 1;
+	const uint32_t id = g_luaEnvironment().coroutineScheduler.start(L, globalState, arguments, getScriptEnv()->getScriptId());
+	lua_pushnumber(L, id);
+	return 1;
+}
+
+int GlobalFunctions::luaStopCoroutine(lua_State* L) {
+	// stopCoroutine(coroutineId)
+	pushBoolean(L, g_luaEnvironment().coroutineScheduler.stop(getNumber<uint32_t>(L, 1)));
+	return 1;
+}
+
+int GlobalFunctions::luaWait(lua_State* L) {
+	// wait(<optional: default: 0> ms)
+	if (!g_luaEnvironment().coroutineScheduler.isCoroutine(L)) {
+		return luaL_error(L, "wait can only be called from a function started with startCoroutine");
+	}
+
+	const auto delay = getNumber<int64_t>(L, 1, 0);
+	lua_settop(L, 0);
+	lua_pushnumber(L, delay);
+	return lua_yield(L, 1);
+}
+
 int GlobalFunctions::luaSaveServer(lua_State* L) {
 	g_saveManager().scheduleAll();
 	pushBoolean(L, true);
@@ -712,7 +751,12 @@ int GlobalFunctions::luaSaveServer(lua_State* L) {
 }
 
 int GlobalFunctions::luaCleanMap(lua_State* L) {
-	lua_pushnumber(L, g_game().map.clean());
+	// cleanMap([inSlices = false])
+	if (getBoolean(L, 1, false)) {
+		lua_pushnumber(L, g_game().map.cleanInSlices());
+	} else {
+		lua_pushnumber(L, g_game().map.clean());
+	}
 	return 1;
 }
 
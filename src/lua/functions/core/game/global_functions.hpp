@@ -41,7 +41,10 @@ public:
 		lua_register(L, "saveServer", GlobalFunctions::luaSaveServer);
 		lua_register(L, "sendChannelMessage", GlobalFunctions::luaSendChannelMessage);
 		lua_register(L, "sendGuildChannelMessage", GlobalFunctions::luaSendGuildChannelMessage);
+		lua_register(L, "startCoroutine", GlobalFunctions::luaStartCoroutine);
+		lua_register(L, "stopCoroutine", GlobalFunctions::luaStopCoroutine);
 		lua_register(L, "stopEvent", GlobalFunctions::luaStopEvent);
+		lua_register(L, "wait", GlobalFunctions::luaWait);
 
 		registerGlobalVariable(L, "INDEX_WHEREEVER", INDEX_WHEREEVER);
 		registerGlobalBoolean(L, "VIRTUAL_PARENT", true);
@@ -81,7 +84,10 @@ private:
 	static int luaSaveServer(lua_State* L);
 	static int luaSendChannelMessage(lua_State* L);
 	static int luaSendGuildChannelMessage(lua_State* L);
+	static int luaStartCoroutine(lua_State* L);
+	static int luaStopCoroutine(lua_State* L);
 	static int luaStopEvent(lua_State* L);
+	static int luaWait(lua_State* L);
 	static int luaIsType(lua_State* L);
 	static int luaRawGetMetatable(lua_State* L);
 	static int luaCreateTable(lua_State* L);
@@ -539,6 +539,7 @@ int CreatureFunctions::luaCreatureSetMaxHealth(lua_State* L) {
 
 	std::shared_ptr<Player> player = creature->getPlayer();
 	if (player) {
+		player->journalExperience(true);
 		player->sendStats();
 	}
 	pushBoolean(L, true);
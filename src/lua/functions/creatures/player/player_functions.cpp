@@ -588,6 +588,7 @@ int PlayerFunctions::luaPlayerSetCapacity(lua_State* L) {
 	std::shared_ptr<Player> player = getUserdataShared<Player>(L, 1);
 	if (player) {
 		player->capacity = getNumber<uint32_t>(L, 2);
+		player->journalExperience(true);
 		player->sendStats();
 		pushBoolean(L, true);
 	} else {
@@ -1035,6 +1036,7 @@ int PlayerFunctions::luaPlayerSetMaxMana(lua_State* L) {
 
 	player->manaMax = getNumber<int32_t>(L, 2);
 	player->mana = std::min<int32_t>(player->mana, player->manaMax);
+	player->journalExperience(true);
 	g_game().addPlayerMana(player);
 	player->sendStats();
 	pushBoolean(L, true);
@@ -1155,6 +1157,7 @@ int PlayerFunctions::luaPlayerSetLevel(lua_State* L) {
 		uint16_t level = getNumber<uint16_t>(L, 2);
 		player->level = level;
 		player->experience = Player::getExpForLevel(level);
+		player->journalExperience(true);
 		player->sendStats();
 		player->sendSkills();
 		pushBoolean(L, true);
@@ -0,0 +1,221 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lua/global/lua_coroutine_scheduler.hpp"
+#include "lua/scripts/lua_environment.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+#include "lua/scripts/script_environment.hpp"
+
+uint32_t LuaCoroutineScheduler::start(lua_State* L, lua_State* luaState, int arguments, int32_t scriptId) {
+	globalState = luaState;
+
+	// Anchored by a single reference until it finishes, however often it waits
+	lua_State* thread = lua_newthread(globalState);
+	const int32_t ref = luaL_ref(globalState, LUA_REGISTRYINDEX);
+	lua_xmove(L, thread, arguments + 1);
+
+	const uint32_t id = ++lastCoroutineId;
+	coroutines.emplace(id, Coroutine { thread, ref, scriptId });
+	threads.emplace(thread, id);
+
+	resume(id, arguments);
+	updateMetrics();
+	return coroutines.contains(id) ? id : 0;
+}
+
+bool LuaCoroutineScheduler::stop(uint32_t id) {
+	auto it = coroutines.find(id);
+	if (it == coroutines.end()) {
+		return false;
+	}
+
+	// Its parked entry is skipped once due
+	if (std::ranges::find(running, id) != running.end()) {
+		stopRequested.insert(id);
+	} else {
+		finish(id);
+	}
+	updateMetrics();
+	return true;
+}
+
+void LuaCoroutineScheduler::clear() {
+	coroutines.clear();
+	threads.clear();
+	parked = {};
+	running.clear();
+	stopRequested.clear();
+	if (tickEventId != 0 && !LuaEnvironment::isShuttingDown()) {
+		g_dispatcher().stopEvent(tickEventId);
+	}
+	tickEventId = 0;
+	tickAt = 0;
+	globalState = nullptr;
+	updateMetrics();
+}
+
+void LuaCoroutineScheduler::resume(uint32_t id, int arguments) {
+	auto it = coroutines.find(id);
+	if (it == coroutines.end()) {
+		return;
+	}
+
+	LuaEnvironment &luaEnvironment = g_luaEnvironment();
+	if (!LuaScriptInterface::reserveScriptEnv()) {
+		LuaScriptInterface::resetScriptEnv();
+		g_logger().error("[LuaCoroutineScheduler::resume] Call stack overflow. Too many lua script calls being nested");
+		finish(id);
+		return;
+	}
+
+	ScriptEnvironment* env = LuaScriptInterface::getScriptEnv();
+	env->setTimerEvent();
+	env->setScriptId(it->second.scriptId, &luaEnvironment);
+
+	lua_State* thread = it->second.thread;
+	const int32_t ref = it->second.ref;
+	running.push_back(id);
+	int status;
+	{
+		LuaProfiler::ScopedCall profile;
+		status = lua_resume(thread, arguments);
+	}
+	running.pop_back();
+
+	// Coroutines started meanwhile may have moved the entry
+	it = coroutines.find(id);
+	if (it == coroutines.end()) {
+		LuaScriptInterface::resetScriptEnv();
+		return;
+	}
+
+	if (status == LUA_YIELD && !stopRequested.contains(id)) {
+		// wait(ms) yields the delay, a plain coroutine.yield() sleeps until the next tick
+		const int64_t delay = lua_gettop(thread) > 0 && lua_isnumber(thread, -1) ? lua_tointeger(thread, -1) : 0;
+		lua_settop(thread, 0);
+		park(id, it->second, delay);
+	} else {
+		if (status != LUA_YIELD && status != 0) {
+			reportError(thread, ref);
+		}
+		finish(id);
+	}
+
+	LuaScriptInterface::resetScriptEnv();
+}
+
+void LuaCoroutineScheduler::reportError(lua_State* thread, int32_t ref) const {
+	const char* error = lua_tostring(thread, -1);
+	std::string message = error ? error : "unknown error";
+
+	// The failed thread keeps its stack, the trace is taken from it
+	lua_getglobal(globalState, "debug");
+	if (lua_istable(globalState, -1)) {
+		lua_getfield(globalState, -1, "traceback");
+		lua_rawgeti(globalState, LUA_REGISTRYINDEX, ref);
+		LuaScriptInterface::pushString(globalState, message);
+		if (lua_pcall(globalState, 2, 1, 0) == 0 && lua_isstring(globalState, -1)) {
+			message = lua_tostring(globalState, -1);
+		}
+		lua_pop(globalState, 1);
+	}
+	lua_pop(globalState, 1);
+
+	LuaScriptInterface::reportError(nullptr, message);
+}
+
+void LuaCoroutineScheduler::resumeDue() {
+	tickEventId = 0;
+	tickAt = 0;
+
+	metrics::lua_latency measure("coroutines");
+	const int64_t now = OTSYS_TIME();
+	int64_t maxDelay = 0;
+
+	// Coroutines that wait again during the batch are parked past now and picked up by the next tick
+	std::vector<uint32_t> due;
+	while (!parked.empty() && parked.top().wakeAt <= now) {
+		const auto entry = parked.top();
+		parked.pop();
+
+		auto it = coroutines.find(entry.id);
+		if (it == coroutines.end() || it->second.wakeAt != entry.wakeAt) {
+			continue;
+		}
+		maxDelay = std::max(maxDelay, now - entry.wakeAt);
+		due.push_back(entry.id);
+	}
+
+	for (const uint32_t id : due) {
+		resume(id, 0);
+	}
+
+	g_metrics().setGauge("lua_coroutine_resume_delay_ms", maxDelay);
+	updateMetrics();
+	scheduleTick();
+}
+
+void LuaCoroutineScheduler::park(uint32_t id, Coroutine &coroutine, int64_t delay) {
+	coroutine.wakeAt = OTSYS_TIME() + std::max<int64_t>(0, delay);
+	parked.push({ coroutine.wakeAt, ++parkSequence, id });
+	scheduleTick();
+}
+
+void LuaCoroutineScheduler::finish(uint32_t id) {
+	auto it = coroutines.find(id);
+	if (it == coroutines.end()) {
+		return;
+	}
+
+	if (globalState) {
+		luaL_unref(globalState, LUA_REGISTRYINDEX, it->second.ref);
+	}
+	threads.erase(it->second.thread);
+	stopRequested.erase(id);
+	coroutines.erase(it);
+}
+
+void LuaCoroutineScheduler::scheduleTick() {
+	// Drop stopped coroutines so they don't keep the tick alive
+	while (!parked.empty() && !coroutines.contains(parked.top().id)) {
+		parked.pop();
+	}
+	if (parked.empty()) {
+		if (tickEventId != 0) {
+			g_dispatcher().stopEvent(tickEventId);
+			tickEventId = 0;
+			tickAt = 0;
+		}
+		return;
+	}
+
+	const int64_t now = OTSYS_TIME();
+	const int64_t wakeAt = std::max(parked.top().wakeAt, now + TICK_INTERVAL);
+	if (tickEventId != 0) {
+		if (tickAt <= wakeAt) {
+			return;
+		}
+		g_dispatcher().stopEvent(tickEventId);
+	}
+
+	tickAt = wakeAt;
+	tickEventId = g_dispatcher().scheduleEvent(
+		static_cast<uint32_t>(wakeAt - now),
+		[this] { resumeDue(); },
+		"LuaCoroutineScheduler::resumeDue"
+	);
+}
+
+void LuaCoroutineScheduler::updateMetrics() const {
+	g_metrics().setGauge("lua_coroutines_live", static_cast<int64_t>(coroutines.size()));
+}
@@ -0,0 +1,92 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Runs Lua functions as coroutines that can sleep with wait(ms).
+ *
+ * Unlike addEvent, a sleeping coroutine keeps its locals on its own stack: it holds a single
+ * registry reference for its whole life and is parked in a min-heap instead of getting a
+ * dispatcher task per wait. One dispatcher task resumes every coroutine that is due, and is
+ * only scheduled while something is parked.
+ */
+class LuaCoroutineScheduler {
+public:
+	// Sleeping coroutines are resumed in batches, never sooner than this after each other
+	static constexpr int64_t TICK_INTERVAL = 50;
+
+	LuaCoroutineScheduler() = default;
+
+	// non-copyable
+	LuaCoroutineScheduler(const LuaCoroutineScheduler &) = delete;
+	LuaCoroutineScheduler &operator=(const LuaCoroutineScheduler &) = delete;
+
+	/**
+	 * Starts the function with its arguments at the top of the stack of L, popping them.
+	 * The coroutine runs until it waits or finishes before this returns.
+	 * @return The coroutine id, 0 if it already finished or failed.
+	 */
+	uint32_t start(lua_State* L, lua_State* luaState, int arguments, int32_t scriptId);
+	bool stop(uint32_t id);
+
+	bool isCoroutine(lua_State* L) const {
+		return threads.contains(L);
+	}
+
+	size_t size() const {
+		return coroutines.size();
+	}
+
+	// The Lua state is being closed, it frees the threads itself
+	void clear();
+
+	// Run by the dispatcher tick, resumes every coroutine that is due
+	void resumeDue();
+
+private:
+	struct Coroutine {
+		lua_State* thread = nullptr;
+		int32_t ref = -1;
+		int32_t scriptId = -1;
+		int64_t wakeAt = 0;
+	};
+
+	struct Parked {
+		int64_t wakeAt;
+		uint64_t sequence;
+		uint32_t id;
+
+		bool operator>(const Parked &other) const {
+			return std::tie(wakeAt, sequence) > std::tie(other.wakeAt, other.sequence);
+		}
+	};
+
+	void resume(uint32_t id, int arguments);
+	void reportError(lua_State* thread, int32_t ref) const;
+	void park(uint32_t id, Coroutine &coroutine, int64_t delay);
+	void finish(uint32_t id);
+	void scheduleTick();
+	void updateMetrics() const;
+
+	lua_State* globalState = nullptr;
+	phmap::flat_hash_map<uint32_t, Coroutine> coroutines;
+	phmap::flat_hash_map<lua_State*, uint32_t> threads;
+	// Stopped coroutines leave their entry behind, skipped when it comes up
+	std::priority_queue<Parked, std::vector<Parked>, std::greater<>> parked;
+	uint64_t parkSequence = 0;
+	uint32_t lastCoroutineId = 0;
+
+	// Coroutines being resumed, innermost last; stopping one of them finishes it once it yields
+	std::vector<uint32_t> running;
+	phmap::flat_hash_set<uint32_t> stopRequested;
+
+	uint64_t tickEventId = 0;
+	int64_t tickAt = 0;
+};
@@ -0,0 +1,222 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/scripts/lua_bytecode_cache.hpp"
+
+#include "config/configmanager.hpp"
+#include "lib/di/container.hpp"
+
+namespace {
+	constexpr std::array<char, 4> CACHE_MAGIC = { 'C', 'L', 'B', 'C' };
+	constexpr uint32_t CACHE_FORMAT = 1;
+#ifdef LUAJIT_VERSION_NUM
+	constexpr uint32_t LUA_BUILD = LUAJIT_VERSION_NUM;
+#else
+	constexpr uint32_t LUA_BUILD = LUA_VERSION_NUM;
+#endif
+
+	// Written as is, the cache is only meant to be read by the build that wrote it
+	struct CacheHeader {
+		std::array<char, 4> magic = CACHE_MAGIC;
+		uint32_t format = CACHE_FORMAT;
+		uint32_t luaBuild = LUA_BUILD;
+		uint32_t pointerSize = sizeof(void*);
+		int64_t modifiedTime = 0;
+		uint64_t sourceSize = 0;
+		uint64_t sourceHash = 0;
+		uint64_t compileMicroseconds = 0;
+		uint32_t pathLength = 0;
+	};
+
+	// FNV-1a, stable across runs and builds unlike std::hash
+	uint64_t hashBytes(std::string_view data) {
+		uint64_t hash = 0xCBF29CE484222325ULL;
+		for (const char c : data) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 0x100000001B3ULL;
+		}
+		return hash;
+	}
+
+	bool readFile(const std::filesystem::path &path, std::string &content) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			return false;
+		}
+
+		content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return !file.bad();
+	}
+
+	// Returns the bytecode stored after the header, or an empty view if the cache file is not for this file and build
+	std::string_view parseCacheFile(const std::string &content, const std::string &file, CacheHeader &header) {
+		if (content.size() < sizeof(CacheHeader)) {
+			return {};
+		}
+
+		memcpy(&header, content.data(), sizeof(CacheHeader));
+		if (header.magic != CACHE_MAGIC || header.format != CACHE_FORMAT || header.luaBuild != LUA_BUILD || header.pointerSize != sizeof(void*)) {
+			return {};
+		}
+		if (content.size() < sizeof(CacheHeader) + header.pathLength || std::string_view(content).substr(sizeof(CacheHeader), header.pathLength) != file) {
+			return {};
+		}
+		return std::string_view(content).substr(sizeof(CacheHeader) + header.pathLength);
+	}
+
+	void writeCacheFile(const std::filesystem::path &cachePath, const CacheHeader &header, const std::string &file, std::string_view bytecode) {
+		std::error_code ec;
+		std::filesystem::create_directories(cachePath.parent_path(), ec);
+
+		// Written aside and renamed, so a crash never leaves a truncated cache file behind
+		auto tempPath = cachePath;
+		tempPath += ".tmp";
+		{
+			std::ofstream cacheFile(tempPath, std::ios::binary | std::ios::trunc);
+			if (!cacheFile.is_open()) {
+				g_logger().debug("[LuaBytecodeCache] Cannot write cache file {}", cachePath.string());
+				return;
+			}
+			cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+			cacheFile.write(file.data(), static_cast<std::streamsize>(file.size()));
+			cacheFile.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+		}
+		std::filesystem::rename(tempPath, cachePath, ec);
+	}
+
+	int bytecodeWriter(lua_State*, const void* data, size_t size, void* userData) {
+		static_cast<std::string*>(userData)->append(static_cast<const char*>(data), size);
+		return 0;
+	}
+
+	std::chrono::microseconds elapsedSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	}
+}
+
+LuaBytecodeCache &LuaBytecodeCache::getInstance() {
+	return inject<LuaBytecodeCache>();
+}
+
+int LuaBytecodeCache::load(lua_State* L, const std::string &file) {
+	if (!g_configManager().getBoolean(LUA_BYTECODE_CACHE, __FUNCTION__)) {
+		return luaL_loadfile(L, file.c_str());
+	}
+	return load(L, file, g_configManager().getString(LUA_BYTECODE_CACHE_DIRECTORY, __FUNCTION__));
+}
+
+int LuaBytecodeCache::load(lua_State* L, const std::string &file, const std::filesystem::path &cacheDirectory) {
+	std::error_code ec;
+	const auto sourceSize = std::filesystem::file_size(file, ec);
+	const auto lastWriteTime = ec ? std::filesystem::file_time_type {} : std::filesystem::last_write_time(file, ec);
+	if (ec) {
+		// Let luaL_loadfile report the error
+		return luaL_loadfile(L, file.c_str());
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const int64_t modifiedTime = lastWriteTime.time_since_epoch().count();
+	const auto cachePath = cacheDirectory / fmt::format("{:016x}.luac", hashBytes(file));
+
+	std::string cacheContent;
+	CacheHeader header;
+	std::string_view bytecode;
+	if (readFile(cachePath, cacheContent)) {
+		bytecode = parseCacheFile(cacheContent, file, header);
+	}
+
+	// Unchanged size and modification time: trust the cache without reading the source
+	bool valid = !bytecode.empty() && header.sourceSize == sourceSize && header.modifiedTime == modifiedTime;
+	std::string source;
+	uint64_t sourceHash = 0;
+	if (!valid) {
+		if (!readFile(file, source)) {
+			return luaL_loadfile(L, file.c_str());
+		}
+		sourceHash = hashBytes(source);
+		valid = !bytecode.empty() && header.sourceSize == source.size() && header.sourceHash == sourceHash;
+	}
+
+	if (valid) {
+		const std::string chunkName = "@" + file;
+		if (luaL_loadbuffer(L, bytecode.data(), bytecode.size(), chunkName.c_str()) == 0) {
+			if (header.modifiedTime != modifiedTime) {
+				// Same content with a new modification time, keep the fast path for the next load
+				header.modifiedTime = modifiedTime;
+				writeCacheFile(cachePath, header, file, bytecode);
+			}
+
+			++cachedFiles;
+			savedTime += std::max(std::chrono::microseconds(header.compileMicroseconds) - elapsedSince(start), std::chrono::microseconds(0));
+			return 0;
+		}
+
+		// Unreadable bytecode (e.g. written by another LuaJIT build), compile it again
+		lua_pop(L, 1);
+		if (source.empty()) {
+			if (!readFile(file, source)) {
+				return luaL_loadfile(L, file.c_str());
+			}
+			sourceHash = hashBytes(source);
+		}
+	}
+
+	return loadFromSource(L, file, source, cachePath, modifiedTime, sourceHash);
+}
+
+int LuaBytecodeCache::loadFromSource(lua_State* L, const std::string &file, const std::string &source, const std::filesystem::path &cachePath, int64_t modifiedTime, uint64_t sourceHash) {
+	const auto start = std::chrono::steady_clock::now();
+	const std::string chunkName = "@" + file;
+	// Skips a leading #! line like luaL_loadfile, keeping its newline so the line numbers don't change
+	std::string_view code = source;
+	if (code.starts_with('#')) {
+		code = code.substr(std::min(code.find('\n'), code.size()));
+	}
+	const int ret = luaL_loadbuffer(L, code.data(), code.size(), chunkName.c_str());
+	if (ret != 0) {
+		return ret;
+	}
+
+	const auto elapsed = elapsedSince(start);
+	++compiledFiles;
+	compileTime += elapsed;
+
+	std::string bytecode;
+#if LUA_VERSION_NUM >= 503
+	const int dumped = lua_dump(L, bytecodeWriter, &bytecode, 0);
+#else
+	const int dumped = lua_dump(L, bytecodeWriter, &bytecode);
+#endif
+	if (dumped != 0 || bytecode.empty()) {
+		return 0;
+	}
+
+	CacheHeader header;
+	header.modifiedTime = modifiedTime;
+	header.sourceSize = source.size();
+	header.sourceHash = sourceHash;
+	header.compileMicroseconds = static_cast<uint64_t>(elapsed.count());
+	header.pathLength = static_cast<uint32_t>(file.size());
+	writeCacheFile(cachePath, header, file, bytecode);
+	return 0;
+}
+
+void LuaBytecodeCache::logReport(std::string_view context) {
+	if (compiledFiles == 0 && cachedFiles == 0) {
+		return;
+	}
+
+	g_logger().info("Lua bytecode cache ({}): {} files compiled in {} ms, {} loaded from cache, about {} ms saved", context, compiledFiles, compileTime.count() / 1000, cachedFiles, savedTime.count() / 1000);
+	compiledFiles = 0;
+	cachedFiles = 0;
+	compileTime = std::chrono::microseconds(0);
+	savedTime = std::chrono::microseconds(0);
+}
@@ -0,0 +1,62 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Persistent cache of compiled Lua chunks.
+ *
+ * Each source file has one cache file holding its path, modification time, size,
+ * content hash and the bytecode dumped after compiling it. The bytecode is used
+ * when the path, size and modification time still match, or when the content hash
+ * matches (e.g. the file was touched but not changed). Anything else, including a
+ * different Lua/LuaJIT version, compiles from source and rewrites the cache file.
+ */
+class LuaBytecodeCache {
+public:
+	LuaBytecodeCache() = default;
+
+	// Singleton - ensures we don't accidentally copy it
+	LuaBytecodeCache(const LuaBytecodeCache &) = delete;
+	void operator=(const LuaBytecodeCache &) = delete;
+
+	static LuaBytecodeCache &getInstance();
+
+	/**
+	 * Same contract as luaL_loadfile: pushes the chunk as a function and returns 0,
+	 * or pushes the error message and returns the Lua error code.
+	 */
+	int load(lua_State* L, const std::string &file);
+	// Same, with the cache in cacheDirectory whatever the config says
+	int load(lua_State* L, const std::string &file, const std::filesystem::path &cacheDirectory);
+
+	/**
+	 * Logs the files compiled and loaded from cache since the last report, and the
+	 * compile time saved. Does nothing if no file was loaded.
+	 */
+	void logReport(std::string_view context);
+
+	// Files compiled and loaded from cache since the last report
+	uint32_t getCompiledFiles() const {
+		return compiledFiles;
+	}
+	uint32_t getCachedFiles() const {
+		return cachedFiles;
+	}
+
+private:
+	int loadFromSource(lua_State* L, const std::string &file, const std::string &source, const std::filesystem::path &cachePath, int64_t modifiedTime, uint64_t sourceHash);
+
+	uint32_t compiledFiles = 0;
+	uint32_t cachedFiles = 0;
+	std::chrono::microseconds compileTime { 0 };
+	std::chrono::microseconds savedTime { 0 };
+};
+
+constexpr auto g_luaBytecodeCache = LuaBytecodeCache::getInstance;
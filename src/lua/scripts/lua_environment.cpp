@@ -12,6 +12,7 @@
 #include "declarations.hpp"
 #include "lua/scripts/lua_environment.hpp"
 #include "lua/functions/lua_functions_loader.hpp"
+#include "lua/scripts/lua_profiler.hpp"
 #include "lua/scripts/script_environment.hpp"
 #include "lua/global/lua_timer_event_descr.hpp"
 
@@ -80,8 +81,13 @@ bool LuaEnvironment::closeState() {
 	combatIdMap.clear();
 	areaIdMap.clear();
 	timerEvents.clear();
+	coroutineScheduler.clear();
 	cacheFiles.clear();
 
+	if (!LuaEnvironment::isShuttingDown()) {
+		g_luaProfiler().stopSampling();
+	}
+
 	lua_close(luaState);
 	luaState = nullptr;
 	return true;
@@ -14,6 +14,7 @@
 #include "lua/scripts/luascript.hpp"
 #include "items/weapons/weapons.hpp"
 
+#include "lua/global/lua_coroutine_scheduler.hpp"
 #include "lua/global/lua_timer_event_descr.hpp"
 
 class AreaCombat;
@@ -92,6 +93,8 @@ private:
 	phmap::flat_hash_map<uint32_t, LuaTimerEventDesc> timerEvents;
 	uint32_t lastEventTimerId = 1;
 
+	LuaCoroutineScheduler coroutineScheduler;
+
 	phmap::flat_hash_map<uint32_t, std::unique_ptr<AreaCombat>> areaMap;
 	phmap::flat_hash_map<LuaScriptInterface*, std::vector<uint32_t>> areaIdMap;
 	uint32_t lastAreaId = 0;
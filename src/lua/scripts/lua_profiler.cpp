@@ -0,0 +1,240 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "lua/scripts/lua_profiler.hpp"
+
+#include "lib/di/container.hpp"
+#include "lib/metrics/metrics.hpp"
+#include "lua/scripts/luascript.hpp"
+#include "lua/scripts/script_environment.hpp"
+
+#if defined(LUAJIT_VERSION_NUM) && LUAJIT_VERSION_NUM >= 20100
+	#define LUA_PROFILER_SAMPLING
+#endif
+
+namespace {
+	// Deeper frames are dropped from the sampled stacks
+	constexpr int MAX_SAMPLED_DEPTH = 64;
+}
+
+LuaProfiler::ScopedCall::ScopedCall() :
+	begin(std::chrono::steady_clock::now()) {
+	bool timerEvent;
+	int32_t callbackId;
+	LuaScriptInterface::getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+}
+
+LuaProfiler::ScopedCall::~ScopedCall() {
+	g_luaProfiler().record(scriptInterface, scriptId, std::chrono::steady_clock::now() - begin);
+}
+
+LuaProfiler &LuaProfiler::getInstance() {
+	return inject<LuaProfiler>();
+}
+
+void LuaProfiler::record(LuaScriptInterface* scriptInterface, int32_t scriptId, std::chrono::nanoseconds elapsed) {
+	auto &stats = getStats(scriptInterface, scriptId);
+	++stats.calls;
+	stats.total += elapsed;
+	stats.max = std::max(stats.max, elapsed);
+}
+
+void LuaProfiler::forget(const LuaScriptInterface* scriptInterface) {
+	phmap::erase_if(scriptsById, [scriptInterface](const auto &entry) {
+		return entry.first.first == scriptInterface;
+	});
+}
+
+bool LuaProfiler::startSampling(lua_State* L, uint32_t intervalMs) {
+#ifdef LUA_PROFILER_SAMPLING
+	if (!L) {
+		return false;
+	}
+
+	stopSampling();
+	// Line granularity, so samples can be attributed to file:line
+	const auto mode = fmt::format("li{}", std::max<uint32_t>(1, intervalMs));
+	luaJIT_profile_start(L, mode.c_str(), &LuaProfiler::onSample, this);
+	samplingState = L;
+	g_logger().info("[LuaProfiler] Sampling Lua every {} ms", std::max<uint32_t>(1, intervalMs));
+	return true;
+#else
+	g_logger().warn("[LuaProfiler] Sampling needs LuaJIT 2.1, only script times are accounted");
+	return false;
+#endif
+}
+
+void LuaProfiler::stopSampling() {
+	if (!samplingState) {
+		return;
+	}
+
+#ifdef LUA_PROFILER_SAMPLING
+	luaJIT_profile_stop(samplingState);
+#endif
+	samplingState = nullptr;
+}
+
+void LuaProfiler::reset() {
+	scripts.clear();
+	scriptsById.clear();
+	stacks.clear();
+	samples = 0;
+}
+
+std::vector<LuaProfiler::ScriptStats> LuaProfiler::getScripts(size_t topCount) const {
+	std::vector<ScriptStats> result;
+	result.reserve(scripts.size());
+	for (const auto &[_, stats] : scripts) {
+		result.push_back(stats);
+	}
+
+	const auto count = std::min(topCount, result.size());
+	std::partial_sort(result.begin(), result.begin() + count, result.end(), [](const auto &first, const auto &second) {
+		return first.total > second.total;
+	});
+	result.resize(count);
+	return result;
+}
+
+std::vector<std::pair<std::string, uint64_t>> LuaProfiler::getLines(size_t topCount) const {
+	// The innermost frame of a stack is the line that was running
+	phmap::flat_hash_map<std::string, uint64_t> lines;
+	for (const auto &[stack, count] : stacks) {
+		const auto separator = stack.rfind(';');
+		lines[separator == std::string::npos ? stack : stack.substr(separator + 1)] += count;
+	}
+
+	std::vector<std::pair<std::string, uint64_t>> result(lines.begin(), lines.end());
+	const auto count = std::min(topCount, result.size());
+	std::partial_sort(result.begin(), result.begin() + count, result.end(), [](const auto &first, const auto &second) {
+		return first.second > second.second;
+	});
+	result.resize(count);
+	return result;
+}
+
+void LuaProfiler::dump(size_t topCount, const std::string &foldedPath) const {
+	const auto topScripts = getScripts(topCount);
+	for (const auto &stats : topScripts) {
+		const std::map<std::string, std::string> attrs { { "script", stats.name } };
+		g_metrics().setGauge("lua_script_time_us", std::chrono::duration_cast<std::chrono::microseconds>(stats.total).count(), attrs);
+		g_metrics().setGauge("lua_script_calls", static_cast<int64_t>(stats.calls), attrs);
+	}
+	g_metrics().setGauge("lua_profiler_samples", static_cast<int64_t>(samples));
+
+	g_logger().info("[LuaProfiler] Slowest {} of {} scripts:", topScripts.size(), scripts.size());
+	for (const auto &stats : topScripts) {
+		const auto totalUs = std::chrono::duration_cast<std::chrono::microseconds>(stats.total).count();
+		g_logger().info(
+			"[LuaProfiler]   {}: {:.2f} ms in {} calls, {:.1f} us average, {:.2f} ms max",
+			stats.name, totalUs / 1000.0, stats.calls, static_cast<double>(totalUs) / std::max<uint64_t>(1, stats.calls),
+			std::chrono::duration_cast<std::chrono::microseconds>(stats.max).count() / 1000.0
+		);
+	}
+
+	if (samples == 0) {
+		return;
+	}
+
+	g_logger().info("[LuaProfiler] Hottest lines of {} samples:", samples);
+	for (const auto &[line, count] : getLines(topCount)) {
+		g_logger().info("[LuaProfiler]   {}: {} samples ({:.1f}%)", line, count, count * 100.0 / samples);
+	}
+
+	if (!foldedPath.empty() && writeFolded(foldedPath)) {
+		g_logger().info("[LuaProfiler] Sampled stacks written to {}", foldedPath);
+	}
+}
+
+bool LuaProfiler::writeFolded(const std::string &path) const {
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file.is_open()) {
+		g_logger().error("[LuaProfiler] Unable to open {} for writing", path);
+		return false;
+	}
+
+	for (const auto &[stack, count] : stacks) {
+		file << stack << ' ' << count << '\n';
+	}
+	return file.good();
+}
+
+void LuaProfiler::onSample(void* data, lua_State* L, int count, int vmState) {
+#ifdef LUA_PROFILER_SAMPLING
+	auto &profiler = *static_cast<LuaProfiler*>(data);
+
+	int32_t scriptId;
+	int32_t callbackId;
+	bool timerEvent;
+	LuaScriptInterface* scriptInterface;
+	LuaScriptInterface::getScriptEnv()->getEventInfo(scriptId, scriptInterface, callbackId, timerEvent);
+
+	// Root frame is the script that was called, then the Lua stack outermost first
+	size_t length = 0;
+	const char* dumped = luaJIT_profile_dumpstack(L, "lZ;", -MAX_SAMPLED_DEPTH, &length);
+	std::string stack = getScriptName(scriptInterface, scriptId);
+	if (length > 0) {
+		stack += ';';
+		stack.append(dumped, length);
+	}
+	if (vmState == 'G') {
+		stack += ";[gc]";
+	} else if (vmState == 'J') {
+		stack += ";[jit]";
+	}
+	// Frames are separated by ';' and the count by the last space
+	std::ranges::replace(stack, ' ', '_');
+
+	profiler.stacks[stack] += count;
+	profiler.samples += count;
+#else
+	(void)data;
+	(void)L;
+	(void)count;
+	(void)vmState;
+#endif
+}
+
+std::string LuaProfiler::getScriptName(LuaScriptInterface* scriptInterface, int32_t scriptId) {
+	if (scriptId == EVENT_ID_LOADING) {
+		return "loading";
+	} else if (scriptId == EVENT_ID_USER) {
+		return "user";
+	} else if (!scriptInterface) {
+		return "unknown";
+	}
+
+	std::string name = scriptInterface->getFileById(scriptId);
+	if (name.empty()) {
+		return "unknown";
+	}
+	auto pos = name.find("data");
+	if (pos != std::string::npos) {
+		name = name.substr(pos);
+	}
+	return name;
+}
+
+LuaProfiler::ScriptStats &LuaProfiler::getStats(LuaScriptInterface* scriptInterface, int32_t scriptId) {
+	const ScriptKey key { scriptInterface, scriptId };
+	if (auto it = scriptsById.find(key); it != scriptsById.end()) {
+		return *it->second;
+	}
+
+	auto name = getScriptName(scriptInterface, scriptId);
+	auto it = scripts.find(name);
+	if (it == scripts.end()) {
+		it = scripts.emplace(name, ScriptStats { name }).first;
+	}
+	scriptsById.emplace(key, &it->second);
+	return it->second;
+}
@@ -0,0 +1,101 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class LuaScriptInterface;
+
+/**
+ * Accounts the time spent in each Lua script and samples where it is spent.
+ *
+ * Every call entering Lua through LuaScriptInterface adds its wall time to the script
+ * that was called. While sampling is on, LuaJIT's profiler interrupts the VM at a fixed
+ * interval and the Lua stack is recorded under the running script, so hot lines show up
+ * even inside scripts whose total time looks harmless. Sampling needs LuaJIT 2.1.
+ * Must be used from the dispatcher thread, which is the one running Lua.
+ */
+class LuaProfiler {
+public:
+	struct ScriptStats {
+		std::string name;
+		uint64_t calls = 0;
+		std::chrono::nanoseconds total { 0 };
+		std::chrono::nanoseconds max { 0 };
+	};
+
+	// Times the call to the script set in the current script environment
+	class ScopedCall {
+	public:
+		ScopedCall();
+		~ScopedCall();
+
+		// non-copyable
+		ScopedCall(const ScopedCall &) = delete;
+		ScopedCall &operator=(const ScopedCall &) = delete;
+
+	private:
+		std::chrono::steady_clock::time_point begin;
+		LuaScriptInterface* scriptInterface = nullptr;
+		int32_t scriptId = 0;
+	};
+
+	LuaProfiler() = default;
+
+	// Singleton - ensures we don't accidentally copy it
+	LuaProfiler(const LuaProfiler &) = delete;
+	void operator=(const LuaProfiler &) = delete;
+
+	static LuaProfiler &getInstance();
+
+	void record(LuaScriptInterface* scriptInterface, int32_t scriptId, std::chrono::nanoseconds elapsed);
+	// The interface's script ids are about to be reused
+	void forget(const LuaScriptInterface* scriptInterface);
+
+	bool startSampling(lua_State* L, uint32_t intervalMs);
+	void stopSampling();
+	bool isSampling() const {
+		return samplingState != nullptr;
+	}
+
+	void reset();
+
+	// Scripts by total time, slowest first
+	std::vector<ScriptStats> getScripts(size_t topCount) const;
+	// Sampled source lines by samples, hottest first
+	std::vector<std::pair<std::string, uint64_t>> getLines(size_t topCount) const;
+	uint64_t getSamples() const {
+		return samples;
+	}
+
+	/**
+	 * Exports the slowest scripts as metrics gauges, writes the samples as folded stacks
+	 * (one "frame;frame;frame count" line per stack, the input of flamegraph.pl and
+	 * speedscope) to the given path if not empty and logs a summary.
+	 */
+	void dump(size_t topCount, const std::string &foldedPath) const;
+	bool writeFolded(const std::string &path) const;
+
+private:
+	using ScriptKey = std::pair<const LuaScriptInterface*, int32_t>;
+
+	static void onSample(void* data, lua_State* L, int count, int vmState);
+	static std::string getScriptName(LuaScriptInterface* scriptInterface, int32_t scriptId);
+
+	ScriptStats &getStats(LuaScriptInterface* scriptInterface, int32_t scriptId);
+
+	// Keyed by name so the numbers survive reloads, which hand out new script ids
+	std::map<std::string, ScriptStats, std::less<>> scripts;
+	phmap::flat_hash_map<ScriptKey, ScriptStats*> scriptsById;
+
+	lua_State* samplingState = nullptr;
+	phmap::flat_hash_map<std::string, uint64_t> stacks;
+	uint64_t samples = 0;
+};
+
+constexpr auto g_luaProfiler = LuaProfiler::getInstance;
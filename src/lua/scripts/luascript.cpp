@@ -11,6 +11,8 @@
 
 #include "lua/scripts/luascript.hpp"
 #include "lua/scripts/lua_environment.hpp"
+#include "lua/scripts/lua_bytecode_cache.hpp"
+#include "lua/scripts/lua_profiler.hpp"
 #include "lib/metrics/metrics.hpp"
 
 ScriptEnvironment::DBResultMap ScriptEnvironment::tempResults;
@@ -39,7 +41,7 @@ bool LuaScriptInterface::reInitState() {
 /// Same as lua_pcall, but adds stack trace to error strings in called function.
 int32_t LuaScriptInterface::loadFile(const std::string &file, const std::string &scriptName) {
 	// loads file as a chunk at stack top
-	int ret = luaL_loadfile(luaState, file.c_str());
+	int ret = g_luaBytecodeCache().load(luaState, file);
 	if (ret != 0) {
 		lastLuaError = popString(luaState);
 		return -1;
@@ -227,6 +229,7 @@ bool LuaScriptInterface::closeState() {
 		return false;
 	}
 
+	g_luaProfiler().forget(this);
 	cacheFiles.clear();
 	if (eventTableRef != -1) {
 		luaL_unref(luaState, LUA_REGISTRYINDEX, eventTableRef);
@@ -266,6 +269,7 @@ std::string LuaScriptInterface::getMetricsScope() {
 
 bool LuaScriptInterface::callFunction(int params) {
 	metrics::lua_latency measure(getMetricsScope());
+	LuaProfiler::ScopedCall profile;
 	bool result = false;
 	int size = lua_gettop(luaState);
 	if (protectedCall(luaState, params, 1) != 0) {
@@ -285,6 +289,7 @@ bool LuaScriptInterface::callFunction(int params) {
 
 void LuaScriptInterface::callVoidFunction(int params) {
 	metrics::lua_latency measure(getMetricsScope());
+	LuaProfiler::ScopedCall profile;
 	int size = lua_gettop(luaState);
 	if (protectedCall(luaState, params, 0) != 0) {
 		LuaScriptInterface::reportError(nullptr, LuaScriptInterface::popString(luaState));
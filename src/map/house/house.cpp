@@ -88,6 +88,11 @@ bool House::tryTransferOwnership(std::shared_ptr<Player> player, bool serverStar
 }
 
 void House::setOwner(uint32_t guid, bool updateDatabase /* = true*/, std::shared_ptr<Player> player /* = nullptr*/) {
+	// Before the database is written, so a house save snapshotted earlier can tell
+	if (owner != guid) {
+		g_game().map.houses.onOwnerChanged();
+	}
+
 	if (updateDatabase && owner != guid) {
 		Database &db = Database::getInstance();
 
@@ -309,6 +309,15 @@ public:
 		return houseMap;
 	}
 
+	// Counts the owner changes, read by the house save running on another thread
+	void onOwnerChanged() {
+		ownerChanges.fetch_add(1, std::memory_order_acq_rel);
+	}
+	uint64_t getOwnerChanges() const {
+		return ownerChanges.load(std::memory_order_acquire);
+	}
+
 private:
 	HouseMap houseMap;
+	std::atomic<uint64_t> ownerChanges = 0;
 };
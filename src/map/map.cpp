@@ -130,19 +130,6 @@ void Map::loadHouseInfo() {
 	IOMapSerialize::loadHouseItems(this);
 }
 
-bool Map::save() {
-	bool saved = false;
-	for (uint32_t tries = 0; tries < 6; tries++) {
-		if (IOMapSerialize::saveHouseInfo()) {
-			saved = true;
-		}
-		if (saved && IOMapSerialize::saveHouseItems()) {
-			return true;
-		}
-	}
-	return false;
-}
-
 std::shared_ptr<Tile> Map::getOrCreateTile(uint16_t x, uint16_t y, uint8_t z, bool isDynamic) {
 	auto tile = getTile(x, y, z);
 	if (!tile) {
@@ -705,7 +692,14 @@ uint32_t Map::clean() {
 	ItemVector toRemove;
 	toRemove.reserve(128);
 
+	// Also finishes a clean in slices, its next slice finds nothing left
+	std::vector<std::shared_ptr<Tile>> tiles = std::move(tilesCleaning);
+	tilesCleaning.clear();
 	for (const auto &tile : g_game().getTilesToClean()) {
+		tiles.emplace_back(tile);
+	}
+
+	for (const auto &tile : tiles) {
 		if (!tile) {
 			continue;
 		}
@@ -735,3 +729,56 @@ uint32_t Map::clean() {
 	g_logger().info("CLEAN: Removed {} item{} from {} tile{} in {} seconds", count, (count != 1 ? "s" : ""), qntTiles, (qntTiles != 1 ? "s" : ""), (end - start) / (1000.f));
 	return count;
 }
+
+uint32_t Map::cleanInSlices() {
+	if (cleaning) {
+		g_logger().warn("CLEAN: The previous clean is still running");
+		return 0;
+	}
+
+	// Tiles marked while cleaning are left for the next clean
+	const auto &tilesToClean = g_game().getTilesToClean();
+	tilesCleaning.assign(tilesToClean.begin(), tilesToClean.end());
+	g_game().clearTilesToClean();
+
+	const auto queued = static_cast<uint32_t>(tilesCleaning.size());
+	cleaning = true;
+	g_dispatcher().addResumableEvent(
+		[this, count = size_t(0), qntTiles = size_t(0), start = OTSYS_TIME()](const TickBudget &budget) mutable {
+			// Nothing is cleaned once the server is going down
+			if (g_game().getGameState() == GAME_STATE_SHUTDOWN) {
+				tilesCleaning.clear();
+			}
+
+			ItemVector toRemove;
+			while (!tilesCleaning.empty()) {
+				const auto tile = std::move(tilesCleaning.back());
+				tilesCleaning.pop_back();
+				if (const auto items = tile ? tile->getItemList() : nullptr) {
+					++qntTiles;
+					for (const auto &item : *items) {
+						if (item->isCleanable()) {
+							toRemove.emplace_back(item);
+						}
+					}
+				}
+
+				count += toRemove.size();
+				for (const auto &item : toRemove) {
+					g_game().internalRemoveItem(item, -1);
+				}
+				toRemove.clear();
+
+				if (!tilesCleaning.empty() && budget.isExhausted()) {
+					return true;
+				}
+			}
+
+			cleaning = false;
+			g_logger().info("CLEAN: Removed {} item{} from {} tile{} in {} seconds", count, (count != 1 ? "s" : ""), qntTiles, (qntTiles != 1 ? "s" : ""), (OTSYS_TIME() - start) / (1000.f));
+			return false;
+		},
+		"Map::cleanInSlices"
+	);
+	return queued;
+}
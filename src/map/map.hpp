@@ -31,7 +31,10 @@ class FrozenPathingConditionCall;
  */
 class Map : public MapCache {
 public:
+	// Removes the cleanable items of the marked tiles at once, returns the number of items removed
 	uint32_t clean();
+	// Removes them over the next dispatcher cycles instead, returns the number of tiles queued
+	uint32_t cleanInSlices();
 
 	std::filesystem::path getPath() const {
 		return path;
@@ -63,12 +66,6 @@ public:
 
 	void loadHouseInfo();
 
-	/**
-	 * Save a map.
-	 * \returns true if the map was saved successfully
-	 */
-	static bool save();
-
 	/**
 	 * Get a single tile.
 	 * \returns A pointer to that tile.
@@ -163,7 +160,12 @@ private:
 	uint32_t width = 0;
 	uint32_t height = 0;
 
+	// Tiles left to the clean in slices
+	std::vector<std::shared_ptr<Tile>> tilesCleaning;
+	bool cleaning = false;
+
 	friend class Game;
 	friend class IOMap;
 	friend class MapCache;
+	friend class MemoryCensus;
 };
@@ -25,6 +25,7 @@
 // STL Includes
 // --------------------
 
+#include <bit>
 #include <bitset>
 #include <charconv>
 #include <filesystem>
@@ -46,6 +47,7 @@
 #include <cmath>
 #include <mutex>
 #include <stack>
+#include <span>
 
 // --------------------
 // System Includes
@@ -68,6 +70,7 @@
 // --------------------
 
 // ABSL
+#include <absl/container/inlined_vector.h>
 #include <absl/numeric/int128.h>
 
 // ASIO
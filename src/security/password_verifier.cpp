@@ -0,0 +1,154 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "security/password_verifier.hpp"
+
+#include "config/configmanager.hpp"
+#include "lib/di/container.hpp"
+#include "security/argon.hpp"
+
+namespace {
+	// Share of the queue a single IP can hold, so one address cannot fill it alone
+	constexpr size_t MAX_PENDING_PER_IP = 4;
+	// Expired sessions are only purged once the cache grows past this size
+	constexpr size_t SESSIONS_PURGE_SIZE = 1024;
+}
+
+PasswordVerifier::~PasswordVerifier() {
+	// jthread requests stop and joins, pending callbacks are dropped
+	workers.clear();
+}
+
+PasswordVerifier &PasswordVerifier::getInstance() {
+	return inject<PasswordVerifier>();
+}
+
+bool PasswordVerifier::matches(const std::string &password, const std::string &passwordHash) {
+	if (Argon2 {}.argon(password, passwordHash)) {
+		return true;
+	}
+
+	return transformToSHA1(password) == passwordHash;
+}
+
+bool PasswordVerifier::verify(uint32_t accountId, const std::string &password, const std::string &passwordHash) {
+	const auto sessionKey = getSessionKey(accountId, password, passwordHash);
+	if (isVerified(sessionKey)) {
+		g_metrics().addCounter("password_verify_cache_hits", 1);
+		return true;
+	}
+
+	metrics::login_latency measure("hash");
+	if (!matches(password, passwordHash)) {
+		return false;
+	}
+
+	setVerified(sessionKey);
+	return true;
+}
+
+bool PasswordVerifier::verifyAsync(uint32_t ip, uint32_t accountId, std::string password, std::string passwordHash, Callback &&callback) {
+	if (isVerified(getSessionKey(accountId, password, passwordHash))) {
+		g_metrics().addCounter("password_verify_cache_hits", 1);
+		callback(true);
+		return true;
+	}
+
+	std::call_once(workersStarted, [this] { startWorkers(); });
+
+	{
+		std::scoped_lock lock(queueMutex);
+		auto &pending = pendingByIp[ip];
+		const auto queueSize = static_cast<size_t>(g_configManager().getNumber(PASSWORD_VERIFY_QUEUE_SIZE, __FUNCTION__));
+		if (pendingCount >= queueSize || pending.size() >= MAX_PENDING_PER_IP) {
+			if (pending.empty()) {
+				pendingByIp.erase(ip);
+			}
+			g_metrics().addCounter("password_verify_rejected", 1);
+			return false;
+		}
+
+		if (pending.empty()) {
+			ipOrder.push_back(ip);
+		}
+		pending.push_back({ accountId, std::move(password), std::move(passwordHash), std::move(callback), std::make_unique<metrics::login_latency>("queue") });
+		++pendingCount;
+	}
+
+	queueSignal.notify_one();
+	return true;
+}
+
+void PasswordVerifier::startWorkers() {
+	const auto threads = std::max<int32_t>(1, g_configManager().getNumber(PASSWORD_VERIFY_THREADS, __FUNCTION__));
+	workers.reserve(threads);
+	for (int32_t i = 0; i < threads; ++i) {
+		workers.emplace_back([this](const std::stop_token &stopToken) { threadMain(stopToken); });
+	}
+	g_logger().info("Started {} password verification threads", threads);
+}
+
+void PasswordVerifier::threadMain(const std::stop_token &stopToken) {
+	while (true) {
+		Job job;
+		{
+			std::unique_lock lock(queueMutex);
+			if (!queueSignal.wait(lock, stopToken, [this] { return pendingCount > 0; })) {
+				return;
+			}
+
+			// Round robin: take the oldest job of the next IP and send the IP to the back if it has more
+			const uint32_t ip = ipOrder.front();
+			ipOrder.pop_front();
+			auto it = pendingByIp.find(ip);
+			job = std::move(it->second.front());
+			it->second.pop_front();
+			if (it->second.empty()) {
+				pendingByIp.erase(it);
+			} else {
+				ipOrder.push_back(ip);
+			}
+			--pendingCount;
+		}
+
+		runJob(job);
+	}
+}
+
+void PasswordVerifier::runJob(Job &job) {
+	job.queueLatency->stop();
+	job.callback(verify(job.accountId, job.password, job.passwordHash));
+}
+
+std::string PasswordVerifier::getSessionKey(uint32_t accountId, const std::string &password, const std::string &passwordHash) {
+	// The stored hash is part of the key, so a password change invalidates the session
+	return fmt::format("{}:{}", accountId, transformToSHA1(fmt::format("{}\n{}", password, passwordHash)));
+}
+
+bool PasswordVerifier::isVerified(const std::string &sessionKey) {
+	std::scoped_lock lock(sessionsMutex);
+	const auto it = verifiedSessions.find(sessionKey);
+	return it != verifiedSessions.end() && it->second > std::chrono::steady_clock::now();
+}
+
+void PasswordVerifier::setVerified(const std::string &sessionKey) {
+	const auto cacheTime = g_configManager().getNumber(PASSWORD_VERIFY_CACHE_TIME, __FUNCTION__);
+	if (cacheTime <= 0) {
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	std::scoped_lock lock(sessionsMutex);
+	if (verifiedSessions.size() >= SESSIONS_PURGE_SIZE) {
+		phmap::erase_if(verifiedSessions, [now](const auto &entry) { return entry.second <= now; });
+	}
+	verifiedSessions[sessionKey] = now + std::chrono::seconds(cacheTime);
+}
@@ -0,0 +1,83 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "lib/metrics/metrics.hpp"
+
+/**
+ * Verifies account passwords (argon2 or sha1) away from the dispatcher.
+ *
+ * Asynchronous verifications run on a small set of dedicated threads fed by a
+ * bounded queue, served round robin by IP so a single address cannot starve the
+ * others. Successful verifications are remembered for a short time, keyed by the
+ * account and a digest of the password and stored hash, so character list
+ * refreshes and the following game login do not hash again.
+ */
+class PasswordVerifier {
+public:
+	using Callback = std::function<void(bool)>;
+
+	PasswordVerifier() = default;
+	~PasswordVerifier();
+
+	// Singleton - ensures we don't accidentally copy it
+	PasswordVerifier(const PasswordVerifier &) = delete;
+	void operator=(const PasswordVerifier &) = delete;
+
+	static PasswordVerifier &getInstance();
+
+	/**
+	 * Verifies on the calling thread, using the verified sessions cache.
+	 */
+	bool verify(uint32_t accountId, const std::string &password, const std::string &passwordHash);
+
+	/**
+	 * Queues the verification on the dedicated threads. The callback is called from
+	 * a verification thread, or right away from the calling thread on a cache hit.
+	 * Verification threads are outside the thread pool, they post to the dispatcher through its shared slot.
+	 * @return false if the queue (or the IP share of it) is full, the callback is not called.
+	 */
+	bool verifyAsync(uint32_t ip, uint32_t accountId, std::string password, std::string passwordHash, Callback &&callback);
+
+	// Compares the password against an argon2 or sha1 hash, without caching
+	static bool matches(const std::string &password, const std::string &passwordHash);
+
+private:
+	struct Job {
+		uint32_t accountId = 0;
+		std::string password;
+		std::string passwordHash;
+		Callback callback;
+		// Time spent waiting for a verification thread
+		std::unique_ptr<metrics::login_latency> queueLatency;
+	};
+
+	void startWorkers();
+	void threadMain(const std::stop_token &stopToken);
+	void runJob(Job &job);
+
+	static std::string getSessionKey(uint32_t accountId, const std::string &password, const std::string &passwordHash);
+	bool isVerified(const std::string &sessionKey);
+	void setVerified(const std::string &sessionKey);
+
+	std::mutex queueMutex;
+	std::condition_variable_any queueSignal;
+	// Pending jobs of each IP, and the IPs with pending jobs in serving order
+	phmap::flat_hash_map<uint32_t, std::deque<Job>> pendingByIp;
+	std::deque<uint32_t> ipOrder;
+	size_t pendingCount = 0;
+	std::once_flag workersStarted;
+	std::vector<std::jthread> workers;
+
+	std::mutex sessionsMutex;
+	phmap::flat_hash_map<std::string, std::chrono::steady_clock::time_point> verifiedSessions;
+};
+
+constexpr auto g_passwordVerifier = PasswordVerifier::getInstance;
@@ -16,11 +16,21 @@ RSA::RSA(Logger &logger) :
 	logger(logger) {
 	mpz_init(n);
 	mpz_init2(d, 1024);
+	mpz_init2(p, 512);
+	mpz_init2(q, 512);
+	mpz_init2(dP, 512);
+	mpz_init2(dQ, 512);
+	mpz_init2(qInv, 512);
 }
 
 RSA::~RSA() {
 	mpz_clear(n);
 	mpz_clear(d);
+	mpz_clear(p);
+	mpz_clear(q);
+	mpz_clear(dP);
+	mpz_clear(dQ);
+	mpz_clear(qInv);
 }
 
 RSA &RSA::getInstance() {
@@ -28,27 +38,23 @@ RSA &RSA::getInstance() {
 }
 
 void RSA::start() {
-	const char* p("14299623962416399520070177382898895550795403345466153217470516082934737582776038882967213386204600674145392845853859217990626450972452084065728686565928113");
-	const char* q("7630979195970404721891201847792002125535401292779123937207447574596692788513647179235335529307251350570728407373705564708871762033017096809910315212884101");
+	const char* pDefault("14299623962416399520070177382898895550795403345466153217470516082934737582776038882967213386204600674145392845853859217990626450972452084065728686565928113");
+	const char* qDefault("7630979195970404721891201847792002125535401292779123937207447574596692788513647179235335529307251350570728407373705564708871762033017096809910315212884101");
 	try {
 		if (!loadPEM("key.pem")) {
 			// file doesn't exist - switch to base10-hardcoded keys
 			logger.error("File key.pem not found or have problem on loading... Setting standard rsa key\n");
-			setKey(p, q);
+			setKey(pDefault, qDefault);
 		}
 	} catch (const std::system_error &e) {
 		logger.error("Loading RSA Key from key.pem failed with error: {}\n", e.what());
 		logger.error("Switching to a default key...");
-		setKey(p, q);
+		setKey(pDefault, qDefault);
 	}
 }
 
 void RSA::setKey(const char* pString, const char* qString, int base /* = 10*/) {
-	mpz_t p;
-	mpz_t q;
 	mpz_t e;
-	mpz_init2(p, 1024);
-	mpz_init2(q, 1024);
 	mpz_init(e);
 
 	mpz_set_str(p, pString, base);
@@ -60,7 +66,6 @@ void RSA::setKey(const char* pString, const char* qString, int base /* = 10*/) {
 	// n = p * q
 	mpz_mul(n, p, q);
 
-	// d = e^-1 mod (p - 1)(q - 1)
 	mpz_t p_1;
 	mpz_t q_1;
 	mpz_t pq_1;
@@ -77,32 +82,44 @@ void RSA::setKey(const char* pString, const char* qString, int base /* = 10*/) {
 	// d = e^-1 mod (p - 1)(q - 1)
 	mpz_invert(d, e, pq_1);
 
+	// dP = d mod (p - 1), dQ = d mod (q - 1), qInv = q^-1 mod p
+	mpz_mod(dP, d, p_1);
+	mpz_mod(dQ, d, q_1);
+	mpz_invert(qInv, q, p);
+
 	mpz_clear(p_1);
 	mpz_clear(q_1);
 	mpz_clear(pq_1);
 
-	mpz_clear(p);
-	mpz_clear(q);
 	mpz_clear(e);
 }
 
 void RSA::decrypt(char* msg) const {
 	mpz_t c;
 	mpz_t m;
+	mpz_t m2;
 	mpz_init2(c, 1024);
 	mpz_init2(m, 1024);
+	mpz_init2(m2, 512);
 
 	mpz_import(c, 128, 1, 1, 0, 0, msg);
 
-	// m = c^d mod n
-	mpz_powm(m, c, d, n);
+	// m = c^d mod n, computed as two half-size exponentiations:
+	// m1 = c^dP mod p, m2 = c^dQ mod q, h = qInv * (m1 - m2) mod p, m = m2 + h * q
+	mpz_powm(m, c, dP, p);
+	mpz_powm(m2, c, dQ, q);
+	mpz_sub(m, m, m2);
+	mpz_mul(m, m, qInv);
+	mpz_mod(m, m, p);
+	mpz_addmul(m2, m, q);
 
-	size_t count = (mpz_sizeinbase(m, 2) + 7) / 8;
+	size_t count = (mpz_sizeinbase(m2, 2) + 7) / 8;
 	memset(msg, 0, 128 - count);
-	mpz_export(msg + (128 - count), nullptr, 1, 1, 0, 0, m);
+	mpz_export(msg + (128 - count), nullptr, 1, 1, 0, 0, m2);
 
 	mpz_clear(c);
 	mpz_clear(m);
+	mpz_clear(m2);
 }
 
 std::string RSA::base64Decrypt(const std::string &input) const {
@@ -25,6 +25,10 @@ public:
 	void start();
 
 	void setKey(const char* pString, const char* qString, int base = 10);
+	/**
+	 * Decrypts the 128 bytes block in place using the Chinese remainder theorem.
+	 * Only reads the key, so it can run concurrently on any thread.
+	 */
 	void decrypt(char* msg) const;
 
 	std::string base64Decrypt(const std::string &input) const;
@@ -36,6 +40,13 @@ private:
 	Logger &logger;
 	mpz_t n;
 	mpz_t d;
+
+	// CRT parameters: the primes, d mod (p - 1), d mod (q - 1) and q^-1 mod p
+	mpz_t p;
+	mpz_t q;
+	mpz_t dP;
+	mpz_t dQ;
+	mpz_t qInv;
 };
 
 constexpr auto g_RSA = RSA::getInstance;
@@ -0,0 +1,247 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "security/xtea.hpp"
+
+#if defined(__AVX2__)
+	#define XTEA_AVX2 1
+	#define XTEA_AVX2_TARGET
+#elif defined(__SSE2__) && defined(__GNUC__)
+	// Built for a baseline x86 target, the AVX2 kernel is compiled for it and picked at runtime
+	#include <immintrin.h>
+	#define XTEA_AVX2 1
+	#define XTEA_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace {
+	constexpr uint32_t DELTA = 0x61C88647;
+	constexpr uint32_t DECRYPT_SUM = 0xC6EF3720;
+	constexpr size_t BLOCK_SIZE = 8;
+
+#if defined(XTEA_AVX2)
+	bool hasAVX2() {
+	#if defined(__AVX2__)
+		return true;
+	#else
+		static const bool supported = __builtin_cpu_supports("avx2");
+		return supported;
+	#endif
+	}
+
+	XTEA_AVX2_TARGET __m256i mixAVX2(__m256i v) {
+		return _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v);
+	}
+
+	// Loads 8 blocks as one vector of first words and one of second words (in lane order, undone by store)
+	XTEA_AVX2_TARGET void loadAVX2(const uint8_t* data, __m256i &v0, __m256i &v1) {
+		const __m256i a = _mm256_shuffle_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i b = _mm256_shuffle_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)), _MM_SHUFFLE(3, 1, 2, 0));
+		v0 = _mm256_unpacklo_epi64(a, b);
+		v1 = _mm256_unpackhi_epi64(a, b);
+	}
+
+	XTEA_AVX2_TARGET void storeAVX2(uint8_t* data, __m256i v0, __m256i v1) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data), _mm256_unpacklo_epi32(v0, v1));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + 32), _mm256_unpackhi_epi32(v0, v1));
+	}
+
+	XTEA_AVX2_TARGET size_t encryptAVX2(uint8_t* data, size_t length, const XTEA::RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + 8 * BLOCK_SIZE <= length; offset += 8 * BLOCK_SIZE) {
+			__m256i v0, v1;
+			loadAVX2(data + offset, v0, v1);
+			for (size_t i = 0; i < roundKeys.size(); i += 2) {
+				v0 = _mm256_add_epi32(v0, _mm256_xor_si256(mixAVX2(v1), _mm256_set1_epi32(static_cast<int32_t>(roundKeys[i]))));
+				v1 = _mm256_add_epi32(v1, _mm256_xor_si256(mixAVX2(v0), _mm256_set1_epi32(static_cast<int32_t>(roundKeys[i + 1]))));
+			}
+			storeAVX2(data + offset, v0, v1);
+		}
+		return offset;
+	}
+
+	XTEA_AVX2_TARGET size_t decryptAVX2(uint8_t* data, size_t length, const XTEA::RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + 8 * BLOCK_SIZE <= length; offset += 8 * BLOCK_SIZE) {
+			__m256i v0, v1;
+			loadAVX2(data + offset, v0, v1);
+			for (size_t i = 0; i < roundKeys.size(); i += 2) {
+				v1 = _mm256_sub_epi32(v1, _mm256_xor_si256(mixAVX2(v0), _mm256_set1_epi32(static_cast<int32_t>(roundKeys[i]))));
+				v0 = _mm256_sub_epi32(v0, _mm256_xor_si256(mixAVX2(v1), _mm256_set1_epi32(static_cast<int32_t>(roundKeys[i + 1]))));
+			}
+			storeAVX2(data + offset, v0, v1);
+		}
+		return offset;
+	}
+#endif
+
+#if defined(__SSE2__)
+	__m128i mixSSE2(__m128i v) {
+		return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v);
+	}
+
+	void loadSSE2(const uint8_t* data, __m128i &v0, __m128i &v1) {
+		const __m128i a = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m128i b = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)), _MM_SHUFFLE(3, 1, 2, 0));
+		v0 = _mm_unpacklo_epi64(a, b);
+		v1 = _mm_unpackhi_epi64(a, b);
+	}
+
+	void storeSSE2(uint8_t* data, __m128i v0, __m128i v1) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(v0, v1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_unpackhi_epi32(v0, v1));
+	}
+
+	size_t encryptVector(uint8_t* data, size_t length, const XTEA::RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + 4 * BLOCK_SIZE <= length; offset += 4 * BLOCK_SIZE) {
+			__m128i v0, v1;
+			loadSSE2(data + offset, v0, v1);
+			for (size_t i = 0; i < roundKeys.size(); i += 2) {
+				v0 = _mm_add_epi32(v0, _mm_xor_si128(mixSSE2(v1), _mm_set1_epi32(static_cast<int32_t>(roundKeys[i]))));
+				v1 = _mm_add_epi32(v1, _mm_xor_si128(mixSSE2(v0), _mm_set1_epi32(static_cast<int32_t>(roundKeys[i + 1]))));
+			}
+			storeSSE2(data + offset, v0, v1);
+		}
+		return offset;
+	}
+
+	size_t decryptVector(uint8_t* data, size_t length, const XTEA::RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + 4 * BLOCK_SIZE <= length; offset += 4 * BLOCK_SIZE) {
+			__m128i v0, v1;
+			loadSSE2(data + offset, v0, v1);
+			for (size_t i = 0; i < roundKeys.size(); i += 2) {
+				v1 = _mm_sub_epi32(v1, _mm_xor_si128(mixSSE2(v0), _mm_set1_epi32(static_cast<int32_t>(roundKeys[i]))));
+				v0 = _mm_sub_epi32(v0, _mm_xor_si128(mixSSE2(v1), _mm_set1_epi32(static_cast<int32_t>(roundKeys[i + 1]))));
+			}
+			storeSSE2(data + offset, v0, v1);
+		}
+		return offset;
+	}
+#elif defined(__NEON__)
+	uint32x4_t mixNEON(uint32x4_t v) {
+		return vaddq_u32(veorq_u32(vshlq_n_u32(v, 4), vshrq_n_u32(v, 5)), v);
+	}
+
+	size_t encryptVector(uint8_t* data, size_t length, const XTEA::RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + 4 * BLOCK_SIZE <= length; offset += 4 * BLOCK_SIZE) {
+			uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(data + offset));
+			for (size_t i = 0; i < roundKeys.size(); i += 2) {
+				v.val[0] = vaddq_u32(v.val[0], veorq_u32(mixNEON(v.val[1]), vdupq_n_u32(roundKeys[i])));
+				v.val[1] = vaddq_u32(v.val[1], veorq_u32(mixNEON(v.val[0]), vdupq_n_u32(roundKeys[i + 1])));
+			}
+			vst2q_u32(reinterpret_cast<uint32_t*>(data + offset), v);
+		}
+		return offset;
+	}
+
+	size_t decryptVector(uint8_t* data, size_t length, const XTEA::RoundKeys &roundKeys) {
+		size_t offset = 0;
+		for (; offset + 4 * BLOCK_SIZE <= length; offset += 4 * BLOCK_SIZE) {
+			uint32x4x2_t v = vld2q_u32(reinterpret_cast<const uint32_t*>(data + offset));
+			for (size_t i = 0; i < roundKeys.size(); i += 2) {
+				v.val[1] = vsubq_u32(v.val[1], veorq_u32(mixNEON(v.val[0]), vdupq_n_u32(roundKeys[i])));
+				v.val[0] = vsubq_u32(v.val[0], veorq_u32(mixNEON(v.val[1]), vdupq_n_u32(roundKeys[i + 1])));
+			}
+			vst2q_u32(reinterpret_cast<uint32_t*>(data + offset), v);
+		}
+		return offset;
+	}
+#endif
+}
+
+XTEA::RoundKeys XTEA::expandEncryptKey(const Key &key) {
+	RoundKeys roundKeys;
+	uint32_t sum = 0;
+	for (size_t i = 0; i < roundKeys.size(); i += 2) {
+		roundKeys[i] = sum + key[sum & 3];
+		sum -= DELTA;
+		roundKeys[i + 1] = sum + key[(sum >> 11) & 3];
+	}
+	return roundKeys;
+}
+
+XTEA::RoundKeys XTEA::expandDecryptKey(const Key &key) {
+	RoundKeys roundKeys;
+	uint32_t sum = DECRYPT_SUM;
+	for (size_t i = 0; i < roundKeys.size(); i += 2) {
+		roundKeys[i] = sum + key[(sum >> 11) & 3];
+		sum += DELTA;
+		roundKeys[i + 1] = sum + key[sum & 3];
+	}
+	return roundKeys;
+}
+
+void XTEA::encrypt(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+	size_t offset = 0;
+#if defined(XTEA_AVX2)
+	if (hasAVX2()) {
+		offset = encryptAVX2(data, length, roundKeys);
+	}
+#endif
+#if defined(__SSE2__) || defined(__NEON__)
+	offset += encryptVector(data + offset, length - offset, roundKeys);
+#endif
+	encryptScalar(data + offset, length - offset, roundKeys);
+}
+
+void XTEA::decrypt(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+	size_t offset = 0;
+#if defined(XTEA_AVX2)
+	if (hasAVX2()) {
+		offset = decryptAVX2(data, length, roundKeys);
+	}
+#endif
+#if defined(__SSE2__) || defined(__NEON__)
+	offset += decryptVector(data + offset, length - offset, roundKeys);
+#endif
+	decryptScalar(data + offset, length - offset, roundKeys);
+}
+
+void XTEA::encryptScalar(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+	for (size_t offset = 0; offset + BLOCK_SIZE <= length; offset += BLOCK_SIZE) {
+		std::array<uint32_t, 2> vData = {};
+		memcpy(vData.data(), data + offset, BLOCK_SIZE);
+		for (size_t i = 0; i < roundKeys.size(); i += 2) {
+			vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ roundKeys[i];
+			vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ roundKeys[i + 1];
+		}
+		memcpy(data + offset, vData.data(), BLOCK_SIZE);
+	}
+}
+
+void XTEA::decryptScalar(uint8_t* data, size_t length, const RoundKeys &roundKeys) {
+	for (size_t offset = 0; offset + BLOCK_SIZE <= length; offset += BLOCK_SIZE) {
+		std::array<uint32_t, 2> vData = {};
+		memcpy(vData.data(), data + offset, BLOCK_SIZE);
+		for (size_t i = 0; i < roundKeys.size(); i += 2) {
+			vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ roundKeys[i];
+			vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ roundKeys[i + 1];
+		}
+		memcpy(data + offset, vData.data(), BLOCK_SIZE);
+	}
+}
+
+std::string_view XTEA::getKernelName() {
+#if defined(XTEA_AVX2)
+	if (hasAVX2()) {
+		return "avx2";
+	}
+#endif
+#if defined(__SSE2__)
+	return "sse2";
+#elif defined(__NEON__)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
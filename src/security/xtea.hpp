@@ -0,0 +1,42 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * XTEA block cipher (32 cycles, ECB) as used by the game protocol.
+ *
+ * The blocks of a message are independent, so encrypt/decrypt process 8 (AVX2) or
+ * 4 (SSE2/NEON) blocks at a time and finish the remainder with the scalar kernel.
+ * SSE2 and NEON are selected at compile time through utils/simd.hpp, AVX2 is also
+ * detected at runtime on GCC/Clang builds that do not target it already.
+ */
+class XTEA {
+public:
+	using Key = std::array<uint32_t, 4>;
+	// sum + key word of each half round, computed once per key
+	using RoundKeys = std::array<uint32_t, 64>;
+
+	static RoundKeys expandEncryptKey(const Key &key);
+	static RoundKeys expandDecryptKey(const Key &key);
+
+	/**
+	 * Encrypts/decrypts the buffer in place.
+	 * @param length Must be a multiple of 8, trailing bytes are left untouched.
+	 */
+	static void encrypt(uint8_t* data, size_t length, const RoundKeys &roundKeys);
+	static void decrypt(uint8_t* data, size_t length, const RoundKeys &roundKeys);
+
+	// One block at a time, used for the remainder and as the reference implementation
+	static void encryptScalar(uint8_t* data, size_t length, const RoundKeys &roundKeys);
+	static void decryptScalar(uint8_t* data, size_t length, const RoundKeys &roundKeys);
+
+	// Name of the widest kernel used on this machine ("avx2", "sse2", "neon" or "scalar")
+	static std::string_view getKernelName();
+};
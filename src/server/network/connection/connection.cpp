@@ -10,6 +10,7 @@
 #include "pch.hpp"
 
 #include "server/network/connection/connection.hpp"
+#include "server/network/message/inboundmessage.hpp"
 #include "server/network/message/outputmessage.hpp"
 #include "server/network/protocol/protocol.hpp"
 #include "game/scheduling/dispatcher.hpp"
@@ -44,6 +45,7 @@ void ConnectionManager::closeAll() {
 }
 
 Connection::Connection(asio::io_service &initIoService, ConstServicePort_ptr initservicePort) :
+	msg(InboundMessagePool::getInboundMessage()),
 	readTimer(initIoService),
 	writeTimer(initIoService),
 	service_port(std::move(initservicePort)),
@@ -108,7 +110,7 @@ void Connection::acceptInternal(bool toggleParseHeader) {
 	readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 	try {
-		asio::async_read(socket, asio::buffer(msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this(), toggleParseHeader](const std::error_code &error, std::size_t N) {
+		asio::async_read(socket, asio::buffer(msg->getBuffer(), HEADER_LENGTH), [self = shared_from_this(), toggleParseHeader](const std::error_code &error, std::size_t N) {
 			if (toggleParseHeader) {
 				self->parseHeader(error);
 			} else {
@@ -132,7 +134,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 		return;
 	}
 
-	uint8_t* msgBuffer = msg.getBuffer();
+	uint8_t* msgBuffer = msg->getBuffer();
 	auto charData = static_cast<char*>(static_cast<void*>(msgBuffer));
 	std::string serverName = g_configManager().getString(SERVER_NAME, __FUNCTION__) + "\n";
 	if (connectionState == CONNECTION_STATE_IDENTIFYING) {
@@ -150,7 +152,7 @@ void Connection::parseProxyIdentification(const std::error_code &error) {
 					readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 					// Read the remainder of proxy identification
-					asio::async_read(socket, asio::buffer(msg.getBuffer(), remainder), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseProxyIdentification(error); });
+					asio::async_read(socket, asio::buffer(msg->getBuffer(), remainder), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseProxyIdentification(error); });
 				} catch (const std::system_error &e) {
 					g_logger().error("Connection::parseProxyIdentification] - error: {}", e.what());
 					close(FORCE_CLOSE);
@@ -200,7 +202,7 @@ void Connection::parseHeader(const std::error_code &error) {
 		packetsSent = 0;
 	}
 
-	uint16_t size = msg.getLengthHeader();
+	uint16_t size = msg->getLengthHeader();
 	if (size == 0 || size > INPUTMESSAGE_MAXSIZE) {
 		close(FORCE_CLOSE);
 		return;
@@ -211,9 +213,9 @@ void Connection::parseHeader(const std::error_code &error) {
 		readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 		// Read packet content
-		msg.setLength(size + HEADER_LENGTH);
+		msg->setLength(size + HEADER_LENGTH);
 		// Read the remainder of proxy identification
-		asio::async_read(socket, asio::buffer(msg.getBodyBuffer(), size), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parsePacket(error); });
+		asio::async_read(socket, asio::buffer(msg->getBodyBuffer(), size), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parsePacket(error); });
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::parseHeader] - error: {}", e.what());
 		close(FORCE_CLOSE);
@@ -240,21 +242,21 @@ void Connection::parsePacket(const std::error_code &error) {
 		if (!protocol) {
 			// Check packet checksum
 			uint32_t checksum;
-			if (int32_t len = msg.getLength() - msg.getBufferPosition() - CHECKSUM_LENGTH;
+			if (int32_t len = msg->getLength() - msg->getBufferPosition() - CHECKSUM_LENGTH;
 				len > 0) {
-				checksum = adlerChecksum(msg.getBuffer() + msg.getBufferPosition() + CHECKSUM_LENGTH, len);
+				checksum = adlerChecksum(msg->getBuffer() + msg->getBufferPosition() + CHECKSUM_LENGTH, len);
 			} else {
 				checksum = 0;
 			}
 
-			uint32_t recvChecksum = msg.get<uint32_t>();
+			uint32_t recvChecksum = msg->get<uint32_t>();
 			if (recvChecksum != checksum) {
 				// it might not have been the checksum, step back
-				msg.skipBytes(-CHECKSUM_LENGTH);
+				msg->skipBytes(-CHECKSUM_LENGTH);
 			}
 
 			// Game protocol has already been created at this point
-			protocol = service_port->make_protocol(recvChecksum == checksum, msg, shared_from_this());
+			protocol = service_port->make_protocol(recvChecksum == checksum, *msg, shared_from_this());
 			if (!protocol) {
 				close(FORCE_CLOSE);
 				return;
@@ -262,15 +264,18 @@ void Connection::parsePacket(const std::error_code &error) {
 		} else {
 			// It is rather hard to detect if we have checksum or sequence method here so let's skip checksum check
 			// it doesn't generate any problem because olders protocol don't use 'server sends first' feature
-			msg.get<uint32_t>();
+			msg->get<uint32_t>();
 			// Skip protocol ID
-			msg.skipBytes(1);
+			msg->skipBytes(1);
 		}
 
-		protocol->onRecvFirstMessage(msg);
+		protocol->onRecvFirstMessage(*msg);
+		// The RSA block is decrypted on the thread pool, which resumes reading when done
+		skipReadingNextPacket = protocol->isFirstMessageDeferred();
 	} else {
-		// Send the packet to the current protocol
-		skipReadingNextPacket = protocol->onRecvMessage(msg);
+		// Send the packet to the current protocol, the next packet is read into another message
+		// before the dispatcher can call resumeWork
+		skipReadingNextPacket = protocol->onRecvMessage(std::exchange(msg, InboundMessagePool::getInboundMessage()));
 	}
 
 	try {
@@ -279,7 +284,7 @@ void Connection::parsePacket(const std::error_code &error) {
 
 		if (!skipReadingNextPacket) {
 			// Wait to the next packet
-			asio::async_read(socket, asio::buffer(msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
+			asio::async_read(socket, asio::buffer(msg->getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
 		}
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::parsePacket] - error: {}", e.what());
@@ -288,13 +293,28 @@ void Connection::parsePacket(const std::error_code &error) {
 }
 
 void Connection::resumeWork() {
+	try {
+		asio::post(socket.get_executor(), [self = shared_from_this()] { self->resumeReading(); });
+	} catch (const std::system_error &e) {
+		g_logger().error("[Connection::resumeWork] - Exception in posting read operation: {}", e.what());
+		close(FORCE_CLOSE);
+	}
+}
+
+void Connection::resumeReading() {
+	std::scoped_lock lock(connectionLock);
+	// Closed meanwhile, e.g. by the protocol that asked to resume
+	if (connectionState == CONNECTION_STATE_CLOSED) {
+		return;
+	}
+
 	readTimer.expires_from_now(std::chrono::seconds(CONNECTION_READ_TIMEOUT));
 	readTimer.async_wait([self = std::weak_ptr<Connection>(shared_from_this())](const std::error_code &error) { Connection::handleTimeout(self, error); });
 
 	try {
-		asio::async_read(socket, asio::buffer(msg.getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
+		asio::async_read(socket, asio::buffer(msg->getBuffer(), HEADER_LENGTH), [self = shared_from_this()](const std::error_code &error, std::size_t N) { self->parseHeader(error); });
 	} catch (const std::system_error &e) {
-		g_logger().error("[Connection::resumeWork] - Exception in async_read: {}", e.what());
+		g_logger().error("[Connection::resumeReading] - Exception in async_read: {}", e.what());
 		close(FORCE_CLOSE);
 	}
 }
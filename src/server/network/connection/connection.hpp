@@ -20,6 +20,8 @@ class Protocol;
 using Protocol_ptr = std::shared_ptr<Protocol>;
 class OutputMessage;
 using OutputMessage_ptr = std::shared_ptr<OutputMessage>;
+class InboundMessage;
+using InboundMessage_ptr = std::shared_ptr<InboundMessage>;
 class Connection;
 using Connection_ptr = std::shared_ptr<Connection>;
 using ConnectionWeak_ptr = std::weak_ptr<Connection>;
@@ -63,6 +65,7 @@ public:
 	void accept(Protocol_ptr protocolPtr);
 	void acceptInternal(bool toggleParseHeader = true);
 
+	// Any thread, reading is resumed on the socket's executor unless the connection was closed
 	void resumeWork();
 
 	void send(const OutputMessage_ptr &outputMessage);
@@ -73,6 +76,7 @@ private:
 	void parseProxyIdentification(const std::error_code &error);
 	void parseHeader(const std::error_code &error);
 	void parsePacket(const std::error_code &error);
+	void resumeReading();
 
 	void onWriteOperation(const std::error_code &error);
 
@@ -86,7 +90,8 @@ private:
 		return socket;
 	}
 
-	NetworkMessage msg;
+	// Packet being read, handed over to the protocol once complete
+	InboundMessage_ptr msg;
 
 	asio::high_resolution_timer readTimer;
 	asio::high_resolution_timer writeTimer;
@@ -0,0 +1,48 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/message/inboundmessage.hpp"
+
+InboundMessage_ptr InboundMessagePool::getInboundMessage() {
+	const auto &freeList = getInstance().freeList;
+
+	std::unique_ptr<InboundMessage> message;
+	{
+		std::scoped_lock lock(freeList->mutex);
+		if (!freeList->messages.empty()) {
+			message = std::move(freeList->messages.back());
+			freeList->messages.pop_back();
+		}
+	}
+	if (!message) {
+		message = std::make_unique<InboundMessage>();
+	}
+
+	const auto recycle = [weakFreeList = std::weak_ptr<FreeList>(freeList)](InboundMessage* released) {
+		std::unique_ptr<InboundMessage> owned(released);
+		const auto list = weakFreeList.lock();
+		if (!list) {
+			return;
+		}
+
+		owned->reset();
+		std::scoped_lock lock(list->mutex);
+		if (list->messages.size() < MAX_FREE_MESSAGES) {
+			list->messages.push_back(std::move(owned));
+		}
+	};
+	return InboundMessage_ptr(message.release(), recycle);
+}
+
+size_t InboundMessagePool::getFreeCount() const {
+	std::scoped_lock lock(freeList->mutex);
+	return freeList->messages.size();
+}
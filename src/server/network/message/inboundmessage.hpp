@@ -0,0 +1,56 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/connection/connection.hpp"
+
+// A packet read from a connection, handed to the dispatcher by moving the pointer instead of copying the buffer
+class InboundMessage : public NetworkMessage {
+public:
+	InboundMessage() = default;
+
+	// non-copyable
+	InboundMessage(const InboundMessage &) = delete;
+	InboundMessage &operator=(const InboundMessage &) = delete;
+};
+
+/**
+ * Recycles the inbound message buffers (NETWORKMESSAGE_MAXSIZE bytes each), so reading
+ * a packet does not allocate once the pool is warm. Messages return to the pool when
+ * their last pointer is released, from any thread.
+ */
+class InboundMessagePool {
+public:
+	InboundMessagePool() = default;
+
+	// non-copyable
+	InboundMessagePool(const InboundMessagePool &) = delete;
+	InboundMessagePool &operator=(const InboundMessagePool &) = delete;
+
+	static InboundMessagePool &getInstance() {
+		return inject<InboundMessagePool>();
+	}
+
+	static InboundMessage_ptr getInboundMessage();
+
+	size_t getFreeCount() const;
+
+private:
+	static constexpr size_t MAX_FREE_MESSAGES = 256;
+
+	struct FreeList {
+		std::mutex mutex;
+		std::vector<std::unique_ptr<InboundMessage>> messages;
+	};
+
+	// Shared with the deleters, so messages released after the pool is gone are just deleted
+	std::shared_ptr<FreeList> freeList = std::make_shared<FreeList>();
+};
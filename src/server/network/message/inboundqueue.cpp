@@ -0,0 +1,120 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/message/inboundqueue.hpp"
+#include "server/network/message/inboundmessage.hpp"
+
+InboundQueue::InboundQueue(const Rules &rules, size_t maxQueued) :
+	rules(rules), maxQueued(std::max<size_t>(1, maxQueued)) { }
+
+InboundQueue::PushResult InboundQueue::push(InboundMessage_ptr msg, int64_t nowMs) {
+	const uint8_t opcode = getOpcode(*msg);
+	const auto &rule = rules[opcode];
+
+	std::scoped_lock lock(mutex);
+	PushResult result;
+	// Only the packet right before can be superseded, anything in between may depend on it.
+	// Coalescing adds nothing to the queue, so it spends no token: the newest turn or path
+	// still replaces the queued one once the bucket is empty.
+	if (rule.coalesce != Coalesce::None && !entries.empty() && getGroup(entries.back().opcode) == getGroup(opcode)) {
+		auto &last = entries.back();
+		if (rule.coalesce == Coalesce::ReplaceLast) {
+			last = { opcode, std::move(msg) };
+			++stats.coalesced;
+			result.outcome = Outcome::Coalesced;
+			return result;
+		}
+		if (last.opcode == opcode && samePayload(*last.msg, *msg)) {
+			++stats.coalesced;
+			result.outcome = Outcome::Coalesced;
+			return result;
+		}
+	}
+
+	if (!consumeToken(opcode, nowMs)) {
+		++stats.dropped;
+		result.outcome = Outcome::Dropped;
+		return result;
+	}
+
+	entries.push_back({ opcode, std::move(msg) });
+	++stats.queued;
+	result.scheduleFlush = !std::exchange(flushScheduled, true);
+	if (entries.size() >= maxQueued) {
+		readingPaused = true;
+		result.pauseReading = true;
+	}
+	return result;
+}
+
+std::vector<InboundMessage_ptr> InboundQueue::take(bool &resumeReading) {
+	std::vector<Entry> taken;
+	{
+		std::scoped_lock lock(mutex);
+		taken.swap(entries);
+		flushScheduled = false;
+		resumeReading = std::exchange(readingPaused, false);
+	}
+
+	std::vector<InboundMessage_ptr> messages;
+	messages.reserve(taken.size());
+	for (auto &entry : taken) {
+		messages.push_back(std::move(entry.msg));
+	}
+	return messages;
+}
+
+InboundQueue::Stats InboundQueue::getStats() const {
+	std::scoped_lock lock(mutex);
+	return stats;
+}
+
+uint8_t InboundQueue::getOpcode(const NetworkMessage &msg) {
+	// Peeked, the parser reads it again
+	if (msg.getLength() == 0) {
+		return 0;
+	}
+	return msg.getBuffer()[msg.getBufferPosition()];
+}
+
+bool InboundQueue::consumeToken(uint8_t opcode, int64_t nowMs) {
+	// mutex must be held
+	const auto &rule = rules[opcode];
+	if (rule.ratePerSecond == 0) {
+		return true;
+	}
+
+	auto &bucket = buckets[opcode];
+	const double capacity = std::max<uint16_t>(1, rule.burst);
+	if (bucket.tokens < 0) {
+		bucket.tokens = capacity;
+	} else {
+		const auto elapsedMs = std::max<int64_t>(0, nowMs - bucket.lastRefillMs);
+		bucket.tokens = std::min(capacity, bucket.tokens + elapsedMs * rule.ratePerSecond / 1000.0);
+	}
+	bucket.lastRefillMs = nowMs;
+
+	if (bucket.tokens < 1) {
+		return false;
+	}
+	--bucket.tokens;
+	return true;
+}
+
+bool InboundQueue::samePayload(const NetworkMessage &first, const NetworkMessage &second) {
+	// Decrypted packets end at INITIAL_BUFFER_POSITION + length, see NetworkMessage::canRead
+	const auto payload = [](const NetworkMessage &msg) {
+		const size_t begin = msg.getBufferPosition();
+		const size_t end = std::clamp<size_t>(NetworkMessage::INITIAL_BUFFER_POSITION + msg.getLength(), begin, NETWORKMESSAGE_MAXSIZE);
+		return std::span<const uint8_t>(msg.getBuffer() + begin, end - begin);
+	};
+	return std::ranges::equal(payload(first), payload(second));
+}
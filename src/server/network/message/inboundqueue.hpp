@@ -0,0 +1,108 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "server/network/connection/connection.hpp"
+
+/**
+ * Per connection queue of decrypted packets waiting for the dispatcher.
+ *
+ * Pushed from the connection thread and taken in order by a single dispatcher task, so a
+ * connection never has more than one task in the dispatcher queue. On push, a packet can
+ * replace the packet queued right before it (e.g. a newer turn or auto-walk), be dropped as a
+ * duplicate of it (e.g. the same look), or else be dropped by the token bucket of its opcode.
+ */
+class InboundQueue {
+public:
+	enum class Coalesce : uint8_t {
+		None,
+		// Replaces the last queued packet if it is of the same group, the newer one wins
+		ReplaceLast,
+		// Drops the packet if the last queued one is of the same group with the same payload
+		DropDuplicate,
+	};
+
+	struct Rule {
+		// Opcodes sharing a group coalesce with each other, 0 means the opcode itself
+		uint8_t group = 0;
+		Coalesce coalesce = Coalesce::None;
+		// Token bucket, 0 means unlimited
+		uint16_t ratePerSecond = 0;
+		uint16_t burst = 0;
+	};
+
+	using Rules = std::array<Rule, 256>;
+
+	enum class Outcome : uint8_t {
+		Queued,
+		Coalesced,
+		Dropped,
+	};
+
+	struct PushResult {
+		Outcome outcome = Outcome::Queued;
+		// The packet was queued while no flush task was pending, the caller must add one
+		bool scheduleFlush = false;
+		// The queue is full, the connection must stop reading until the flush resumes it
+		bool pauseReading = false;
+	};
+
+	struct Stats {
+		uint64_t queued = 0;
+		uint64_t coalesced = 0;
+		uint64_t dropped = 0;
+	};
+
+	InboundQueue(const Rules &rules, size_t maxQueued);
+
+	// Non-copyable
+	InboundQueue(const InboundQueue &) = delete;
+	InboundQueue &operator=(const InboundQueue &) = delete;
+
+	PushResult push(InboundMessage_ptr msg, int64_t nowMs);
+
+	/**
+	 * Takes every queued packet, in arrival order, and ends the pending flush.
+	 * @param resumeReading Set if reading was paused by a full queue and must be resumed.
+	 */
+	std::vector<InboundMessage_ptr> take(bool &resumeReading);
+
+	Stats getStats() const;
+
+	static uint8_t getOpcode(const NetworkMessage &msg);
+
+private:
+	struct Entry {
+		uint8_t opcode;
+		InboundMessage_ptr msg;
+	};
+
+	struct TokenBucket {
+		double tokens = -1;
+		int64_t lastRefillMs = 0;
+	};
+
+	uint8_t getGroup(uint8_t opcode) const {
+		return rules[opcode].group != 0 ? rules[opcode].group : opcode;
+	}
+
+	bool consumeToken(uint8_t opcode, int64_t nowMs);
+	static bool samePayload(const NetworkMessage &first, const NetworkMessage &second);
+
+	const Rules &rules;
+	const size_t maxQueued;
+
+	mutable std::mutex mutex;
+	std::vector<Entry> entries;
+	std::map<uint8_t, TokenBucket> buckets;
+	bool flushScheduled = false;
+	bool readingPaused = false;
+	Stats stats;
+};
@@ -59,6 +59,8 @@ public:
 	}
 
 	std::string getString(uint16_t stringLen = 0);
+	// Same as getString without the copy, the view is only valid until the message is reused or released
+	std::string_view getStringView(uint16_t stringLen = 0);
 	Position getPosition();
 
 	// skips count unknown/unused bytes in an incoming message
@@ -24,6 +24,7 @@ void OutputMessagePool::scheduleSendAll() {
 void OutputMessagePool::sendAll() {
 	// dispatcher thread
 	for (auto &protocol : bufferedProtocols) {
+		protocol->flushPendingMessages();
 		auto &msg = protocol->getCurrentBuffer();
 		if (msg) {
 			protocol->send(std::move(msg));
@@ -10,9 +10,11 @@
 #include "pch.hpp"
 
 #include "server/network/protocol/protocol.hpp"
+#include "server/network/message/inboundmessage.hpp"
 #include "server/network/message/outputmessage.hpp"
 #include "security/rsa.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "lib/thread/thread_pool.hpp"
 
 void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 	if (!rawMessages) {
@@ -38,16 +40,21 @@ void Protocol::onSendMessage(const OutputMessage_ptr &msg) {
 	}
 }
 
-bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
-	if (encryptionEnabled && !XTEA_decrypt(msg)) {
+bool Protocol::sendRecvMessageCallback(InboundMessage_ptr msg) {
+	if (encryptionEnabled && !XTEA_decrypt(*msg)) {
 		g_logger().error("[Protocol::onRecvMessage] - XTEA_decrypt Failed");
 		return false;
 	}
 
-	g_dispatcher().addEvent([&msg, protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
+	return dispatchInboundMessage(std::move(msg));
+}
+
+bool Protocol::dispatchInboundMessage(InboundMessage_ptr msg) {
+	// The dispatcher task owns the packet, the connection reads the next one into another pooled message
+	g_dispatcher().addEvent([msg = std::move(msg), protocolWeak = std::weak_ptr<Protocol>(shared_from_this())]() {
 		if (auto protocol = protocolWeak.lock()) {
 			if (auto protocolConnection = protocol->getConnection()) {
-				protocol->parsePacket(msg);
+				protocol->parsePacket(*msg);
 				protocolConnection->resumeWork();
 			}
 		} }, __FUNCTION__);
@@ -55,9 +62,9 @@ bool Protocol::sendRecvMessageCallback(NetworkMessage &msg) {
 	return true;
 }
 
-bool Protocol::onRecvMessage(NetworkMessage &msg) {
+bool Protocol::onRecvMessage(InboundMessage_ptr msg) {
 	if (checksumMethod != CHECKSUM_METHOD_NONE) {
-		uint32_t recvChecksum = msg.get<uint32_t>();
+		uint32_t recvChecksum = msg->get<uint32_t>();
 		if (checksumMethod == CHECKSUM_METHOD_SEQUENCE) {
 			if (recvChecksum == 0) {
 				// checksum 0 indicate that the packet should be connection ping - 0x1C packet header
@@ -77,9 +84,9 @@ bool Protocol::onRecvMessage(NetworkMessage &msg) {
 			}
 		} else {
 			uint32_t checksum;
-			if (int32_t len = msg.getLength() - msg.getBufferPosition();
+			if (int32_t len = msg->getLength() - msg->getBufferPosition();
 				len > 0) {
-				checksum = adlerChecksum(msg.getBuffer() + msg.getBufferPosition(), len);
+				checksum = adlerChecksum(msg->getBuffer() + msg->getBufferPosition(), len);
 			} else {
 				checksum = 0;
 			}
@@ -91,7 +98,7 @@ bool Protocol::onRecvMessage(NetworkMessage &msg) {
 		}
 	}
 
-	return sendRecvMessageCallback(msg);
+	return sendRecvMessageCallback(std::move(msg));
 }
 
 OutputMessage_ptr Protocol::getOutputBuffer(int32_t size) {
@@ -106,36 +113,13 @@ OutputMessage_ptr Protocol::getOutputBuffer(int32_t size) {
 }
 
 void Protocol::XTEA_encrypt(OutputMessage &msg) const {
-	const uint32_t delta = 0x61C88647;
-
 	// The message must be a multiple of 8
 	size_t paddingBytes = msg.getLength() & 7;
 	if (paddingBytes != 0) {
 		msg.addPaddingBytes(8 - paddingBytes);
 	}
 
-	uint8_t* buffer = msg.getOutputBuffer();
-	auto messageLength = static_cast<int32_t>(msg.getLength());
-	int32_t readPos = 0;
-	const std::array<uint32_t, 4> newKey = { key[0], key[1], key[2], key[3] };
-	// TODO: refactor this for not use c-style
-	uint32_t precachedControlSum[32][2];
-	uint32_t sum = 0;
-	for (int32_t i = 0; i < 32; ++i) {
-		precachedControlSum[i][0] = (sum + newKey[sum & 3]);
-		sum -= delta;
-		precachedControlSum[i][1] = (sum + newKey[(sum >> 11) & 3]);
-	}
-	while (readPos < messageLength) {
-		std::array<uint32_t, 2> vData = {};
-		memcpy(vData.data(), buffer + readPos, 8);
-		for (int32_t i = 0; i < 32; ++i) {
-			vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][0];
-			vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][1];
-		}
-		memcpy(buffer + readPos, vData.data(), 8);
-		readPos += 8;
-	}
+	XTEA::encrypt(msg.getOutputBuffer(), msg.getLength(), encryptRoundKeys);
 }
 
 bool Protocol::XTEA_decrypt(NetworkMessage &msg) const {
@@ -144,30 +128,7 @@ bool Protocol::XTEA_decrypt(NetworkMessage &msg) const {
 		return false;
 	}
 
-	const uint32_t delta = 0x61C88647;
-
-	uint8_t* buffer = msg.getBuffer() + msg.getBufferPosition();
-	auto messageLength = static_cast<int32_t>(msgLength);
-	int32_t readPos = 0;
-	const std::array<uint32_t, 4> newKey = { key[0], key[1], key[2], key[3] };
-	// TODO: refactor this for not use c-style
-	uint32_t precachedControlSum[32][2];
-	uint32_t sum = 0xC6EF3720;
-	for (int32_t i = 0; i < 32; ++i) {
-		precachedControlSum[i][0] = (sum + newKey[(sum >> 11) & 3]);
-		sum += delta;
-		precachedControlSum[i][1] = (sum + newKey[sum & 3]);
-	}
-	while (readPos < messageLength) {
-		std::array<uint32_t, 2> vData = {};
-		memcpy(vData.data(), buffer + readPos, 8);
-		for (int32_t i = 0; i < 32; ++i) {
-			vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][0];
-			vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][1];
-		}
-		memcpy(buffer + readPos, vData.data(), 8);
-		readPos += 8;
-	}
+	XTEA::decrypt(msg.getBuffer() + msg.getBufferPosition(), msgLength, decryptRoundKeys);
 
 	uint16_t innerLength = msg.get<uint16_t>();
 	if (std::cmp_greater(innerLength, msgLength - 2)) {
@@ -189,6 +150,30 @@ bool Protocol::RSA_decrypt(NetworkMessage &msg) {
 	return (msg.getByte() == 0);
 }
 
+void Protocol::decryptFirstMessage(NetworkMessage &msg) {
+	auto connection = getConnection();
+	if (!connection) {
+		return;
+	}
+
+	firstMessageDeferred = true;
+	inject<ThreadPool>().detach_task([&msg, connection, protocolWeak = std::weak_ptr<Protocol>(shared_from_this())] {
+		auto protocol = protocolWeak.lock();
+		if (!protocol) {
+			return;
+		}
+
+		if (!RSA_decrypt(msg)) {
+			g_logger().warn("[Protocol::decryptFirstMessage] - RSA Decrypt Failed");
+			protocol->disconnect();
+			return;
+		}
+
+		protocol->onFirstMessageDecrypted(msg);
+		connection->resumeWork();
+	});
+}
+
 uint32_t Protocol::getIP() const {
 	if (auto protocolConnection = getConnection()) {
 		return protocolConnection->getIP();
@@ -11,6 +11,7 @@
 
 #include "server/network/connection/connection.hpp"
 #include "config/configmanager.hpp"
+#include "security/xtea.hpp"
 
 class Protocol : public std::enable_shared_from_this<Protocol> {
 public:
@@ -26,10 +27,16 @@ public:
 	virtual void parsePacket(NetworkMessage &) { }
 
 	virtual void onSendMessage(const OutputMessage_ptr &msg);
-	bool onRecvMessage(NetworkMessage &msg);
-	bool sendRecvMessageCallback(NetworkMessage &msg);
+	bool onRecvMessage(InboundMessage_ptr msg);
+	bool sendRecvMessageCallback(InboundMessage_ptr msg);
+	// Hands a decrypted packet to the dispatcher, returns true if the connection must wait for resumeWork
+	virtual bool dispatchInboundMessage(InboundMessage_ptr msg);
 	virtual void onRecvFirstMessage(NetworkMessage &msg) = 0;
+	// Continues the first message once its RSA block was decrypted by decryptFirstMessage
+	virtual void onFirstMessageDecrypted(NetworkMessage &) { }
 	virtual void onConnect() { }
+	// Called by the OutputMessagePool right before the autosend buffer is sent
+	virtual void flushPendingMessages() { }
 
 	bool isConnectionExpired() const {
 		return connectionPtr.expired();
@@ -41,6 +48,11 @@ public:
 
 	uint32_t getIP() const;
 
+	// True once the first message was handed to the thread pool, the connection must wait for resumeWork
+	bool isFirstMessageDeferred() const {
+		return firstMessageDeferred;
+	}
+
 	// Use this function for autosend messages only
 	OutputMessage_ptr getOutputBuffer(int32_t size);
 
@@ -66,13 +78,22 @@ protected:
 		encryptionEnabled = true;
 	}
 	void setXTEAKey(const uint32_t* newKey) {
-		memcpy(this->key.data(), newKey, sizeof(*newKey) * 4);
+		XTEA::Key key;
+		memcpy(key.data(), newKey, sizeof(*newKey) * 4);
+		encryptRoundKeys = XTEA::expandEncryptKey(key);
+		decryptRoundKeys = XTEA::expandDecryptKey(key);
 	}
 	void setChecksumMethod(ChecksumMethods_t method) {
 		checksumMethod = method;
 	}
 
 	static bool RSA_decrypt(NetworkMessage &msg);
+	/**
+	 * Decrypts the RSA block of the first message on the thread pool, then calls
+	 * onFirstMessageDecrypted from the worker and resumes reading the connection.
+	 * The message stays owned by the connection, which is kept alive until then.
+	 */
+	void decryptFirstMessage(NetworkMessage &msg);
 
 	void setRawMessages(bool value) {
 		rawMessages = value;
@@ -114,12 +135,14 @@ private:
 	OutputMessage_ptr outputBuffer;
 
 	const ConnectionWeak_ptr connectionPtr;
-	std::array<uint32_t, 4> key = {};
+	XTEA::RoundKeys encryptRoundKeys = {};
+	XTEA::RoundKeys decryptRoundKeys = {};
 	uint32_t serverSequenceNumber = 0;
 	uint32_t clientSequenceNumber = 0;
 	std::underlying_type_t<ChecksumMethods_t> checksumMethod = CHECKSUM_METHOD_NONE;
 	bool encryptionEnabled = false;
 	bool rawMessages = false;
+	bool firstMessageDeferred = false;
 
 	friend class Connection;
 };
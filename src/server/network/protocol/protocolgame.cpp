@@ -42,6 +42,7 @@
 #include "enums/account_coins.hpp"
 
 #include "creatures/players/highscore_category.hpp"
+#include "lib/metrics/metrics.hpp"
 
 /*
  * NOTE: This namespace is used so that we can add functions without having to declare them in the ".hpp/.hpp" file
@@ -51,6 +52,9 @@
 // This "getIteration" function will allow us to get the total number of iterations that run within a specific map
 // Very useful to send the total amount in certain bytes in the ProtocolGame class
 namespace {
+	// Pending effects are written in chunks so a single message never outgrows the output buffer
+	constexpr uint16_t MAX_EFFECTS_BLOCK_LENGTH = 4096;
+
 	template <typename T>
 	uint16_t getIterationIncreaseCount(T &map) {
 		uint16_t totalIterationCount = 0;
@@ -245,8 +249,34 @@ namespace {
 	}
 } // namespace
 
+namespace {
+	const InboundQueue::Rules &getInboundRules() {
+		static const InboundQueue::Rules rules = [] {
+			InboundQueue::Rules result {};
+			using Coalesce = InboundQueue::Coalesce;
+			// Ping back / ping
+			result[0x1D] = { 0, Coalesce::DropDuplicate };
+			result[0x1E] = { 0, Coalesce::DropDuplicate };
+			// Auto-walk, only the newest path matters
+			result[0x64] = { 0, Coalesce::ReplaceLast, 10, 10 };
+			// Stop auto-walk
+			result[0x69] = { 0, Coalesce::DropDuplicate };
+			// Turn north/east/south/west, only the last direction matters
+			for (uint8_t opcode = 0x6F; opcode <= 0x72; ++opcode) {
+				result[opcode] = { 0x6F, Coalesce::ReplaceLast, 10, 10 };
+			}
+			// Look at / look in battle list
+			result[0x8C] = { 0, Coalesce::DropDuplicate, 10, 10 };
+			result[0x8D] = { 0, Coalesce::DropDuplicate, 10, 10 };
+			return result;
+		}();
+		return rules;
+	}
+}
+
 ProtocolGame::ProtocolGame(Connection_ptr initConnection) :
-	Protocol(initConnection) {
+	Protocol(initConnection),
+	inboundQueue(getInboundRules(), g_configManager().getNumber(INBOUND_PACKET_QUEUE_SIZE, __FUNCTION__)) {
 	version = CLIENT_VERSION;
 }
 
@@ -734,16 +764,17 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 	clientVersion = static_cast<int32_t>(msg.get<uint32_t>());
 
 	if (!oldProtocol) {
-		msg.getString(); // Client version (String)
+		msg.getStringView(); // Client version (String)
 	}
 
 	msg.skipBytes(3); // U16 dat revision, U8 game preview state
 
-	if (!Protocol::RSA_decrypt(msg)) {
-		g_logger().warn("[ProtocolGame::onRecvFirstMessage] - RSA Decrypt Failed");
-		disconnect();
-		return;
-	}
+	clientOperatingSystem = operatingSystem;
+	decryptFirstMessage(msg);
+}
+
+void ProtocolGame::onFirstMessageDecrypted(NetworkMessage &msg) {
+	const OperatingSystem_t operatingSystem = clientOperatingSystem;
 
 	std::array<uint32_t, 4> key = { msg.get<uint32_t>(), msg.get<uint32_t>(), msg.get<uint32_t>(), msg.get<uint32_t>() };
 	enableXTEAEncryption();
@@ -776,8 +807,8 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 
 	if (!oldProtocol && operatingSystem == CLIENTOS_NEW_LINUX) {
 		// TODO: check what new info for linux is send
-		msg.getString();
-		msg.getString();
+		msg.getStringView();
+		msg.getStringView();
 	}
 
 	std::string characterName = msg.getString();
@@ -801,7 +832,7 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 
 	// OTCv8 version detection
 	uint16_t otcV8StringLength = msg.get<uint16_t>();
-	if (otcV8StringLength == 5 && msg.getString(5) == "OTCv8") {
+	if (otcV8StringLength == 5 && msg.getStringView(5) == "OTCv8") {
 		otclientV8 = msg.get<uint16_t>(); // 253, 260, 261, ...
 	}
 
@@ -850,7 +881,7 @@ void ProtocolGame::onRecvFirstMessage(NetworkMessage &msg) {
 
 		auto output = OutputMessagePool::getOutputMessage();
 		output->addByte(0x14);
-		output->addString(ss.str(), "ProtocolGame::onRecvFirstMessage - ss.str()");
+		output->addString(ss.str(), "ProtocolGame::onFirstMessageDecrypted - ss.str()");
 		send(output);
 		g_dispatcher().scheduleEvent(
 			1000, [self = getThis()] { self->disconnect(); }, "ProtocolGame::disconnect"
@@ -902,6 +933,97 @@ void ProtocolGame::writeToOutputBuffer(const NetworkMessage &msg) {
 	out->append(msg);
 }
 
+void ProtocolGame::addPendingEffect(const Position &pos, MagicEffectsType_t kind, uint16_t type, int8_t deltaX /* = 0*/, int8_t deltaY /* = 0*/) {
+	pendingEffects.push_back({ pos, kind, type, deltaX, deltaY });
+}
+
+void ProtocolGame::flushPendingMessages() {
+	// dispatcher thread
+	if (pendingEffects.empty()) {
+		return;
+	}
+
+	// Group the effects by position, keeping the order of the effects on the same tile
+	std::ranges::stable_sort(pendingEffects, [](const PendingEffect &a, const PendingEffect &b) {
+		return std::tie(a.pos.z, a.pos.y, a.pos.x) < std::tie(b.pos.z, b.pos.y, b.pos.x);
+	});
+
+	NetworkMessage msg;
+	size_t blocks = 0;
+	for (auto it = pendingEffects.begin(), end = pendingEffects.end(); it != end;) {
+		const Position &pos = it->pos;
+		msg.addByte(0x83);
+		msg.addPosition(pos);
+		for (; it != end && it->pos == pos; ++it) {
+			msg.addByte(it->kind);
+			msg.add<uint16_t>(it->type);
+			if (it->kind == MAGIC_EFFECTS_CREATE_DISTANCEEFFECT) {
+				msg.addByte(static_cast<uint8_t>(it->deltaX));
+				msg.addByte(static_cast<uint8_t>(it->deltaY));
+			}
+		}
+		msg.addByte(MAGIC_EFFECTS_END_LOOP);
+		++blocks;
+
+		if (msg.getLength() >= MAX_EFFECTS_BLOCK_LENGTH) {
+			writeToOutputBuffer(msg);
+			msg.reset();
+		}
+	}
+
+	if (msg.getLength() > 0) {
+		writeToOutputBuffer(msg);
+	}
+
+	g_metrics().addCounter("network_effects_sent", pendingEffects.size());
+	g_metrics().addCounter("network_effect_messages_avoided", pendingEffects.size() - blocks);
+	pendingEffects.clear();
+}
+
+bool ProtocolGame::dispatchInboundMessage(InboundMessage_ptr msg) {
+	// The login packet is parsed through onRecvFirstMessage, this only sees the game packets
+	if (!g_configManager().getBoolean(INBOUND_PACKET_SHAPING, __FUNCTION__)) {
+		return Protocol::dispatchInboundMessage(std::move(msg));
+	}
+
+	const uint8_t opcode = InboundQueue::getOpcode(*msg);
+	const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	const auto result = inboundQueue.push(std::move(msg), nowMs);
+	if (result.outcome == InboundQueue::Outcome::Coalesced) {
+		g_metrics().addCounter("inbound_packets_coalesced", 1, { { "opcode", fmt::format("0x{:02X}", opcode) } });
+	} else if (result.outcome == InboundQueue::Outcome::Dropped) {
+		g_metrics().addCounter("inbound_packets_dropped", 1, { { "opcode", fmt::format("0x{:02X}", opcode) } });
+	}
+
+	if (result.scheduleFlush) {
+		g_dispatcher().addEvent([self = std::weak_ptr<ProtocolGame>(getThis())] {
+			if (auto protocol = self.lock()) {
+				protocol->flushInboundPackets();
+			} }, "ProtocolGame::flushInboundPackets");
+	}
+
+	// Keep reading while there is room, the packets are parsed in order by the flush task
+	return result.pauseReading;
+}
+
+void ProtocolGame::flushInboundPackets() {
+	bool resumeReading = false;
+	const auto messages = inboundQueue.take(resumeReading);
+
+	auto connection = getConnection();
+	if (!connection) {
+		return;
+	}
+
+	for (const auto &msg : messages) {
+		parsePacket(*msg);
+	}
+
+	if (resumeReading) {
+		connection->resumeWork();
+	}
+}
+
 void ProtocolGame::parsePacket(NetworkMessage &msg) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN || msg.getLength() <= 0) {
 		return;
@@ -983,7 +1105,7 @@ void ProtocolGame::addBless() {
 	player->checkAndShowBlessingMessage();
 }
 
-void ProtocolGame::parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyte) {
+void ProtocolGame::parsePacketFromDispatcher(NetworkMessage &msg, uint8_t recvbyte) {
 	if (!acceptPackets || g_game().getGameState() == GAME_STATE_SHUTDOWN) {
 		return;
 	}
@@ -6167,6 +6289,12 @@ void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, u
 	if (oldProtocol && type > 0xFF) {
 		return;
 	}
+	if (!oldProtocol && acceptPackets) {
+		const auto deltaX = static_cast<int8_t>(static_cast<int32_t>(to.x) - static_cast<int32_t>(from.x));
+		const auto deltaY = static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y));
+		addPendingEffect(from, MAGIC_EFFECTS_CREATE_DISTANCEEFFECT, type, deltaX, deltaY);
+		return;
+	}
 	NetworkMessage msg;
 	if (oldProtocol) {
 		msg.addByte(0x85);
@@ -6235,6 +6363,11 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 		return;
 	}
 
+	if (!oldProtocol && acceptPackets) {
+		addPendingEffect(pos, MAGIC_EFFECTS_CREATE_EFFECT, type);
+		return;
+	}
+
 	NetworkMessage msg;
 	if (oldProtocol) {
 		msg.addByte(0x83);
@@ -6254,6 +6387,9 @@ void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	if (oldProtocol && type > 0xFF) {
 		return;
 	}
+	// The effect loop has no removal, so the effects added before it are sent first
+	flushPendingMessages();
+
 	NetworkMessage msg;
 	msg.addByte(0x84);
 	msg.addPosition(pos);
@@ -6707,6 +6843,8 @@ void ProtocolGame::sendAddCreature(std::shared_ptr<Creature> creature, const Pos
 
 void ProtocolGame::sendMoveCreature(std::shared_ptr<Creature> creature, const Position &newPos, int32_t newStackPos, const Position &oldPos, int32_t oldStackPos, bool teleport) {
 	if (creature == player) {
+		// Effects are relative to the current view, send them before it moves
+		flushPendingMessages();
 		if (oldStackPos >= 10) {
 			sendMapDescription(newPos);
 		} else if (teleport) {
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "server/network/protocol/protocol.hpp"
+#include "server/network/message/inboundqueue.hpp"
 #include "creatures/interactions/chat.hpp"
 #include "creatures/creature.hpp"
 #include "enums/forge_conversion.hpp"
@@ -90,6 +91,9 @@ private:
 	void disconnectClient(const std::string &message) const;
 	void writeToOutputBuffer(const NetworkMessage &msg);
 
+	void flushPendingMessages() override;
+	void addPendingEffect(const Position &pos, MagicEffectsType_t kind, uint16_t type, int8_t deltaX = 0, int8_t deltaY = 0);
+
 	void release() override;
 
 	void checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown);
@@ -99,9 +103,12 @@ private:
 	bool canSee(const Position &pos) const;
 
 	// we have all the parse methods
+	bool dispatchInboundMessage(InboundMessage_ptr msg) override;
+	void flushInboundPackets();
 	void parsePacket(NetworkMessage &msg) override;
-	void parsePacketFromDispatcher(NetworkMessage msg, uint8_t recvbyte);
+	void parsePacketFromDispatcher(NetworkMessage &msg, uint8_t recvbyte);
 	void onRecvFirstMessage(NetworkMessage &msg) override;
+	void onFirstMessageDecrypted(NetworkMessage &msg) override;
 	void onConnect() override;
 
 	// Parse methods
@@ -499,10 +506,24 @@ private:
 	std::unordered_set<uint32_t> knownCreatureSet;
 	std::shared_ptr<Player> player = nullptr;
 
+	struct PendingEffect {
+		Position pos;
+		MagicEffectsType_t kind;
+		uint16_t type;
+		int8_t deltaX;
+		int8_t deltaY;
+	};
+	// Magic effects and distance shots waiting for the next autosend, written as one effect loop per position
+	std::vector<PendingEffect> pendingEffects;
+
+	InboundQueue inboundQueue;
+
 	uint32_t eventConnect = 0;
 	uint32_t challengeTimestamp = 0;
 	uint16_t version = 0;
 	int32_t clientVersion = 0;
+	// Read before the RSA block, used once it is decrypted
+	OperatingSystem_t clientOperatingSystem = CLIENTOS_NONE;
 
 	uint8_t challengeRandom = 0;
 
@@ -13,6 +13,7 @@
 #include "server/network/message/outputmessage.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "account/account.hpp"
+#include "security/password_verifier.hpp"
 #include "io/iologindata.hpp"
 #include "creatures/players/management/ban.hpp"
 #include "game/game.hpp"
@@ -41,7 +42,28 @@ void ProtocolLogin::getCharacterList(const std::string &accountDescriptor, const
 		return;
 	}
 
-	if (account.load() != enumToValue(AccountErrors_t::Ok) || !account.authenticate(password)) {
+	if (account.load() != enumToValue(AccountErrors_t::Ok)) {
+		std::ostringstream ss;
+		ss << (oldProtocol ? "Username" : "Email") << " or password is not correct.";
+		disconnectClient(ss.str());
+		return;
+	}
+
+	// The password is hashed on the verification threads, the list is sent back from the dispatcher
+	const bool queued = g_passwordVerifier().verifyAsync(getIP(), account.getID(), password, account.getPassword(), [self = std::static_pointer_cast<ProtocolLogin>(shared_from_this()), account, accountDescriptor, password](bool verified) {
+		g_dispatcher().addEvent([self, account, accountDescriptor, password, verified] {
+			self->sendCharacterList(account, accountDescriptor, password, verified);
+		},
+								"ProtocolLogin::sendCharacterList");
+	});
+
+	if (!queued) {
+		disconnectClient("Too many login attempts.\nPlease try again in a moment.");
+	}
+}
+
+void ProtocolLogin::sendCharacterList(const Account &account, const std::string &accountDescriptor, const std::string &password, bool verified) {
+	if (!verified) {
 		std::ostringstream ss;
 		ss << (oldProtocol ? "Username" : "Email") << " or password is not correct.";
 		disconnectClient(ss.str());
@@ -120,12 +142,10 @@ void ProtocolLogin::onRecvFirstMessage(NetworkMessage &msg) {
 	 - 1 byte: preview world(971+)
 	 */
 
-	if (!Protocol::RSA_decrypt(msg)) {
-		g_logger().warn("[ProtocolLogin::onRecvFirstMessage] - RSA Decrypt Failed");
-		disconnect();
-		return;
-	}
+	decryptFirstMessage(msg);
+}
 
+void ProtocolLogin::onFirstMessageDecrypted(NetworkMessage &msg) {
 	std::array<uint32_t, 4> key = { msg.get<uint32_t>(), msg.get<uint32_t>(), msg.get<uint32_t>(), msg.get<uint32_t>() };
 	enableXTEAEncryption();
 	setXTEAKey(key.data());
@@ -11,6 +11,7 @@
 
 #include "server/network/protocol/protocol.hpp"
 
+class Account;
 class NetworkMessage;
 class OutputMessage;
 
@@ -27,12 +28,14 @@ public:
 	explicit ProtocolLogin(Connection_ptr loginConnection) :
 		Protocol(loginConnection) { }
 
-	void onRecvFirstMessage(NetworkMessage &msg);
+	void onRecvFirstMessage(NetworkMessage &msg) override;
+	void onFirstMessageDecrypted(NetworkMessage &msg) override;
 
 private:
 	void disconnectClient(const std::string &message);
 
 	void getCharacterList(const std::string &accountDescriptor, const std::string &password);
+	void sendCharacterList(const Account &account, const std::string &accountDescriptor, const std::string &password, bool verified);
 
 	bool oldProtocol = false;
 };
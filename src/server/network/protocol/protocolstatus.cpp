@@ -43,7 +43,7 @@ void ProtocolStatus::onRecvFirstMessage(NetworkMessage &msg) {
 	switch (msg.getByte()) {
 		// XML info protocol
 		case 0xFF: {
-			if (msg.getString(4) == "info") {
+			if (msg.getStringView(4) == "info") {
 				g_dispatcher().addEvent([self = std::static_pointer_cast<ProtocolStatus>(shared_from_this())] {
 					self->sendStatusString();
 				},
@@ -9,6 +9,7 @@
 
 #include "pch.hpp"
 
+#include "game/functions/memory_census.hpp"
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/save_manager.hpp"
@@ -23,6 +24,7 @@ Signals::Signals(asio::io_service &service) :
 	set.add(SIGTERM);
 #ifndef _WIN32
 	set.add(SIGUSR1);
+	set.add(SIGUSR2);
 	set.add(SIGHUP);
 #else
 	// This must be a blocking call as Windows calls it in a new thread and terminates
@@ -65,6 +67,9 @@ void Signals::dispatchSignalHandler(int signal) {
 		case SIGUSR1: // Saves game state
 			g_dispatcher().addEvent(sigusr1Handler, "sigusr1Handler");
 			break;
+		case SIGUSR2: // Dumps the item memory census
+			g_dispatcher().addEvent(sigusr2Handler, "sigusr2Handler");
+			break;
 #else
 		case SIGBREAK: // Shuts the server down
 			g_dispatcher().addEvent(sigbreakHandler, "sigbreakHandler");
@@ -95,6 +100,12 @@ void Signals::sigusr1Handler() {
 	g_saveManager().scheduleAll();
 }
 
+void Signals::sigusr2Handler() {
+	// Dispatcher thread
+	g_logger().info("SIGUSR2 received, running the memory census...");
+	MemoryCensus::run(20, "memory_census.json");
+}
+
 void Signals::sighupHandler() {
 	// Dispatcher thread
 	g_logger().info("SIGHUP received, reloading config files...");
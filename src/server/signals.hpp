@@ -24,4 +24,5 @@ private:
 	static void sighupHandler();
 	static void sigtermHandler();
 	static void sigusr1Handler();
+	static void sigusr2Handler();
 };
@@ -0,0 +1,101 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/combat/combat.hpp"
+#include "creatures/stub_creature.hpp"
+#include "items/tile.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// One creature per tile, on rows of ten tiles
+	std::vector<std::shared_ptr<Tile>> placeTargets(size_t count) {
+		std::vector<std::shared_ptr<Tile>> tiles;
+		for (size_t i = 0; i < count; ++i) {
+			auto tile = std::make_shared<DynamicTile>(static_cast<uint16_t>(100 + i % 10), static_cast<uint16_t>(100 + i / 10), 7);
+			tile->internalAddThing(std::make_shared<StubCreature>());
+			tiles.emplace_back(std::move(tile));
+		}
+		return tiles;
+	}
+}
+
+suite<"creatures"> combatBenchmark = [] {
+	test("Area combat target passes with 1/10/50 targets") = [] {
+		constexpr int32_t CASTS = 20000;
+		const Position center(100, 100, 7);
+
+		for (const size_t count : { 1, 10, 50 }) {
+			const auto area = placeTargets(count);
+			// canDoCombat is left out of both, it calls into the Lua events
+			uint64_t passesHits = 0;
+			uint64_t collectedHits = 0;
+
+			// Before: a tile list built for every cast, then a pass for the range, one counting the targets and one hitting them
+			Benchmark bm_passes;
+			for (int32_t cast = 0; cast < CASTS; ++cast) {
+				std::forward_list<std::shared_ptr<Tile>> tileList;
+				for (const auto &tile : area) {
+					tileList.push_front(tile);
+				}
+
+				uint32_t maxX = 0;
+				for (const auto &tile : tileList) {
+					maxX = std::max<uint32_t>(maxX, Position::getDistanceX(tile->getPosition(), center));
+				}
+				int affected = 0;
+				for (const auto &tile : tileList) {
+					affected += static_cast<int>(tile->getCreatures()->size());
+				}
+				for (const auto &tile : tileList) {
+					for (const auto &creature : *tile->getCreatures()) {
+						passesHits += affected > 0 && creature->getHealth() > 0;
+					}
+				}
+			}
+			const double passesDuration = bm_passes.duration();
+
+			// Now: the targets are collected once into reused buffers and checked again before each hit
+			std::vector<std::shared_ptr<Tile>> tiles;
+			std::vector<std::pair<size_t, std::shared_ptr<Creature>>> targets;
+			Benchmark bm_collected;
+			for (int32_t cast = 0; cast < CASTS; ++cast) {
+				tiles.assign(area.begin(), area.end());
+
+				uint32_t maxX = 0;
+				for (size_t index = 0; index < tiles.size(); ++index) {
+					maxX = std::max<uint32_t>(maxX, Position::getDistanceX(tiles[index]->getPosition(), center));
+					for (const auto &creature : *tiles[index]->getCreatures()) {
+						targets.emplace_back(index, creature);
+					}
+				}
+				for (const auto &[index, creature] : targets) {
+					if (Combat::isValidAreaTarget(creature, tiles[index])) {
+						collectedHits += creature->getHealth() > 0;
+					}
+				}
+
+				tiles.clear();
+				targets.clear();
+			}
+			const double collectedDuration = bm_collected.duration();
+
+			expect(eq(passesHits, collectedHits));
+			expect(eq(collectedHits, count * CASTS));
+			fmt::print(
+				"Area combat with {} targets: separate passes {:.0f} ns/cast, collected targets {:.0f} ns/cast\n",
+				count, passesDuration * 1e6 / CASTS, collectedDuration * 1e6 / CASTS
+			);
+		}
+	};
+};
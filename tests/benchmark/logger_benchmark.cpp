@@ -0,0 +1,65 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Counts the messages that reach the sink, with the level handling of LogWithSpdLog
+	class CountingLogger final : public Logger {
+	public:
+		void setLevel(const std::string &name) override {
+			setMinimumLevel(getLevelFromName(name));
+		}
+
+		std::string getLevel() const override {
+			return std::string { getLevelName(getMinimumLevel()) };
+		}
+
+		void log(const std::string &lvl, fmt::basic_string_view<char> msg) const override {
+			log(getLevelFromName(lvl), msg);
+		}
+
+		void log(LogLevel, fmt::basic_string_view<char> msg) const override {
+			++messages;
+			bytes += msg.size();
+		}
+
+		mutable size_t messages = 0;
+		mutable size_t bytes = 0;
+	};
+}
+
+suite<"lib"> loggerBenchmark = [] {
+	test("Logger disabled and enabled call cost") = [] {
+		constexpr size_t CALLS = 1000000;
+		CountingLogger logger;
+		logger.setLevel("info");
+
+		Benchmark bm_disabled;
+		for (size_t i = 0; i < CALLS; ++i) {
+			logger.debug("Creature {} walked to {}, {}, {}", i, i + 1, i + 2, 7);
+		}
+		const double disabledDuration = bm_disabled.duration();
+
+		Benchmark bm_enabled;
+		for (size_t i = 0; i < CALLS; ++i) {
+			logger.info("Creature {} walked to {}, {}, {}", i, i + 1, i + 2, 7);
+		}
+		const double enabledDuration = bm_enabled.duration();
+
+		expect(eq(logger.messages, CALLS));
+		fmt::print("Log calls: {:.1f} ns disabled, {:.1f} ns enabled\n", disabledDuration * 1e6 / CALLS, enabledDuration * 1e6 / CALLS);
+	};
+};
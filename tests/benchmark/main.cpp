@@ -0,0 +1,5 @@
+#include <boost/ut.hpp>
+
+using namespace boost::ut;
+
+int main() { }
@@ -0,0 +1,67 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "server/network/message/inboundmessage.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// A say packet (0x96) as it is after the headers: opcode, speak class, text
+	void writeSayPacket(NetworkMessage &msg, const std::string &text) {
+		msg.addByte(0x96);
+		msg.addByte(0x01);
+		msg.addString(text, __FUNCTION__);
+		msg.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+	}
+}
+
+suite<"server"> networkMessageBenchmark = [] {
+	test("Inbound packet parse throughput") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		constexpr int32_t PACKETS = 20000;
+		const std::string text(64, 'a');
+		size_t parsedBytes = 0;
+
+		// Before: the packet was copied into the dispatcher task and its strings copied out
+		NetworkMessage source;
+		writeSayPacket(source, text);
+		Benchmark bm_copy;
+		for (int32_t i = 0; i < PACKETS; ++i) {
+			NetworkMessage copy = source;
+			copy.getByte();
+			copy.getByte();
+			parsedBytes += copy.getString().size();
+		}
+		const double copyDuration = bm_copy.duration();
+
+		// Now: the pooled packet is moved into the task and read in place
+		Benchmark bm_pooled;
+		for (int32_t i = 0; i < PACKETS; ++i) {
+			auto msg = InboundMessagePool::getInboundMessage();
+			writeSayPacket(*msg, text);
+			auto task = [msg = std::move(msg)] {
+				msg->getByte();
+				msg->getByte();
+				return msg->getStringView().size();
+			};
+			parsedBytes += task();
+		}
+		const double pooledDuration = bm_pooled.duration();
+
+		expect(eq(parsedBytes, 2 * PACKETS * text.size()));
+		fmt::print("Inbound packets: {:.0f}/s copied, {:.0f}/s pooled\n", copyDuration > 0 ? PACKETS / (copyDuration / 1000.0) : 0.0, pooledDuration > 0 ? PACKETS / (pooledDuration / 1000.0) : 0.0);
+	};
+};
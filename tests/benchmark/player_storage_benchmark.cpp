@@ -0,0 +1,48 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/players/storages/player_storage.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+suite<"creatures"> playerStorageBenchmark = [] {
+	test("PlayerStorage lookup throughput") = [] {
+		constexpr uint32_t KEYS = 5000;
+		constexpr int32_t LOOKUPS = 1000000;
+
+		std::map<uint32_t, int32_t> map;
+		PlayerStorage storage;
+		for (uint32_t key = 0; key < KEYS; ++key) {
+			map[key * 7] = key;
+			storage.load(key * 7, key);
+		}
+
+		int64_t mapSum = 0;
+		Benchmark bm_map;
+		for (int32_t i = 0; i < LOOKUPS; ++i) {
+			auto it = map.find((i % KEYS) * 7);
+			mapSum += it != map.end() ? it->second : -1;
+		}
+		const double mapDuration = bm_map.duration();
+
+		int64_t storageSum = 0;
+		Benchmark bm_storage;
+		for (int32_t i = 0; i < LOOKUPS; ++i) {
+			storageSum += storage.get((i % KEYS) * 7);
+		}
+		const double storageDuration = bm_storage.duration();
+
+		expect(eq(mapSum, storageSum));
+		fmt::print("Storage lookups: {:.1f} ns std::map, {:.1f} ns PlayerStorage\n", mapDuration * 1e6 / LOOKUPS, storageDuration * 1e6 / LOOKUPS);
+	};
+};
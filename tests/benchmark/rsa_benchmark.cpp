@@ -0,0 +1,73 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "security/rsa.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// The default key set by RSA::start when key.pem is missing
+	constexpr const char* DEFAULT_P = "14299623962416399520070177382898895550795403345466153217470516082934737582776038882967213386204600674145392845853859217990626450972452084065728686565928113";
+	constexpr const char* DEFAULT_Q = "7630979195970404721891201847792002125535401292779123937207447574596692788513647179235335529307251350570728407373705564708871762033017096809910315212884101";
+
+	// Encrypts the 128 bytes block in place with the public key (e = 65537), as the client does
+	void publicEncrypt(char* block) {
+		mpz_t p, q, n, m;
+		mpz_inits(p, q, n, m, nullptr);
+		mpz_set_str(p, DEFAULT_P, 10);
+		mpz_set_str(q, DEFAULT_Q, 10);
+		mpz_mul(n, p, q);
+
+		mpz_import(m, 128, 1, 1, 0, 0, block);
+		mpz_powm_ui(m, m, 65537, n);
+
+		size_t count = (mpz_sizeinbase(m, 2) + 7) / 8;
+		memset(block, 0, 128 - count);
+		mpz_export(block + (128 - count), nullptr, 1, 1, 0, 0, m);
+		mpz_clears(p, q, n, m, nullptr);
+	}
+
+	std::array<char, 128> randomBlock(std::mt19937 &rng) {
+		std::array<char, 128> block {};
+		// The first byte is always zero in the protocol, which keeps the message below n
+		for (size_t i = 1; i < block.size(); ++i) {
+			block[i] = static_cast<char>(rng() & 0xFF);
+		}
+		return block;
+	}
+}
+
+suite<"security"> rsaBenchmark = [] {
+	test("RSA::decrypt throughput") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		auto &rsa = DI::create<RSA &>();
+		rsa.setKey(DEFAULT_P, DEFAULT_Q);
+
+		std::mt19937 rng(0x5EED);
+		auto block = randomBlock(rng);
+		publicEncrypt(block.data());
+
+		constexpr int32_t DECRYPTIONS = 1000;
+		Benchmark bm_decrypt;
+		for (int32_t i = 0; i < DECRYPTIONS; ++i) {
+			auto copy = block;
+			rsa.decrypt(copy.data());
+		}
+		const double duration = bm_decrypt.duration();
+
+		fmt::print("RSA decrypt: {:.0f} logins/s per thread\n", duration > 0 ? DECRYPTIONS / (duration / 1000.0) : 0.0);
+	};
+};
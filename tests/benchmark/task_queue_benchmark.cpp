@@ -0,0 +1,141 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task_function.hpp"
+#include "lib/thread/mpsc_queue.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct Item {
+		size_t producer = 0;
+		size_t sequence = 0;
+	};
+
+	// Each producer pushes its items in order while one consumer takes them, as the dispatcher does
+	template <typename Push, typename Drain>
+	std::vector<std::vector<size_t>> runProducers(size_t producers, size_t itemsPerProducer, Push push, Drain drain) {
+		std::atomic_size_t finished = 0;
+		std::vector<std::thread> threads;
+		for (size_t producer = 0; producer < producers; ++producer) {
+			threads.emplace_back([&, producer] {
+				for (size_t sequence = 0; sequence < itemsPerProducer; ++sequence) {
+					push(producer, sequence);
+				}
+				finished.fetch_add(1);
+			});
+		}
+
+		std::vector<std::vector<size_t>> received(producers);
+		const auto collect = [&received](const Item &item) {
+			received[item.producer].push_back(item.sequence);
+		};
+		while (finished.load() < producers) {
+			drain(collect);
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		drain(collect);
+		return received;
+	}
+
+	bool receivedInOrder(const std::vector<std::vector<size_t>> &received, size_t itemsPerProducer) {
+		for (const auto &sequences : received) {
+			if (sequences.size() != itemsPerProducer) {
+				return false;
+			}
+			for (size_t i = 0; i < sequences.size(); ++i) {
+				if (sequences[i] != i) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+suite<"game"> taskQueueBenchmark = [] {
+	test("Task ingestion contention, locked vectors against lock-free queues") = [] {
+		constexpr size_t PRODUCERS = 8;
+		constexpr size_t ITEMS = 200000;
+		struct LockedTask {
+			Item item;
+			std::function<void(void)> function;
+		};
+		struct QueuedTask {
+			Item item;
+			TaskFunction function;
+		};
+		auto target = std::make_shared<int>(0);
+
+		// Previous ingestion: a locked vector of std::function per producer thread, swept every cycle
+		std::vector<std::pair<std::mutex, std::vector<LockedTask>>> lockedThreads(PRODUCERS);
+		std::vector<LockedTask> lockedTasks;
+		Benchmark bm_locked;
+		const auto lockedReceived = runProducers(
+			PRODUCERS, ITEMS,
+			[&](size_t producer, size_t sequence) {
+				auto &[mutex, tasks] = lockedThreads[producer];
+				std::scoped_lock lock(mutex);
+				tasks.push_back({ { producer, sequence }, [target, producer, sequence] { *target += static_cast<int>(producer + sequence); } });
+			},
+			[&](const auto &collect) {
+				for (auto &[mutex, tasks] : lockedThreads) {
+					std::scoped_lock lock(mutex);
+					lockedTasks.insert(lockedTasks.end(), std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+					tasks.clear();
+				}
+				for (const auto &task : lockedTasks) {
+					collect(task.item);
+				}
+				lockedTasks.clear();
+			}
+		);
+		const double lockedDuration = bm_locked.duration();
+
+		std::vector<std::unique_ptr<OverflowingMpscQueue<QueuedTask, 1024>>> queues;
+		for (size_t producer = 0; producer < PRODUCERS; ++producer) {
+			queues.emplace_back(std::make_unique<OverflowingMpscQueue<QueuedTask, 1024>>());
+		}
+		std::vector<QueuedTask> queuedTasks;
+		Benchmark bm_lockFree;
+		const auto lockFreeReceived = runProducers(
+			PRODUCERS, ITEMS,
+			[&](size_t producer, size_t sequence) {
+				queues[producer]->push({ { producer, sequence }, [target, producer, sequence] { *target += static_cast<int>(producer + sequence); } });
+			},
+			[&](const auto &collect) {
+				for (const auto &queue : queues) {
+					queue->drainTo(queuedTasks);
+				}
+				for (const auto &task : queuedTasks) {
+					collect(task.item);
+				}
+				queuedTasks.clear();
+			}
+		);
+		const double lockFreeDuration = bm_lockFree.duration();
+
+		expect(receivedInOrder(lockedReceived, ITEMS));
+		expect(receivedInOrder(lockFreeReceived, ITEMS));
+
+		const auto nanosecondsPerTask = [](double milliseconds) {
+			return milliseconds * 1e6 / (PRODUCERS * ITEMS);
+		};
+		fmt::print(
+			"Task ingestion with {} producers on {} cores: locked vectors {:.1f} ns/task, lock-free queues {:.1f} ns/task\n",
+			PRODUCERS, std::thread::hardware_concurrency(), nanosecondsPerTask(lockedDuration), nanosecondsPerTask(lockFreeDuration)
+		);
+	};
+};
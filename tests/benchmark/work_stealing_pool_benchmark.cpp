@@ -0,0 +1,68 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/thread/work_stealing_pool.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t CREATURES = 8192;
+
+	// Stands in for a creature think: the first creatures (a crowded hunting ground) cost far more
+	uint64_t thinkCost(size_t creature) {
+		return creature < CREATURES / 16 ? 20000 : 400;
+	}
+
+	uint64_t think(size_t creature) {
+		uint64_t state = creature + 1;
+		for (uint64_t i = 0, cost = thinkCost(creature); i < cost; ++i) {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		}
+		return state;
+	}
+}
+
+suite<"lib"> workStealingPoolBenchmark = [] {
+	test("WorkStealingPool checkCreatures-like workload at 2/4/8/16 threads") = [] {
+		std::vector<uint64_t> results(CREATURES);
+
+		Benchmark bm_serial;
+		for (size_t creature = 0; creature < CREATURES; ++creature) {
+			results[creature] = think(creature);
+		}
+		const double serialDuration = bm_serial.duration();
+		const auto expected = results;
+
+		for (const size_t threads : { 2, 4, 8, 16 }) {
+			WorkStealingPool pool(threads - 1);
+
+			// Previous approach: one equal slice per thread, waiting for the slowest slice
+			std::ranges::fill(results, 0);
+			Benchmark bm_static;
+			pool.parallelFor(0, CREATURES, [&results](size_t creature) { results[creature] = think(creature); }, CREATURES / threads);
+			const double staticDuration = bm_static.duration();
+			expect(results == expected);
+
+			std::ranges::fill(results, 0);
+			Benchmark bm_stealing;
+			pool.parallelFor(0, CREATURES, [&results](size_t creature) { results[creature] = think(creature); }, 16);
+			const double stealingDuration = bm_stealing.duration();
+			expect(results == expected);
+
+			fmt::print(
+				"checkCreatures-like workload, {} threads on {} cores: serial {:.2f} ms, static slices {:.2f} ms, work stealing {:.2f} ms\n",
+				threads, std::thread::hardware_concurrency(), serialDuration, staticDuration, stealingDuration
+			);
+		}
+	};
+};
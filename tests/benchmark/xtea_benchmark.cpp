@@ -0,0 +1,52 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+#include "utils/benchmark.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	XTEA::Key randomKey(std::mt19937 &rng) {
+		return { static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()) };
+	}
+
+	std::vector<uint8_t> randomBytes(std::mt19937 &rng, size_t size) {
+		std::vector<uint8_t> bytes(size);
+		for (auto &byte : bytes) {
+			byte = static_cast<uint8_t>(rng());
+		}
+		return bytes;
+	}
+}
+
+suite<"security"> xteaBenchmark = [] {
+	test("XTEA::encrypt throughput") = [] {
+		std::mt19937 rng(0x5EED);
+		constexpr size_t SIZE = 4 * 1024 * 1024;
+		auto buffer = randomBytes(rng, SIZE);
+		const auto roundKeys = XTEA::expandEncryptKey(randomKey(rng));
+
+		Benchmark bm_scalar;
+		XTEA::encryptScalar(buffer.data(), buffer.size(), roundKeys);
+		const double scalarDuration = bm_scalar.duration();
+
+		Benchmark bm_vector;
+		XTEA::encrypt(buffer.data(), buffer.size(), roundKeys);
+		const double vectorDuration = bm_vector.duration();
+
+		const auto throughput = [](double milliseconds) {
+			return milliseconds > 0 ? (SIZE / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+		};
+		fmt::print("XTEA encrypt: scalar {:.0f} MB/s, {} {:.0f} MB/s\n", throughput(scalarDuration), XTEA::getKernelName(), throughput(vectorDuration));
+	};
+};
@@ -0,0 +1,48 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#pragma once
+
+#include "creatures/creature.hpp"
+
+// A creature without a type, for placing on tiles built outside of the map
+class StubCreature final : public Creature {
+public:
+	explicit StubCreature(int32_t initHealth = 100) {
+		health = initHealth;
+		healthMax = initHealth;
+	}
+
+	const std::string &getName() const override {
+		return name;
+	}
+	const std::string &getTypeName() const override {
+		return name;
+	}
+	const std::string &getNameDescription() const override {
+		return name;
+	}
+	std::string getDescription(int32_t) override {
+		return name;
+	}
+
+	CreatureType_t getType() const override {
+		return CREATURETYPE_MONSTER;
+	}
+
+	void setID() override { }
+	void removeList() override { }
+	void addList() override { }
+
+	void setHealth(int32_t newHealth) {
+		health = newHealth;
+	}
+
+private:
+	std::string name = "stub";
+};
@@ -0,0 +1,95 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/combat/combat.hpp"
+#include "creatures/stub_creature.hpp"
+#include "items/tile.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	using Offsets = std::vector<std::pair<int32_t, int32_t>>;
+
+	Offsets toPairs(const std::vector<AreaCombat::Offset> &offsets) {
+		Offsets pairs;
+		for (const auto &offset : offsets) {
+			pairs.emplace_back(offset.x, offset.y);
+		}
+		return pairs;
+	}
+}
+
+suite<"creatures"> combatAreaTest = [] {
+	test("AreaCombat compiles a beam into offsets for every direction") = [] {
+		AreaCombat area;
+		area.setupArea(3, 0);
+
+		expect(Offsets { { 0, -2 }, { 0, -1 }, { 0, 0 } } == toPairs(area.getOffsets(DIRECTION_NORTH)));
+		expect(Offsets { { 0, 0 }, { 0, 1 }, { 0, 2 } } == toPairs(area.getOffsets(DIRECTION_SOUTH)));
+		expect(Offsets { { 0, 0 }, { 1, 0 }, { 2, 0 } } == toPairs(area.getOffsets(DIRECTION_EAST)));
+		expect(Offsets { { -2, 0 }, { -1, 0 }, { 0, 0 } } == toPairs(area.getOffsets(DIRECTION_WEST)));
+		expect(area.getOffsets(DIRECTION_NORTHEAST).empty());
+	};
+
+	test("AreaCombat compiles a circle with the same tiles in every direction") = [] {
+		AreaCombat area;
+		area.setupArea(3);
+
+		// Radius 3 covers the center, its 4 neighbours and the 4 diagonals
+		const auto &north = area.getOffsets(DIRECTION_NORTH);
+		expect(eq(9u, north.size()));
+		for (const auto dir : { DIRECTION_SOUTH, DIRECTION_EAST, DIRECTION_WEST }) {
+			auto expected = toPairs(north);
+			auto actual = toPairs(area.getOffsets(dir));
+			std::ranges::sort(expected);
+			std::ranges::sort(actual);
+			expect(expected == actual) << "direction" << static_cast<int>(dir);
+		}
+	};
+
+	test("AreaCombat clone keeps the offsets and clear drops them") = [] {
+		AreaCombat area;
+		area.setupArea(2, 0);
+		area.setupExtArea({ 1, 0, 0, 3 }, 2);
+
+		const auto copy = area.clone();
+		for (uint8_t dir = DIRECTION_NORTH; dir <= DIRECTION_LAST; ++dir) {
+			expect(toPairs(area.getOffsets(static_cast<Direction>(dir))) == toPairs(copy->getOffsets(static_cast<Direction>(dir))));
+		}
+		expect(Offsets { { -1, -1 }, { 0, 0 } } == toPairs(copy->getOffsets(DIRECTION_NORTHWEST)));
+
+		area.clear();
+		for (uint8_t dir = DIRECTION_NORTH; dir <= DIRECTION_LAST; ++dir) {
+			expect(area.getOffsets(static_cast<Direction>(dir)).empty());
+		}
+	};
+
+	test("Combat::isValidAreaTarget drops targets that died, were removed or moved") = [] {
+		const auto tile = std::make_shared<DynamicTile>(100, 100, 7);
+		const auto otherTile = std::make_shared<DynamicTile>(101, 100, 7);
+
+		const auto target = std::make_shared<StubCreature>();
+		tile->internalAddThing(target);
+		expect(Combat::isValidAreaTarget(target, tile));
+
+		target->setHealth(0);
+		expect(!Combat::isValidAreaTarget(target, tile));
+		target->setHealth(100);
+
+		otherTile->internalAddThing(target);
+		expect(!Combat::isValidAreaTarget(target, tile));
+		expect(Combat::isValidAreaTarget(target, otherTile));
+
+		target->setRemoved();
+		expect(!Combat::isValidAreaTarget(target, otherTile));
+	};
+};
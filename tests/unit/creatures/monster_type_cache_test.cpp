@@ -0,0 +1,222 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/monsters/monster_type_cache.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "io/io_bosstiary.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	LootBlock makeLoot(uint16_t id, uint32_t chance) {
+		LootBlock loot;
+		loot.id = id;
+		loot.chance = chance;
+		loot.countmin = 1;
+		loot.countmax = 3;
+		loot.name = fmt::format("item {}", id);
+		loot.article = "a";
+		loot.text = "engraved";
+		loot.actionId = 1000 + id;
+		loot.attack = 12;
+		loot.unique = id % 2 == 0;
+		return loot;
+	}
+
+	spellBlock_t makeSpell(const std::string &name, int32_t minCombatValue) {
+		spellBlock_t spellBlock;
+		spellBlock.source = std::make_shared<MonsterSpell>();
+		auto &spell = *spellBlock.source;
+		spell.name = name;
+		spell.chance = 25;
+		spell.interval = 1500;
+		spell.minCombatValue = minCombatValue;
+		spell.maxCombatValue = minCombatValue * 2;
+		spell.length = 5;
+		spell.spread = 2;
+		spell.combatSpell = true;
+		spell.outfit.lookType = 35;
+		spell.outfitMonster = "rat";
+		spell.shoot = CONST_ANI_FIRE;
+		spell.effect = CONST_ME_HITBYFIRE;
+		spell.conditionType = CONDITION_POISON;
+		spell.combatType = COMBAT_FIREDAMAGE;
+		spell.soundCastEffect = SoundEffect_t::MONSTER_SPELL_SUMMON;
+		return spellBlock;
+	}
+
+	void populate(MonsterType &monsterType) {
+		monsterType.name = "Cached Demon";
+		monsterType.typeName = "cached demon";
+		monsterType.nameDescription = "a cached demon";
+		monsterType.variantName = "elite";
+
+		auto &info = monsterType.info;
+		info.elementMap = { { COMBAT_FIREDAMAGE, -20 }, { COMBAT_ICEDAMAGE, 15 } };
+		info.reflectMap = { { COMBAT_FIREDAMAGE, 5 } };
+		info.healingMap = { { COMBAT_ICEDAMAGE, 10 } };
+		info.voiceVector = { { "MUHAHAHA!", true }, { "Your soul will be mine!", false } };
+
+		// A bag holding a bag holding an item
+		auto bag = makeLoot(2853, 10000);
+		auto innerBag = makeLoot(2854, 5000);
+		innerBag.childLoot.push_back(makeLoot(3031, 100000));
+		bag.childLoot.push_back(std::move(innerBag));
+		bag.childLoot.push_back(makeLoot(3035, 20000));
+		info.lootItems = { makeLoot(3043, 1500), std::move(bag) };
+
+		info.scripts = { "demon_a.lua", "demon_b.lua" };
+		info.attackSpells.push_back(makeSpell("melee", -100));
+		info.attackSpells.push_back(makeSpell("fire wave", -300));
+		info.defenseSpells.push_back(makeSpell("healing", 80));
+		info.summons = { { "fire elemental", 10, 2000, 1, true } };
+
+		info.skull = SKULL_RED;
+		info.outfit.lookType = 35;
+		info.outfit.lookHead = 94;
+		info.outfit.lookAddons = 3;
+		info.race = RACE_FIRE;
+		info.respawnType = { RESPAWNPERIOD_NIGHT, true };
+		info.light = { 6, 215 };
+		info.lookcorpse = 5995;
+		info.baseSpeed = 256;
+		info.experience = 6000;
+		info.manaCost = 0;
+		info.yellChance = 10;
+		info.yellSpeedTicks = 5000;
+		info.staticAttackChance = 90;
+		info.maxSummons = 1;
+		info.changeTargetSpeed = 4000;
+
+		info.m_conditionImmunities.set(CONDITION_POISON);
+		info.m_conditionImmunities.set(CONDITION_PARALYZE);
+		info.m_damageImmunities.set(COMBAT_FIREDAMAGE);
+
+		info.bestiaryOccurrence = 2;
+		info.bestiaryStars = 4;
+		info.bestiaryToUnlock = 2500;
+		info.bestiaryFirstUnlock = 100;
+		info.bestiarySecondUnlock = 1000;
+		info.bestiaryCharmsPoints = 50;
+		info.raceid = 35;
+		info.bestiaryLocations = "Edron, Goroma";
+		info.bestiaryClass = "Demon";
+		info.bestiaryRace = BESTY_RACE_DEMON;
+		info.bosstiaryRace = BosstiaryRarity_t::RARITY_NEMESIS;
+		info.bosstiaryClass = "Demon";
+
+		info.mitigation = 1.68f;
+		info.soundChance = 15;
+		info.soundSpeedTicks = 3000;
+		info.soundVector = { SoundEffect_t::MONSTER_SPELL_SUMMON };
+		info.deathSound = SoundEffect_t::MONSTER_SPELL_SUMMON;
+		info.targetDistance = 4;
+		info.runAwayHealth = 200;
+		info.health = 8200;
+		info.healthMax = 8200;
+		info.changeTargetChance = 20;
+		info.defense = 55;
+		info.armor = 44;
+		info.critChance = 10;
+		info.strategiesTargetNearest = 70;
+		info.strategiesTargetHealth = 10;
+		info.strategiesTargetDamage = 10;
+		info.strategiesTargetRandom = 10;
+		info.targetPreferPlayer = true;
+		info.faction = FACTION_LION;
+		info.enemyFactions.insert(FACTION_LIONUSURPERS);
+		info.canPushItems = true;
+		info.pushable = false;
+		info.isHostile = true;
+		info.hiddenHealth = true;
+		info.isRewardBoss = true;
+		info.canWalkOnEnergy = false;
+		info.isForgeCreature = false;
+	}
+}
+
+suite<"creatures"> monsterTypeCacheTest = [] {
+	test("MonsterTypeCache decodes every field of a monster type it encoded") = [] {
+		MonsterType original;
+		populate(original);
+		const auto data = MonsterTypeCache::encodeType(original);
+
+		MonsterType decoded;
+		expect(MonsterTypeCache::decodeType(data, decoded) >> fatal);
+		// Every serialized field, nested loot and spell descriptors included, encodes the same again
+		expect(MonsterTypeCache::encodeType(decoded) == data);
+
+		expect(eq(decoded.variantName, std::string("elite")));
+		const auto &info = decoded.info;
+		expect(eq(info.lootItems.size(), 2U) >> fatal);
+		expect(eq(info.lootItems[1].childLoot.size(), 2U) >> fatal);
+		expect(eq(info.lootItems[1].childLoot[0].childLoot.size(), 1U) >> fatal);
+		expect(eq(info.lootItems[1].childLoot[0].childLoot[0].id, uint16_t(3031)));
+		expect(eq(info.attackSpells.size(), 2U) >> fatal);
+		expect(eq(info.attackSpells[1].source->name, std::string("fire wave")));
+		// The combat is built again when the type is registered
+		expect(info.attackSpells[1].spell == nullptr);
+		expect(info.m_conditionImmunities.test(CONDITION_PARALYZE) && !info.m_conditionImmunities.test(CONDITION_FIRE));
+		expect(info.m_damageImmunities.test(COMBAT_FIREDAMAGE));
+		expect(decoded.info.enemyFactions.contains(FACTION_LIONUSURPERS));
+		expect(eq(info.bestiaryLocations, std::string("Edron, Goroma")));
+		expect(info.bosstiaryRace == BosstiaryRarity_t::RARITY_NEMESIS);
+		expect(decoded.isBoss());
+	};
+
+	test("MonsterTypeCache rejects a monster type cut short") = [] {
+		MonsterType original;
+		populate(original);
+		const auto data = MonsterTypeCache::encodeType(original);
+
+		MonsterType decoded;
+		expect(!MonsterTypeCache::decodeType(std::string_view(data).substr(0, data.size() - 1), decoded));
+		// Trailing bytes mean the layout changed without a format bump
+		expect(!MonsterTypeCache::decodeType(data + '\0', decoded));
+	};
+
+	test("MonsterTypeCache keeps the names and bestiary and bosstiary entries of each file") = [] {
+		MonsterType demon;
+		populate(demon);
+
+		MonsterTypeCache::CachedFiles files;
+		auto &cachedType = files["demons/demon.lua"].emplace_back();
+		cachedType.names = { "cached demon", "cached demon elite" };
+		cachedType.bestiary = true;
+		cachedType.bosstiary = true;
+		cachedType.data = MonsterTypeCache::encodeType(demon);
+		files["rats/rat.lua"].push_back({ { "rat" }, true, false, "rat data" });
+
+		MonsterTypeCache::CachedFiles decoded;
+		expect(MonsterTypeCache::decodeFiles(MonsterTypeCache::encodeFiles(files), decoded) >> fatal);
+		expect(eq(decoded.size(), 2U) >> fatal);
+		const auto &demonTypes = decoded.at("demons/demon.lua");
+		expect(eq(demonTypes.size(), 1U) >> fatal);
+		expect(demonTypes[0].names == cachedType.names);
+		expect(demonTypes[0].bestiary && demonTypes[0].bosstiary);
+		expect(demonTypes[0].data == cachedType.data);
+		const auto &ratTypes = decoded.at("rats/rat.lua");
+		expect(ratTypes.size() == 1 && ratTypes[0].bestiary && !ratTypes[0].bosstiary);
+	};
+
+	test("MonsterTypeCache drops every file of a corrupted cache") = [] {
+		MonsterTypeCache::CachedFiles files;
+		files["rats/rat.lua"].push_back({ { "rat" }, true, false, "rat data" });
+		auto data = MonsterTypeCache::encodeFiles(files);
+		// A file count no cache this size can hold
+		data[3] = '\x7F';
+
+		MonsterTypeCache::CachedFiles decoded;
+		expect(!MonsterTypeCache::decodeFiles(data, decoded));
+		expect(decoded.empty());
+	};
+};
@@ -0,0 +1,60 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/players/storages/player_storage.hpp"
+
+using namespace boost::ut;
+
+suite<"creatures"> playerStorageTest = [] {
+	test("PlayerStorage only reports the keys changed since loading") = [] {
+		PlayerStorage storage;
+		storage.load(100, 1);
+		storage.load(101, 2);
+		storage.load(102, 3);
+
+		expect(eq(storage.set(100, 1), 1));
+		expect(eq(storage.set(101, 5), 2));
+		expect(eq(storage.set(200, 7), -1));
+		storage.erase(102);
+		expect(eq(storage.get(102), -1));
+
+		auto changes = storage.getChanges();
+		std::ranges::sort(changes.updated);
+		expect(changes.updated == std::vector<std::pair<uint32_t, int32_t>> { { 101, 5 }, { 200, 7 } });
+		expect(changes.erased == std::vector<uint32_t> { 102 });
+	};
+
+	test("PlayerStorage keeps a change made while saving dirty") = [] {
+		PlayerStorage storage;
+		storage.set(100, 1);
+		const auto changes = storage.getChanges();
+		storage.set(100, 2);
+		storage.set(101, 1);
+
+		storage.markSaved(changes.sequence);
+		auto remaining = storage.getChanges();
+		std::ranges::sort(remaining.updated);
+		expect(remaining.updated == std::vector<std::pair<uint32_t, int32_t>> { { 100, 2 }, { 101, 1 } });
+
+		storage.markSaved(remaining.sequence);
+		expect(storage.getChanges().updated.empty());
+	};
+
+	test("PlayerStorage keeps the changes of a failed save") = [] {
+		PlayerStorage storage;
+		storage.set(100, 1);
+		static_cast<void>(storage.getChanges());
+
+		// No markSaved, the transaction was rolled back
+		expect(eq(storage.getChanges().updated.size(), 1U));
+	};
+};
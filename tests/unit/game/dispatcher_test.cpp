@@ -0,0 +1,69 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/logging/in_memory_logger.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+suite<"game"> dispatcherTest = [] {
+	test("TickBudget is exhausted once its time has passed") = [] {
+		expect(!TickBudget(1h).isExhausted());
+		expect(TickBudget(0ms).isExhausted());
+
+		const TickBudget budget(5ms);
+		std::this_thread::sleep_for(10ms);
+		expect(budget.isExhausted());
+	};
+
+	test("Task keeps a view of its context instead of a copy") = [] {
+		constexpr std::string_view context = "DispatcherTest::aContextLongerThanTheSmallStringBuffer";
+		const Task task(0, [] { }, context);
+		expect(task.getContext().data() == context.data());
+	};
+
+	test("Dispatcher runs a resumable event in slices, after the tasks queued meanwhile") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		ThreadPool threadPool(injector.create<Logger &>());
+		Dispatcher dispatcher(threadPool);
+		dispatcher.init();
+		// Wakes the loop regularly, so it sees the pool stopping
+		dispatcher.cycleEvent(10, [] { }, "DispatcherTest::wake");
+
+		// Only used on the dispatcher thread until the job is done
+		std::vector<std::string> order;
+		std::promise<void> done;
+		dispatcher.addResumableEvent(
+			[&, slices = 0](const TickBudget &) mutable {
+				order.push_back(fmt::format("slice{}", ++slices));
+				if (slices == 1) {
+					dispatcher.addEvent([&order] { order.emplace_back("event"); }, "DispatcherTest::event");
+				}
+				if (slices < 3) {
+					return true;
+				}
+
+				done.set_value();
+				return false;
+			},
+			"DispatcherTest::job"
+		);
+
+		const auto status = done.get_future().wait_for(5s);
+		threadPool.shutdown();
+		expect((status == std::future_status::ready) >> fatal);
+		expect(order == std::vector<std::string> { "slice1", "event", "slice2", "slice3" });
+	};
+};
@@ -0,0 +1,84 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/player_journal.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	std::vector<PlayerJournalRecord> makeRecords() {
+		return {
+			{ 1, 10, PlayerJournalType::Experience, 0, 4200 },
+			{ 2, 10, PlayerJournalType::Level, 0, 30 },
+			{ 3, 11, PlayerJournalType::Capacity, 0, 40000 },
+			{ 4, 10, PlayerJournalType::HealthMax, 0, 305 },
+		};
+	}
+
+	std::string encodeAll(const std::vector<PlayerJournalRecord> &records) {
+		std::string buffer;
+		for (const auto &record : records) {
+			PlayerJournal::encode(record, buffer);
+		}
+		return buffer;
+	}
+}
+
+suite<"game"> playerJournalTest = [] {
+	test("PlayerJournal decodes what it encoded") = [] {
+		const auto records = makeRecords();
+		const auto buffer = encodeAll(records);
+
+		std::vector<PlayerJournalRecord> decoded;
+		expect(eq(PlayerJournal::decode(buffer, decoded), buffer.size()));
+		expect(decoded == records);
+	};
+
+	test("PlayerJournal drops a record cut short and a corrupted one with everything after") = [] {
+		const auto records = makeRecords();
+		const auto buffer = encodeAll(records);
+		const size_t recordSize = buffer.size() / records.size();
+
+		// Crash while the last record was written
+		std::vector<PlayerJournalRecord> decoded;
+		const std::string_view cut(buffer.data(), buffer.size() - 3);
+		expect(eq(PlayerJournal::decode(cut, decoded), 3 * recordSize));
+		expect(eq(decoded.size(), 3U));
+
+		auto corrupted = buffer;
+		corrupted[recordSize + 12] ^= 0x40;
+		decoded.clear();
+		expect(eq(PlayerJournal::decode(corrupted, decoded), recordSize));
+		expect(decoded.size() == 1 && decoded[0] == records[0]);
+	};
+
+	test("PlayerJournal keeps the latest values not saved yet") = [] {
+		PlayerJournal::Values values;
+		PlayerJournal::fold(makeRecords(), values);
+		PlayerJournal::fold(
+			{
+				{ 5, 10, PlayerJournalType::Experience, 0, 4300 },
+				// Saved after the fourth record, the experience changed since
+				{ 6, 10, PlayerJournalType::Saved, 0, 4 },
+				{ 7, 11, PlayerJournalType::Saved, 0, 6 },
+				// A bank balance journaled by an older build
+				{ 8, 12, static_cast<PlayerJournalType>(6), 0, 1000000 },
+			},
+			values
+		);
+
+		expect(eq(values.size(), 1U) && values.contains(10));
+		const auto &player = values[10];
+		expect(eq(player.columns.size(), 1U));
+		expect(eq(player.columns.at(PlayerJournalType::Experience).value, int64_t(4300)));
+	};
+};
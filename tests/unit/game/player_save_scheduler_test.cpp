@@ -0,0 +1,79 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/player_save_scheduler.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+suite<"game"> playerSaveSchedulerTest = [] {
+	test("PlayerSaveScheduler spreads consecutive guids across the interval") = [] {
+		PlayerSaveScheduler scheduler;
+		scheduler.setLimits(300s, 20);
+
+		std::vector<size_t> saves(300);
+		for (uint32_t guid = 1; guid <= 9000; ++guid) {
+			const auto slot = scheduler.getSlot(guid);
+			expect(slot >= 0ms && slot < 300s);
+			++saves[std::chrono::duration_cast<std::chrono::seconds>(slot).count()];
+		}
+		// 30 per second on average
+		expect(std::ranges::max(saves) < 60U && std::ranges::min(saves) > 10U);
+	};
+
+	test("PlayerSaveScheduler saves the most changed due players within the budget") = [] {
+		PlayerSaveScheduler scheduler;
+		scheduler.setLimits(60s, 2);
+		const std::vector<PlayerSaveScheduler::Candidate> players { { 1, 0 }, { 2, 50 }, { 3, 5 }, { 4, 7 } };
+
+		// Just logged in
+		auto now = PlayerSaveScheduler::Clock::now();
+		expect(scheduler.pick(players, now).empty());
+
+		now += 61s;
+		auto picked = scheduler.pick(players, now);
+		expect(picked == std::vector<uint32_t> { 2, 4 });
+		expect(eq(scheduler.getLag().overdue, 4U));
+		for (const uint32_t guid : picked) {
+			expect(scheduler.onSaved(guid, now, true) > 0ms);
+		}
+		// Saved on logout meanwhile, counts against the next second's budget
+		scheduler.onSaved(1, now, true);
+
+		now += 1s;
+		picked = scheduler.pick(players, now);
+		expect(picked == std::vector<uint32_t> { 3 });
+		// Failed, still due
+		scheduler.onSaved(3, now, false);
+
+		now += 1s;
+		picked = scheduler.pick(players, now);
+		expect(picked == std::vector<uint32_t> { 3 });
+		scheduler.onSaved(3, now, true);
+
+		now += 1s;
+		expect(scheduler.pick(players, now).empty());
+		expect(eq(scheduler.getLag().overdue, 0U));
+	};
+
+	test("PlayerSaveScheduler forgets players who logged out") = [] {
+		PlayerSaveScheduler scheduler;
+		scheduler.setLimits(60s, 10);
+		auto now = PlayerSaveScheduler::Clock::now();
+		static_cast<void>(scheduler.pick({ { 1, 0 }, { 2, 0 } }, now));
+
+		// Player 2 logged out and in again, counted as freshly loaded
+		static_cast<void>(scheduler.pick({ { 1, 0 } }, now + 1s));
+		now += 61s;
+		expect(scheduler.pick({ { 1, 0 }, { 2, 0 } }, now) == std::vector<uint32_t> { 1 });
+	};
+};
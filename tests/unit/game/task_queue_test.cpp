@@ -0,0 +1,172 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task_function.hpp"
+#include "lib/thread/mpsc_queue.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	struct Item {
+		size_t producer = 0;
+		size_t sequence = 0;
+	};
+
+	// Each producer pushes its items in order while one consumer takes them, as the dispatcher does
+	template <typename Push, typename Drain>
+	std::vector<std::vector<size_t>> runProducers(size_t producers, size_t itemsPerProducer, Push push, Drain drain) {
+		std::atomic_size_t finished = 0;
+		std::vector<std::thread> threads;
+		for (size_t producer = 0; producer < producers; ++producer) {
+			threads.emplace_back([&, producer] {
+				for (size_t sequence = 0; sequence < itemsPerProducer; ++sequence) {
+					push(producer, sequence);
+				}
+				finished.fetch_add(1);
+			});
+		}
+
+		std::vector<std::vector<size_t>> received(producers);
+		const auto collect = [&received](const Item &item) {
+			received[item.producer].push_back(item.sequence);
+		};
+		while (finished.load() < producers) {
+			drain(collect);
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		drain(collect);
+		return received;
+	}
+
+	bool receivedInOrder(const std::vector<std::vector<size_t>> &received, size_t itemsPerProducer) {
+		for (const auto &sequences : received) {
+			if (sequences.size() != itemsPerProducer) {
+				return false;
+			}
+			for (size_t i = 0; i < sequences.size(); ++i) {
+				if (sequences[i] != i) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+suite<"game"> taskQueueTest = [] {
+	test("TaskFunction keeps typical lambdas in place and moves them") = [] {
+		auto counter = std::make_shared<int>(0);
+		uint32_t id = 7;
+		TaskFunction function([counter, id, position = std::array<uint16_t, 3> { 1, 2, 3 }] { *counter += id + position[2]; });
+		expect(function.isInline());
+
+		TaskFunction moved(std::move(function));
+		expect(!function);
+		moved();
+		expect(eq(*counter, 10));
+
+		moved = nullptr;
+		expect(moved == nullptr);
+		expect(eq(counter.use_count(), 1L));
+	};
+
+	test("TaskFunction allocates large callables and calls mutable ones") = [] {
+		std::array<uint64_t, 16> large {};
+		int calls = 0;
+		TaskFunction function([large, &calls]() mutable {
+			large[0] = 1;
+			++calls;
+		});
+		expect(!function.isInline());
+
+		const auto &constFunction = function;
+		constFunction();
+		constFunction();
+		expect(eq(calls, 2));
+
+		expect(TaskFunction(std::function<void(void)>()) == nullptr);
+		expect(!TaskFunction(static_cast<void (*)()>(nullptr)));
+	};
+
+	test("MpscQueue keeps push order and refuses values when full") = [] {
+		MpscQueue<std::unique_ptr<int>, 4> queue;
+		for (int i = 0; i < 4; ++i) {
+			expect(queue.tryPush(std::make_unique<int>(i)));
+		}
+
+		auto rejected = std::make_unique<int>(4);
+		expect(!queue.tryPush(std::move(rejected)));
+		expect(rejected != nullptr) << "a refused value is not moved from";
+
+		std::unique_ptr<int> value;
+		expect(queue.tryPop(value) && *value == 0);
+		expect(queue.tryPush(std::move(rejected)));
+
+		std::vector<int> drained;
+		expect(eq(queue.drain([&drained](std::unique_ptr<int> &&item) { drained.push_back(*item); }), 4U));
+		expect(drained == std::vector<int> { 1, 2, 3, 4 });
+		expect(!queue.tryPop(value));
+	};
+
+	test("MpscQueue delivers every value of concurrent producers in their order") = [] {
+		constexpr size_t PRODUCERS = 4;
+		constexpr size_t ITEMS = 100000;
+		MpscQueue<Item, 1024> queue;
+
+		const auto received = runProducers(
+			PRODUCERS, ITEMS,
+			[&queue](size_t producer, size_t sequence) {
+				while (!queue.tryPush(Item { producer, sequence })) {
+					std::this_thread::yield();
+				}
+			},
+			[&queue](const auto &collect) {
+				queue.drain(collect);
+			}
+		);
+		expect(receivedInOrder(received, ITEMS));
+	};
+
+	test("OverflowingMpscQueue keeps the order of values pushed while it was full") = [] {
+		OverflowingMpscQueue<int, 4> queue;
+		std::vector<int> values;
+		for (int i = 0; i < 6; ++i) {
+			queue.push(int(i));
+		}
+		queue.drainTo(values);
+		// Room again, but the next value still waits behind the overflowed ones of the same drain
+		queue.push(6);
+		queue.drainTo(values);
+		expect(values == std::vector<int> { 0, 1, 2, 3, 4, 5, 6 });
+
+		constexpr size_t PRODUCERS = 4;
+		constexpr size_t ITEMS = 50000;
+		OverflowingMpscQueue<Item, 64> concurrentQueue;
+		std::vector<Item> drained;
+		const auto received = runProducers(
+			PRODUCERS, ITEMS,
+			[&concurrentQueue](size_t producer, size_t sequence) {
+				concurrentQueue.push(Item { producer, sequence });
+			},
+			[&](const auto &collect) {
+				concurrentQueue.drainTo(drained);
+				for (const auto &item : drained) {
+					collect(item);
+				}
+				drained.clear();
+			}
+		);
+		expect(receivedInOrder(received, ITEMS));
+	};
+};
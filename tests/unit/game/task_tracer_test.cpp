@@ -0,0 +1,61 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task_tracer.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+namespace {
+	constexpr int64_t MINUTE_MS = 60 * 1000;
+}
+
+suite<"game"> taskTracerTest = [] {
+	test("TaskTracer keeps the slowest tasks of a minute, slowest first") = [] {
+		TaskTracer tracer;
+		for (int i = 1; i <= 30; ++i) {
+			tracer.recordTask(fmt::format("Task{}", i), std::chrono::milliseconds(i), 1ms, 10 * MINUTE_MS);
+		}
+
+		const auto minutes = tracer.getMinutes();
+		expect(eq(minutes.size(), 1U) >> fatal);
+		const auto &slowest = minutes[0].slowest;
+		expect(eq(slowest.size(), TaskTracer::SLOWEST_PER_MINUTE) >> fatal);
+		expect(eq(slowest.front().context, std::string("Task30")));
+		expect(eq(slowest.back().context, std::string("Task21")));
+		expect(slowest.front().wait == 1ms);
+	};
+
+	test("TaskTracer starts a new minute and forgets the oldest ones") = [] {
+		TaskTracer tracer;
+		for (int64_t minute = 0; minute < static_cast<int64_t>(TaskTracer::MINUTES) + 2; ++minute) {
+			tracer.recordTask("Game::checkCreatures", 5ms, 0ms, minute * MINUTE_MS);
+			tracer.recordCycle(4, 8ms, minute * MINUTE_MS);
+		}
+		// Late record of a minute that was already dropped
+		tracer.recordTask("Game::checkCreatures", 50ms, 0ms, 0);
+
+		const auto minutes = tracer.getMinutes();
+		expect(eq(minutes.size(), TaskTracer::MINUTES));
+		expect(eq(minutes.front().minute, static_cast<int64_t>(TaskTracer::MINUTES) + 1));
+		expect(eq(minutes.back().minute, 2));
+		expect(eq(minutes.front().cycles, 1U));
+		expect(eq(minutes.front().maxCycleTasks, 4U));
+		expect(minutes.front().maxCycleDuration == 8ms);
+	};
+
+	test("TaskTracer clamps negative waits of tasks run before they were due") = [] {
+		TaskTracer tracer;
+		tracer.recordTask("Dispatcher::asyncEvent", 1ms, -2ms, 0);
+		expect(tracer.getMinutes()[0].slowest[0].wait == 0ms);
+	};
+};
@@ -0,0 +1,88 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Counts the messages that reach the sink, with the level handling of LogWithSpdLog
+	class CountingLogger final : public Logger {
+	public:
+		void setLevel(const std::string &name) override {
+			setMinimumLevel(getLevelFromName(name));
+		}
+
+		std::string getLevel() const override {
+			return std::string { getLevelName(getMinimumLevel()) };
+		}
+
+		void log(const std::string &lvl, fmt::basic_string_view<char> msg) const override {
+			log(getLevelFromName(lvl), msg);
+		}
+
+		void log(LogLevel, fmt::basic_string_view<char>) const override {
+			++messages;
+		}
+
+		mutable size_t messages = 0;
+	};
+
+	struct Formatted {
+		size_t* count;
+	};
+}
+
+template <>
+struct fmt::formatter<Formatted> : fmt::formatter<std::string_view> {
+	auto format(const Formatted &formatted, format_context &ctx) const {
+		++*formatted.count;
+		return fmt::formatter<std::string_view>::format("formatted", ctx);
+	}
+};
+
+suite<"lib"> loggerTest = [] {
+	test("Logger level names round trip") = [] {
+		for (auto level : { LogLevel::Trace, LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error, LogLevel::Critical, LogLevel::Off }) {
+			expect(Logger::getLevelFromName(Logger::getLevelName(level)) == level);
+		}
+		expect(Logger::getLevelFromName("warn") == LogLevel::Warning);
+		expect(Logger::getLevelFromName("err") == LogLevel::Error);
+		expect(Logger::getLevelFromName("verbose") == LogLevel::Off);
+	};
+
+	test("Logger does not format messages below the level") = [] {
+		CountingLogger logger;
+		logger.setLevel("info");
+
+		size_t formatCount = 0;
+		logger.trace("{}", Formatted { &formatCount });
+		logger.debug("{}", Formatted { &formatCount });
+		expect(eq(formatCount, 0U));
+		expect(eq(logger.messages, 0U));
+
+		logger.info("{}", Formatted { &formatCount });
+		logger.error("{}", Formatted { &formatCount });
+		expect(eq(formatCount, 2U));
+		expect(eq(logger.messages, 2U));
+		expect(eq(logger.getLevel(), std::string { "info" }));
+	};
+
+	test("Logger string level API still reaches the logger") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		auto &logger = dynamic_cast<InMemoryLogger &>(injector.create<Logger &>());
+
+		logger.warn("disk {} full", "almost");
+		expect(logger.hasLogEntry("warning", "disk almost full"));
+	};
+};
@@ -0,0 +1,100 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "lib/thread/task_graph.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> taskGraphTest = [] {
+	test("TaskGraph starts a task only after its dependencies") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		ThreadPool threadPool(injector.create<Logger &>());
+
+		std::mutex orderMutex;
+		std::vector<std::string> order;
+		const auto record = [&](const std::string &name) {
+			return [&, name] {
+				std::scoped_lock lock(orderMutex);
+				order.push_back(name);
+				return true;
+			};
+		};
+
+		TaskGraph graph(threadPool);
+		graph.add("a", {}, record("a"));
+		graph.add("b", {}, record("b"));
+		graph.add("c", { "a" }, record("c"));
+		graph.add("d", { "b", "c" }, record("d"));
+
+		expect(graph.run().empty());
+		expect(eq(order.size(), 4U) >> fatal);
+
+		const auto position = [&order](const std::string &name) {
+			return std::ranges::find(order, name) - order.begin();
+		};
+		expect(lt(position("a"), position("c")));
+		expect(lt(position("b"), position("d")));
+		expect(lt(position("c"), position("d")));
+		expect(eq(graph.getTimings().size(), 4U));
+	};
+
+	test("TaskGraph runs caller thread tasks on the calling thread") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		ThreadPool threadPool(injector.create<Logger &>());
+
+		const auto callerId = std::this_thread::get_id();
+		std::thread::id taskId;
+
+		const auto callerTask = [&taskId] {
+			taskId = std::this_thread::get_id();
+			return true;
+		};
+
+		TaskGraph graph(threadPool);
+		graph.add("pool", {}, [] { return true; });
+		graph.add("caller", { "pool" }, callerTask, true);
+
+		expect(graph.run().empty());
+		expect(taskId == callerId);
+	};
+
+	test("TaskGraph reports the failed task and skips its dependents") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		ThreadPool threadPool(injector.create<Logger &>());
+
+		std::atomic_bool dependentRan = false;
+
+		TaskGraph graph(threadPool);
+		graph.add("broken", {}, [] { return false; });
+		graph.add("dependent", { "broken" }, [&dependentRan] {
+			dependentRan = true;
+			return true;
+		});
+
+		expect(eq(graph.run(), std::string { "broken" }));
+		expect(!dependentRan);
+	};
+
+	test("TaskGraph rejects unknown dependencies") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+		ThreadPool threadPool(injector.create<Logger &>());
+
+		TaskGraph graph(threadPool);
+		expect(throws<std::invalid_argument>([&graph] { graph.add("a", { "missing" }, [] { return true; }); }));
+	};
+};
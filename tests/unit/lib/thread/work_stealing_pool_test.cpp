@@ -0,0 +1,93 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/thread/work_stealing_pool.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t CREATURES = 8192;
+
+	// Stands in for a creature think: the first creatures (a crowded hunting ground) cost far more
+	uint64_t thinkCost(size_t creature) {
+		return creature < CREATURES / 16 ? 20000 : 400;
+	}
+
+	uint64_t think(size_t creature) {
+		uint64_t state = creature + 1;
+		for (uint64_t i = 0, cost = thinkCost(creature); i < cost; ++i) {
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		}
+		return state;
+	}
+}
+
+suite<"lib"> workStealingPoolTest = [] {
+	test("WorkStealingPool::parallelFor calls every index once") = [] {
+		WorkStealingPool pool(3);
+		std::vector<std::atomic_int> calls(1000);
+		pool.parallelFor(0, calls.size(), [&calls](size_t index) {
+			calls[index].fetch_add(1);
+		});
+		expect(std::ranges::all_of(calls, [](const auto &count) { return count.load() == 1; }));
+
+		// Empty and single chunk ranges run without the workers
+		pool.parallelFor(5, 5, [](size_t) { expect(false); });
+		std::vector<int> elements { 1, 2, 3 };
+		pool.parallelForEach(elements, [](int &element) { element *= 2; }, 10);
+		expect(elements == std::vector<int> { 2, 4, 6 });
+	};
+
+	test("WorkStealingPool runs nested parallelFor calls") = [] {
+		WorkStealingPool pool(2);
+		std::atomic_uint64_t sum = 0;
+		pool.parallelFor(0, 16, [&](size_t outer) {
+			pool.parallelFor(0, 100, [&](size_t inner) {
+				sum.fetch_add(outer * 100 + inner);
+			});
+		});
+		expect(eq(sum.load(), uint64_t(1600 * 1599 / 2)));
+	};
+
+	test("WorkStealingPool rethrows after every chunk finished") = [] {
+		WorkStealingPool pool(2);
+		std::atomic_int finished = 0;
+		expect(throws([&] {
+			// One index per chunk
+			pool.parallelFor(0, 8, [&finished](size_t index) {
+				if (index == 3) {
+					throw std::runtime_error("failed");
+				}
+				finished.fetch_add(1);
+			});
+		}));
+		expect(eq(finished.load(), 7));
+	};
+
+	test("WorkStealingPool matches the serial results of an uneven workload at any grain") = [] {
+		std::vector<uint64_t> expected(CREATURES);
+		for (size_t creature = 0; creature < CREATURES; ++creature) {
+			expected[creature] = think(creature);
+		}
+
+		std::vector<uint64_t> results(CREATURES);
+		for (const size_t threads : { 2, 4, 8, 16 }) {
+			WorkStealingPool pool(threads - 1);
+			// One slice per thread, then small chunks for the idle workers to steal
+			for (const size_t grain : { CREATURES / threads, size_t(16) }) {
+				std::ranges::fill(results, 0);
+				pool.parallelFor(0, CREATURES, [&results](size_t creature) { results[creature] = think(creature); }, grain);
+				expect(results == expected) << "threads" << threads << "grain" << grain;
+			}
+		}
+	};
+};
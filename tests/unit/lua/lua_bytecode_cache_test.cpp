@@ -0,0 +1,145 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "lua/scripts/lua_bytecode_cache.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+namespace {
+	// A script and its cache directory, removed when done
+	struct ScriptFolder {
+		ScriptFolder() :
+			path(std::filesystem::temp_directory_path() / "canary_lua_bytecode_cache_test") {
+			DI::setTestContainer(&InMemoryLogger::install(injector));
+			std::filesystem::remove_all(path);
+			std::filesystem::create_directories(path / "cache");
+			lua = luaL_newstate();
+		}
+
+		~ScriptFolder() {
+			lua_close(lua);
+			std::filesystem::remove_all(path);
+		}
+
+		std::string script() const {
+			return (path / "script.lua").string();
+		}
+
+		// Writes the script with the given modification time, so tests don't depend on the file system resolution
+		void write(const std::string &source, std::filesystem::file_time_type modifiedTime) const {
+			std::ofstream(script(), std::ios::binary | std::ios::trunc) << source;
+			std::filesystem::last_write_time(script(), modifiedTime);
+		}
+
+		std::filesystem::path cacheFile() const {
+			for (const auto &entry : std::filesystem::directory_iterator(path / "cache")) {
+				return entry.path();
+			}
+			return {};
+		}
+
+		// Loads the script through the cache and runs it, returning its result or error message
+		std::string run(LuaBytecodeCache &cache) const {
+			if (cache.load(lua, script(), path / "cache") == 0) {
+				lua_pcall(lua, 0, 1, 0);
+			}
+			std::string result = lua_tostring(lua, -1) ? lua_tostring(lua, -1) : "";
+			lua_pop(lua, 1);
+			return result;
+		}
+
+		di::extension::injector<> injector {};
+		std::filesystem::path path;
+		lua_State* lua = nullptr;
+	};
+}
+
+suite<"lua"> luaBytecodeCacheTest = [] {
+	const auto now = std::filesystem::file_time_type::clock::now();
+
+	test("LuaBytecodeCache compiles a script once and loads it from cache after") = [now] {
+		ScriptFolder folder;
+		folder.write("return 'first'", now);
+
+		LuaBytecodeCache cache;
+		expect(eq(folder.run(cache), std::string("first")));
+		expect(eq(cache.getCompiledFiles(), 1U) and eq(cache.getCachedFiles(), 0U));
+		expect(!folder.cacheFile().empty());
+
+		LuaBytecodeCache nextBoot;
+		expect(eq(folder.run(nextBoot), std::string("first")));
+		expect(eq(nextBoot.getCompiledFiles(), 0U) and eq(nextBoot.getCachedFiles(), 1U));
+	};
+
+	test("LuaBytecodeCache compiles a script again when its size or content changed") = [now] {
+		ScriptFolder folder;
+		folder.write("return 'first'", now);
+		LuaBytecodeCache cache;
+		static_cast<void>(folder.run(cache));
+
+		// Touched but unchanged, still cached
+		folder.write("return 'first'", now + 1s);
+		expect(eq(folder.run(cache), std::string("first")));
+		expect(eq(cache.getCachedFiles(), 1U));
+
+		// Same size, new content
+		folder.write("return 'other'", now + 2s);
+		expect(eq(folder.run(cache), std::string("other")));
+		expect(eq(cache.getCompiledFiles(), 2U));
+
+		folder.write("return 'longer'", now + 2s);
+		expect(eq(folder.run(cache), std::string("longer")));
+		expect(eq(cache.getCompiledFiles(), 3U));
+	};
+
+	test("LuaBytecodeCache trusts an unchanged size and modification time without reading the script") = [now] {
+		ScriptFolder folder;
+		folder.write("return 'first'", now);
+		LuaBytecodeCache cache;
+		static_cast<void>(folder.run(cache));
+
+		folder.write("return 'other'", now);
+		expect(eq(folder.run(cache), std::string("first")));
+	};
+
+	test("LuaBytecodeCache compiles the script when its cache file is corrupted") = [now] {
+		ScriptFolder folder;
+		folder.write("return 'first'", now);
+		LuaBytecodeCache cache;
+		static_cast<void>(folder.run(cache));
+
+		// Valid header, cut bytecode
+		const auto cacheFile = folder.cacheFile();
+		std::filesystem::resize_file(cacheFile, std::filesystem::file_size(cacheFile) - 4);
+		expect(eq(folder.run(cache), std::string("first")));
+		expect(eq(cache.getCompiledFiles(), 2U));
+
+		std::ofstream(cacheFile, std::ios::binary | std::ios::trunc) << "garbage";
+		expect(eq(folder.run(cache), std::string("first")));
+		expect(eq(cache.getCompiledFiles(), 3U));
+
+		// Rewritten by the last compile
+		expect(eq(folder.run(cache), std::string("first")));
+		expect(eq(cache.getCachedFiles(), 1U));
+	};
+
+	test("LuaBytecodeCache skips a leading #! line like luaL_loadfile") = [now] {
+		ScriptFolder folder;
+		folder.write("#!/usr/bin/env lua\nerror('line two')", now);
+		LuaBytecodeCache cache;
+		expect(folder.run(cache).ends_with("script.lua:2: line two"));
+		expect(folder.run(cache).ends_with("script.lua:2: line two"));
+		expect(eq(cache.getCachedFiles(), 1U));
+	};
+};
@@ -0,0 +1,118 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "lua/global/lua_coroutine_scheduler.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+namespace {
+	// Same as the wait global, without checking it runs in a coroutine
+	int luaWait(lua_State* L) {
+		lua_settop(L, 1);
+		return lua_yield(L, 1);
+	}
+
+	// A Lua state with wait(ms) and a scheduler, the scheduler is cleared before the state is closed
+	struct SchedulerState {
+		SchedulerState() {
+			DI::setTestContainer(&InMemoryLogger::install(injector));
+			L = luaL_newstate();
+			luaL_openlibs(L);
+			lua_register(L, "wait", luaWait);
+			UPDATE_OTSYS_TIME();
+		}
+
+		~SchedulerState() {
+			scheduler.clear();
+			lua_close(L);
+		}
+
+		uint32_t start(const char* code) {
+			luaL_loadstring(L, code);
+			return scheduler.start(L, L, 0, 0);
+		}
+
+		std::string evaluate(const char* code) const {
+			luaL_dostring(L, code);
+			std::string result = lua_tostring(L, -1) ? lua_tostring(L, -1) : "";
+			lua_pop(L, 1);
+			return result;
+		}
+
+		// Lets the given time pass and runs the dispatcher tick
+		void tick(std::chrono::milliseconds elapsed) {
+			std::this_thread::sleep_for(elapsed);
+			UPDATE_OTSYS_TIME();
+			scheduler.resumeDue();
+		}
+
+		di::extension::injector<> injector {};
+		lua_State* L = nullptr;
+		LuaCoroutineScheduler scheduler;
+	};
+}
+
+suite<"lua"> luaCoroutineSchedulerTest = [] {
+	test("LuaCoroutineScheduler wakes coroutines by time, then by the order they waited") = [] {
+		SchedulerState state;
+		state.evaluate("order = {}");
+		state.start("wait(40) order[#order + 1] = 'A'");
+		state.start("wait(10) order[#order + 1] = 'B'");
+		state.start("wait(10) order[#order + 1] = 'C' wait(0) order[#order + 1] = 'C again'");
+		expect(eq(state.scheduler.size(), 3U));
+
+		state.tick(20ms);
+		expect(eq(state.evaluate("return table.concat(order, ',')"), std::string("B,C")));
+		expect(eq(state.scheduler.size(), 2U));
+
+		// Waiting again during a tick is left to the next one
+		state.tick(30ms);
+		expect(eq(state.evaluate("return table.concat(order, ',')"), std::string("B,C,A,C again")));
+		expect(eq(state.scheduler.size(), 0U));
+	};
+
+	test("LuaCoroutineScheduler never resumes a stopped coroutine") = [] {
+		SchedulerState state;
+		const uint32_t id = state.start("wait(10) resumed = true");
+		expect(id != 0U);
+		expect(state.scheduler.stop(id));
+		expect(eq(state.scheduler.size(), 0U));
+		expect(!state.scheduler.stop(id));
+
+		state.tick(20ms);
+		expect(eq(state.evaluate("return tostring(resumed)"), std::string("nil")));
+	};
+
+	test("LuaCoroutineScheduler reports a failed coroutine and releases its reference") = [] {
+		SchedulerState state;
+		const uint32_t id = state.start("weak = setmetatable({}, { __mode = 'k' }) weak[coroutine.running()] = true wait(0) error('boom')");
+		expect(id != 0U);
+
+		state.tick(0ms);
+		expect(eq(state.scheduler.size(), 0U));
+		const auto &logs = dynamic_cast<InMemoryLogger &>(state.injector.create<Logger &>()).logs;
+		expect(std::ranges::any_of(logs, [](const auto &entry) { return entry.level == "error" && entry.message.find("boom") != std::string::npos; }));
+
+		// Only the registry reference kept the thread alive
+		expect(eq(state.evaluate("collectgarbage() collectgarbage() return tostring(next(weak) == nil)"), std::string("true")));
+	};
+
+	test("LuaCoroutineScheduler does not keep a coroutine that finished without waiting") = [] {
+		SchedulerState state;
+		expect(eq(state.start("finished = true"), 0U));
+		expect(eq(state.scheduler.size(), 0U));
+		expect(eq(state.evaluate("return tostring(finished)"), std::string("true")));
+	};
+};
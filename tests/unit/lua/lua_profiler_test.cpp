@@ -0,0 +1,47 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lua/lua_definitions.hpp"
+#include "lua/scripts/lua_profiler.hpp"
+
+using namespace boost::ut;
+using namespace std::chrono_literals;
+
+suite<"lua"> luaProfilerTest = [] {
+	test("LuaProfiler accounts calls per script, slowest first") = [] {
+		LuaProfiler profiler;
+		profiler.record(nullptr, EVENT_ID_USER, 5ms);
+		profiler.record(nullptr, EVENT_ID_USER, 2ms);
+		profiler.record(nullptr, EVENT_ID_LOADING, 20ms);
+
+		const auto scripts = profiler.getScripts(10);
+		expect(eq(scripts.size(), 2U) >> fatal);
+		expect(eq(scripts[0].name, std::string("loading")));
+		expect(eq(scripts[1].name, std::string("user")));
+		expect(eq(scripts[1].calls, 2U));
+		expect(scripts[1].total == 7ms);
+		expect(scripts[1].max == 5ms);
+
+		expect(eq(profiler.getScripts(1).size(), 1U));
+	};
+
+	test("LuaProfiler reset drops the accounted scripts") = [] {
+		LuaProfiler profiler;
+		profiler.record(nullptr, EVENT_ID_USER, 1ms);
+		profiler.reset();
+		expect(profiler.getScripts(10).empty());
+		expect(eq(profiler.getSamples(), 0U));
+
+		profiler.record(nullptr, EVENT_ID_USER, 1ms);
+		expect(eq(profiler.getScripts(10)[0].calls, 1U));
+	};
+};
@@ -15,6 +15,38 @@
 
 using namespace boost::ut;
 
+namespace {
+	// The default key set by RSA::start when key.pem is missing
+	constexpr const char* DEFAULT_P = "14299623962416399520070177382898895550795403345466153217470516082934737582776038882967213386204600674145392845853859217990626450972452084065728686565928113";
+	constexpr const char* DEFAULT_Q = "7630979195970404721891201847792002125535401292779123937207447574596692788513647179235335529307251350570728407373705564708871762033017096809910315212884101";
+
+	// Encrypts the 128 bytes block in place with the public key (e = 65537), as the client does
+	void publicEncrypt(char* block) {
+		mpz_t p, q, n, m;
+		mpz_inits(p, q, n, m, nullptr);
+		mpz_set_str(p, DEFAULT_P, 10);
+		mpz_set_str(q, DEFAULT_Q, 10);
+		mpz_mul(n, p, q);
+
+		mpz_import(m, 128, 1, 1, 0, 0, block);
+		mpz_powm_ui(m, m, 65537, n);
+
+		size_t count = (mpz_sizeinbase(m, 2) + 7) / 8;
+		memset(block, 0, 128 - count);
+		mpz_export(block + (128 - count), nullptr, 1, 1, 0, 0, m);
+		mpz_clears(p, q, n, m, nullptr);
+	}
+
+	std::array<char, 128> randomBlock(std::mt19937 &rng) {
+		std::array<char, 128> block {};
+		// The first byte is always zero in the protocol, which keeps the message below n
+		for (size_t i = 1; i < block.size(); ++i) {
+			block[i] = static_cast<char>(rng() & 0xFF);
+		}
+		return block;
+	}
+}
+
 suite<"security"> rsaTest = [] {
 	test("RSA::start logs error for missing .pem file") = [] {
 		di::extension::injector<> injector {};
@@ -29,4 +61,20 @@ suite<"security"> rsaTest = [] {
 			eq(std::string { "error" }, logger.logs[0].level) and eq(std::string { "File key.pem not found or have problem on loading... Setting standard rsa key\n" }, logger.logs[0].message)
 		);
 	};
+	test("RSA::decrypt recovers blocks encrypted with the public key") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		auto &rsa = DI::create<RSA &>();
+		rsa.setKey(DEFAULT_P, DEFAULT_Q);
+
+		std::mt19937 rng(0x5EED);
+		for (int32_t i = 0; i < 64; ++i) {
+			const auto plain = randomBlock(rng);
+			auto block = plain;
+			publicEncrypt(block.data());
+			rsa.decrypt(block.data());
+			expect(block == plain) << "block " << i;
+		}
+	};
 };
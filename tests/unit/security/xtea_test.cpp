@@ -0,0 +1,92 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// The block-by-block implementation the protocol used before the vector kernels
+	void referenceEncrypt(uint8_t* buffer, size_t length, const XTEA::Key &key) {
+		const uint32_t delta = 0x61C88647;
+		uint32_t precachedControlSum[32][2];
+		uint32_t sum = 0;
+		for (int32_t i = 0; i < 32; ++i) {
+			precachedControlSum[i][0] = (sum + key[sum & 3]);
+			sum -= delta;
+			precachedControlSum[i][1] = (sum + key[(sum >> 11) & 3]);
+		}
+		for (size_t readPos = 0; readPos < length; readPos += 8) {
+			std::array<uint32_t, 2> vData = {};
+			memcpy(vData.data(), buffer + readPos, 8);
+			for (int32_t i = 0; i < 32; ++i) {
+				vData[0] += ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][0];
+				vData[1] += ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][1];
+			}
+			memcpy(buffer + readPos, vData.data(), 8);
+		}
+	}
+
+	void referenceDecrypt(uint8_t* buffer, size_t length, const XTEA::Key &key) {
+		const uint32_t delta = 0x61C88647;
+		uint32_t precachedControlSum[32][2];
+		uint32_t sum = 0xC6EF3720;
+		for (int32_t i = 0; i < 32; ++i) {
+			precachedControlSum[i][0] = (sum + key[(sum >> 11) & 3]);
+			sum += delta;
+			precachedControlSum[i][1] = (sum + key[sum & 3]);
+		}
+		for (size_t readPos = 0; readPos < length; readPos += 8) {
+			std::array<uint32_t, 2> vData = {};
+			memcpy(vData.data(), buffer + readPos, 8);
+			for (int32_t i = 0; i < 32; ++i) {
+				vData[1] -= ((vData[0] << 4 ^ vData[0] >> 5) + vData[0]) ^ precachedControlSum[i][0];
+				vData[0] -= ((vData[1] << 4 ^ vData[1] >> 5) + vData[1]) ^ precachedControlSum[i][1];
+			}
+			memcpy(buffer + readPos, vData.data(), 8);
+		}
+	}
+
+	XTEA::Key randomKey(std::mt19937 &rng) {
+		return { static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()), static_cast<uint32_t>(rng()) };
+	}
+
+	std::vector<uint8_t> randomBytes(std::mt19937 &rng, size_t size) {
+		std::vector<uint8_t> bytes(size);
+		for (auto &byte : bytes) {
+			byte = static_cast<uint8_t>(rng());
+		}
+		return bytes;
+	}
+}
+
+suite<"security"> xteaTest = [] {
+	test("XTEA::encrypt matches the reference implementation for every kernel width") = [] {
+		std::mt19937 rng(0x5EED);
+		// Covers empty messages, scalar tails and every mix of 8 and 4 block chunks, at an unaligned offset
+		for (size_t length = 0; length <= 1024; length += 8) {
+			const XTEA::Key key = randomKey(rng);
+			const auto plain = randomBytes(rng, length + 1);
+
+			auto expected = plain;
+			auto actual = plain;
+			referenceEncrypt(expected.data() + 1, length, key);
+			XTEA::encrypt(actual.data() + 1, length, XTEA::expandEncryptKey(key));
+			expect(expected == actual) << "encrypt length" << length << "kernel" << XTEA::getKernelName();
+
+			referenceDecrypt(expected.data() + 1, length, key);
+			XTEA::decrypt(actual.data() + 1, length, XTEA::expandDecryptKey(key));
+			expect(expected == actual) << "decrypt length" << length << "kernel" << XTEA::getKernelName();
+			expect(plain == actual) << "round trip length" << length;
+		}
+	};
+};
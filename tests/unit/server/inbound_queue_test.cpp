@@ -0,0 +1,148 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "server/network/message/inboundmessage.hpp"
+#include "server/network/message/inboundqueue.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint8_t AUTO_WALK = 0x64;
+	constexpr uint8_t LOOK = 0x8C;
+	constexpr uint8_t SAY = 0x96;
+	constexpr uint8_t TURN_NORTH = 0x6F;
+	constexpr uint8_t TURN_EAST = 0x70;
+
+	const InboundQueue::Rules &getTestRules() {
+		static const InboundQueue::Rules rules = [] {
+			InboundQueue::Rules result {};
+			result[AUTO_WALK] = { 0, InboundQueue::Coalesce::ReplaceLast, 1, 1 };
+			result[LOOK] = { 0, InboundQueue::Coalesce::DropDuplicate, 2, 2 };
+			result[TURN_NORTH] = { TURN_NORTH, InboundQueue::Coalesce::ReplaceLast };
+			result[TURN_EAST] = { TURN_NORTH, InboundQueue::Coalesce::ReplaceLast };
+			return result;
+		}();
+		return rules;
+	}
+
+	InboundMessage_ptr makePacket(uint8_t opcode, uint8_t payload = 0) {
+		auto msg = InboundMessagePool::getInboundMessage();
+		msg->addByte(opcode);
+		msg->addByte(payload);
+		msg->setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+		return msg;
+	}
+
+	std::vector<uint8_t> getOpcodes(const std::vector<InboundMessage_ptr> &messages) {
+		std::vector<uint8_t> opcodes;
+		for (const auto &msg : messages) {
+			opcodes.push_back(InboundQueue::getOpcode(*msg));
+		}
+		return opcodes;
+	}
+}
+
+suite<"server"> inboundQueueTest = [] {
+	test("InboundQueue schedules a single flush until the packets are taken") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		InboundQueue queue(getTestRules(), 32);
+		expect(queue.push(makePacket(SAY), 0).scheduleFlush);
+		expect(!queue.push(makePacket(SAY), 0).scheduleFlush);
+
+		bool resumeReading = true;
+		expect(eq(queue.take(resumeReading).size(), 2U));
+		expect(!resumeReading);
+		expect(queue.push(makePacket(SAY), 0).scheduleFlush);
+	};
+
+	test("InboundQueue replaces the last packet of the same group") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		InboundQueue queue(getTestRules(), 32);
+		queue.push(makePacket(TURN_NORTH), 0);
+		expect(queue.push(makePacket(TURN_EAST), 0).outcome == InboundQueue::Outcome::Coalesced);
+		// Something in between keeps both turns
+		queue.push(makePacket(SAY), 0);
+		expect(queue.push(makePacket(TURN_NORTH), 0).outcome == InboundQueue::Outcome::Queued);
+
+		bool resumeReading = false;
+		expect(getOpcodes(queue.take(resumeReading)) == std::vector<uint8_t> { TURN_EAST, SAY, TURN_NORTH });
+		expect(eq(queue.getStats().coalesced, 1U));
+	};
+
+	test("InboundQueue drops a duplicate of the last packet only") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		InboundQueue queue(getTestRules(), 32);
+		queue.push(makePacket(LOOK, 1), 0);
+		expect(queue.push(makePacket(LOOK, 1), 1000).outcome == InboundQueue::Outcome::Coalesced);
+		expect(queue.push(makePacket(LOOK, 2), 2000).outcome == InboundQueue::Outcome::Queued);
+
+		bool resumeReading = false;
+		expect(eq(queue.take(resumeReading).size(), 2U));
+	};
+
+	test("InboundQueue rate limits an opcode with its token bucket") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		InboundQueue queue(getTestRules(), 32);
+		// Burst of 2, refilled at 2 per second; different payloads so nothing is coalesced
+		expect(queue.push(makePacket(LOOK, 1), 0).outcome == InboundQueue::Outcome::Queued);
+		expect(queue.push(makePacket(LOOK, 2), 0).outcome == InboundQueue::Outcome::Queued);
+		expect(queue.push(makePacket(LOOK, 3), 0).outcome == InboundQueue::Outcome::Dropped);
+		expect(queue.push(makePacket(LOOK, 4), 500).outcome == InboundQueue::Outcome::Queued);
+		// Unlimited opcodes are never dropped
+		for (int i = 0; i < 10; ++i) {
+			expect(queue.push(makePacket(SAY, i), 500).outcome == InboundQueue::Outcome::Queued);
+		}
+		expect(eq(queue.getStats().dropped, 1U));
+	};
+
+	test("InboundQueue replaces the last packet without spending a token") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		InboundQueue queue(getTestRules(), 32);
+		expect(queue.push(makePacket(AUTO_WALK, 1), 0).outcome == InboundQueue::Outcome::Queued);
+		// The bucket is empty, the newest path still wins over the queued one
+		expect(queue.push(makePacket(AUTO_WALK, 2), 0).outcome == InboundQueue::Outcome::Coalesced);
+
+		bool resumeReading = false;
+		const auto messages = queue.take(resumeReading);
+		expect(eq(messages.size(), 1U));
+		expect(eq(messages.front()->getBuffer()[messages.front()->getBufferPosition() + 1], uint8_t(2)));
+
+		// Nothing queued to replace, so it needs a token again
+		expect(queue.push(makePacket(AUTO_WALK, 3), 0).outcome == InboundQueue::Outcome::Dropped);
+	};
+
+	test("InboundQueue pauses reading when full") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		InboundQueue queue(getTestRules(), 2);
+		expect(!queue.push(makePacket(SAY), 0).pauseReading);
+		expect(queue.push(makePacket(SAY), 0).pauseReading);
+
+		bool resumeReading = false;
+		queue.take(resumeReading);
+		expect(resumeReading);
+		queue.take(resumeReading);
+		expect(!resumeReading);
+	};
+};
@@ -0,0 +1,72 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2024 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/logging/in_memory_logger.hpp"
+#include "server/network/message/inboundmessage.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// A say packet (0x96) as it is after the headers: opcode, speak class, text
+	void writeSayPacket(NetworkMessage &msg, const std::string &text) {
+		msg.addByte(0x96);
+		msg.addByte(0x01);
+		msg.addString(text, __FUNCTION__);
+		msg.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+	}
+}
+
+suite<"server"> networkMessageTest = [] {
+	test("NetworkMessage::getStringView reads the string in place") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		NetworkMessage msg;
+		writeSayPacket(msg, "hello world");
+
+		expect(eq(msg.getByte(), 0x96));
+		expect(eq(msg.getByte(), 0x01));
+		const auto text = msg.getStringView();
+		expect(eq(text, std::string_view { "hello world" }));
+		expect(text.data() == reinterpret_cast<const char*>(msg.getBuffer()) + NetworkMessage::INITIAL_BUFFER_POSITION + 4);
+		expect(!msg.isOverrun());
+	};
+
+	test("NetworkMessage::getStringView returns empty past the end") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		NetworkMessage msg;
+		msg.add<uint16_t>(200);
+		msg.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+
+		expect(msg.getStringView().empty());
+		expect(msg.isOverrun());
+	};
+
+	test("InboundMessagePool reuses released messages") = [] {
+		di::extension::injector<> injector {};
+		DI::setTestContainer(&InMemoryLogger::install(injector));
+
+		auto msg = InboundMessagePool::getInboundMessage();
+		const auto* buffer = msg->getBuffer();
+		writeSayPacket(*msg, "hello");
+		msg.reset();
+		expect(eq(inject<InboundMessagePool>().getFreeCount(), 1U));
+
+		const auto reused = InboundMessagePool::getInboundMessage();
+		expect(reused->getBuffer() == buffer);
+		expect(eq(reused->getLength(), 0));
+		expect(eq(reused->getBufferPosition(), NetworkMessage::INITIAL_BUFFER_POSITION));
+		expect(eq(inject<InboundMessagePool>().getFreeCount(), 0U));
+	};
+};